@@ -34,9 +34,6 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "ItkAutoThreshold.h"
 
-//histogram calculation
-#include "itkImageToHistogramFilter.h"
-
 //histogram based selectors
 #include "itkHistogramThresholdCalculator.h"
 #include "itkHuangThresholdCalculator.h"
@@ -52,8 +49,11 @@
 #include "itkTriangleThresholdCalculator.h"
 #include "itkYenThresholdCalculator.h"
 
-//thresholding filter
+#if ImageProcessing_BitDepth != 8
+//histogram calculation and thresholding of other pixel types
 #include "itkBinaryThresholdImageFilter.h"
+#include "itkImageToHistogramFilter.h"
+#endif
 
 #include "SIMPLib/Common/Constants.h"
 #include "SIMPLib/FilterParameters/BooleanFilterParameter.h"
@@ -67,6 +67,10 @@
 
 #include "SIMPLib/ITK/itkBridge.h"
 
+#include "ImageProcessing/ImageProcessingFilters/util/HistogramCache.h"
+#include "ImageProcessing/ImageProcessingFilters/util/LookupTableThreshold.hpp"
+#include "ImageProcessing/ImageProcessingFilters/util/SliceExecutor.hpp"
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -208,44 +212,28 @@ void ItkAutoThreshold::execute()
   if(getErrorCondition() < 0) { return; }
 
   DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getSelectedCellArrayPath().getDataContainerName());
-  QString attrMatName = getSelectedCellArrayPath().getAttributeMatrixName();
 
   //get dims
   size_t udims[3] = {0, 0, 0};
   std::tie(udims[0], udims[1], udims[2]) = m->getGeometryAs<ImageGeom>()->getDimensions();
 
-  int64_t dims[3] =
-  {
-    static_cast<int64_t>(udims[0]),
-    static_cast<int64_t>(udims[1]),
-    static_cast<int64_t>(udims[2]),
-  };
-
-  //wrap input as itk image
-  ImageProcessingConstants::DefaultImageType::Pointer inputImage = ITKUtilitiesType::CreateItkWrapperForDataPointer(m, attrMatName, m_SelectedCellArray);
-
-  //define threshold filters
-  typedef itk::BinaryThresholdImageFilter <ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::DefaultImageType> BinaryThresholdImageFilterType;
-  typedef itk::BinaryThresholdImageFilter <ImageProcessingConstants::DefaultSliceType, ImageProcessingConstants::DefaultSliceType> BinaryThresholdImageFilterType2D;
-
-  //define hitogram generator (will make the same kind of histogram for 2 and 3d images
-  typedef itk::Statistics::ImageToHistogramFilter<ImageProcessingConstants::DefaultImageType> HistogramGenerator;
-
   //find threshold value w/ histogram
-  itk::HistogramThresholdCalculator< HistogramGenerator::HistogramType, uint8_t >::Pointer calculator;
-
-  typedef itk::HuangThresholdCalculator< HistogramGenerator::HistogramType, uint8_t > HuangCalculatorType;
-  typedef itk::IntermodesThresholdCalculator< HistogramGenerator::HistogramType, uint8_t > IntermodesCalculatorType;
-  typedef itk::IsoDataThresholdCalculator< HistogramGenerator::HistogramType, uint8_t > IsoDataCalculatorType;
-  typedef itk::KittlerIllingworthThresholdCalculator< HistogramGenerator::HistogramType, uint8_t > KittlerIllingowrthCalculatorType;
-  typedef itk::LiThresholdCalculator< HistogramGenerator::HistogramType, uint8_t > LiCalculatorType;
-  typedef itk::MaximumEntropyThresholdCalculator< HistogramGenerator::HistogramType, uint8_t > MaximumEntropyCalculatorType;
-  typedef itk::MomentsThresholdCalculator< HistogramGenerator::HistogramType, uint8_t > MomentsCalculatorType;
-  typedef itk::OtsuThresholdCalculator< HistogramGenerator::HistogramType, uint8_t > OtsuCalculatorType;
-  typedef itk::RenyiEntropyThresholdCalculator< HistogramGenerator::HistogramType, uint8_t > RenyiEntropyCalculatorType;
-  typedef itk::ShanbhagThresholdCalculator< HistogramGenerator::HistogramType, uint8_t > ShanbhagCalculatorType;
-  typedef itk::TriangleThresholdCalculator< HistogramGenerator::HistogramType, uint8_t > TriangleCalculatorType;
-  typedef itk::YenThresholdCalculator< HistogramGenerator::HistogramType, uint8_t > YenCalculatorType;
+  typedef HistogramCache::ItkHistogramType HistogramType;
+  typedef itk::HistogramThresholdCalculator< HistogramType, uint8_t > CalculatorType;
+  CalculatorType::Pointer calculator;
+
+  typedef itk::HuangThresholdCalculator< HistogramType, uint8_t > HuangCalculatorType;
+  typedef itk::IntermodesThresholdCalculator< HistogramType, uint8_t > IntermodesCalculatorType;
+  typedef itk::IsoDataThresholdCalculator< HistogramType, uint8_t > IsoDataCalculatorType;
+  typedef itk::KittlerIllingworthThresholdCalculator< HistogramType, uint8_t > KittlerIllingowrthCalculatorType;
+  typedef itk::LiThresholdCalculator< HistogramType, uint8_t > LiCalculatorType;
+  typedef itk::MaximumEntropyThresholdCalculator< HistogramType, uint8_t > MaximumEntropyCalculatorType;
+  typedef itk::MomentsThresholdCalculator< HistogramType, uint8_t > MomentsCalculatorType;
+  typedef itk::OtsuThresholdCalculator< HistogramType, uint8_t > OtsuCalculatorType;
+  typedef itk::RenyiEntropyThresholdCalculator< HistogramType, uint8_t > RenyiEntropyCalculatorType;
+  typedef itk::ShanbhagThresholdCalculator< HistogramType, uint8_t > ShanbhagCalculatorType;
+  typedef itk::TriangleThresholdCalculator< HistogramType, uint8_t > TriangleCalculatorType;
+  typedef itk::YenThresholdCalculator< HistogramType, uint8_t > YenCalculatorType;
 
   switch(m_Method)
   {
@@ -322,6 +310,17 @@ void ItkAutoThreshold::execute()
     break;
   }
 
+#if ImageProcessing_BitDepth != 8
+  //the cached histograms and lookup tables work on 8 bit pixels, other pixel types go through the itk filters
+  QString attrMatName = getSelectedCellArrayPath().getAttributeMatrixName();
+
+  //wrap input as itk image
+  ImageProcessingConstants::DefaultImageType::Pointer inputImage = ITKUtilitiesType::CreateItkWrapperForDataPointer(m, attrMatName, m_SelectedCellArray);
+
+  //define threshold filters
+  typedef itk::BinaryThresholdImageFilter <ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::DefaultImageType> BinaryThresholdImageFilterType;
+  typedef itk::BinaryThresholdImageFilter <ImageProcessingConstants::DefaultSliceType, ImageProcessingConstants::DefaultSliceType> BinaryThresholdImageFilterType2D;
+
   if(m_Slice)
   {
     //define 2d histogram generator
@@ -345,7 +344,7 @@ void ItkAutoThreshold::execute()
     ImageProcessingConstants::DefaultImageType::Pointer outputImage = ITKUtilitiesType::CreateItkWrapperForDataPointer(m, attrMatName, m_NewCellArray);
 
     //loop over slices
-    for(int i = 0; i < dims[2]; i++)
+    for(size_t i = 0; i < udims[2]; i++)
     {
       //get slice
       ImageProcessingConstants::DefaultSliceType::Pointer slice = ITKUtilitiesType::ExtractSlice(inputImage, ImageProcessingConstants::ZSlice, i);
@@ -353,10 +352,9 @@ void ItkAutoThreshold::execute()
       //find histogram
       histogramFilter2D->SetInput( slice );
       histogramFilter2D->Update();
-      const HistogramGenerator::HistogramType* histogram = histogramFilter2D->GetOutput();
 
       //calculate threshold level
-      calculator->SetInput(histogram);
+      calculator->SetInput(histogramFilter2D->GetOutput());
       calculator->Update();
       const uint8_t thresholdValue = calculator->GetThreshold();
 
@@ -376,6 +374,7 @@ void ItkAutoThreshold::execute()
   else
   {
     //specify number of bins / bounds
+    typedef itk::Statistics::ImageToHistogramFilter<ImageProcessingConstants::DefaultImageType> HistogramGenerator;
     HistogramGenerator::Pointer histogramFilter = HistogramGenerator::New();
     typedef HistogramGenerator::HistogramSizeType SizeType;
     SizeType size( 1 );
@@ -392,10 +391,9 @@ void ItkAutoThreshold::execute()
     //find histogram
     histogramFilter->SetInput( inputImage );
     histogramFilter->Update();
-    const HistogramGenerator::HistogramType* histogram = histogramFilter->GetOutput();
 
     //calculate threshold level
-    calculator->SetInput(histogram);
+    calculator->SetInput(histogramFilter->GetOutput());
     calculator->Update();
     const uint8_t thresholdValue = calculator->GetThreshold();
 
@@ -409,6 +407,67 @@ void ItkAutoThreshold::execute()
     thresholdFilter->GetOutput()->GetPixelContainer()->SetImportPointer(m_NewCellArray, m_NewCellArrayPtr.lock()->getNumberOfTuples(), false);
     thresholdFilter->Update();
   }
+#else
+  //histograms of the volume and of every slice come from a single scan, reused when the previous filter was also an
+  //auto threshold of this array
+  std::shared_ptr<const ImageHistogram> histograms = HistogramCache::Instance()->getHistogram(this, m_SelectedCellArrayPtr.lock(), udims[0] * udims[1]);
+  const size_t planeSize = udims[0] * udims[1];
+
+  if(m_Slice)
+  {
+    //threshold slices in parallel, each with its own calculator
+    auto thresholdSlice = [&](size_t z, QString& errorMessage) -> int {
+      //the calculator selected above is copied so every slice has its own
+      CalculatorType::Pointer sliceCalculator = dynamic_cast<CalculatorType*>(calculator->CreateAnother().GetPointer());
+      uint8_t thresholdValue = 0;
+      try
+      {
+        //calculate threshold level on the 255 bins over [0, 256] the itk::Statistics::ImageToHistogramFilter used to build
+        HistogramType::Pointer histogram = HistogramCache::CreateItkHistogram(histograms->slice(z), 255, 0.0, 256.0);
+        sliceCalculator->SetInput(histogram);
+        sliceCalculator->Update();
+        thresholdValue = sliceCalculator->GetThreshold();
+      }
+      catch( itk::ExceptionObject& err )
+      {
+        errorMessage = QObject::tr("Failed to threshold slice %1. Error Message returned from ITK:\n   %2").arg(z).arg(err.GetDescription());
+        return -5;
+      }
+
+      //threshold
+      LookupTableThreshold<uint8_t> lookupTable;
+      lookupTable.setBinary(thresholdValue, 255, 255, 0);
+      lookupTable.apply(m_SelectedCellArray + z * planeSize, m_NewCellArray + z * planeSize, planeSize);
+      return 0;
+    };
+    SliceExecutor::Execute(this, udims[2], QObject::tr("Thresholding Slices"), thresholdSlice);
+    if(getErrorCondition() < 0 || getCancel()) { return; }
+  }
+  else
+  {
+    uint8_t thresholdValue = 0;
+    try
+    {
+      //calculate threshold level on the 255 bins over [0, 256] the itk::Statistics::ImageToHistogramFilter used to build
+      HistogramType::Pointer histogram = HistogramCache::CreateItkHistogram(histograms->volume.data(), 255, 0.0, 256.0);
+      calculator->SetInput(histogram);
+      calculator->Update();
+      thresholdValue = calculator->GetThreshold();
+    }
+    catch( itk::ExceptionObject& err )
+    {
+      setErrorCondition(-5);
+      QString ss = QObject::tr("Failed to calculate the threshold. Error Message returned from ITK:\n   %1").arg(err.GetDescription());
+      notifyErrorMessage(getHumanLabel(), ss, getErrorCondition());
+      return;
+    }
+
+    //threshold
+    LookupTableThreshold<uint8_t> lookupTable;
+    lookupTable.setBinary(thresholdValue, 255, 255, 0);
+    lookupTable.apply(m_SelectedCellArray, m_NewCellArray, planeSize * udims[2]);
+  }
+#endif
 
   //array name changing/cleanup
   if(!m_SaveAsNewArray)
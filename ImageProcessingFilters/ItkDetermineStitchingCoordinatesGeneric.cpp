@@ -11,6 +11,8 @@
 #include "SIMPLib/DataArrays/StringDataArray.h"
 #include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
 #include "SIMPLib/FilterParameters/AttributeMatrixSelectionFilterParameter.h"
+#include "SIMPLib/FilterParameters/BooleanFilterParameter.h"
+#include "SIMPLib/FilterParameters/ChoiceFilterParameter.h"
 #include "SIMPLib/FilterParameters/FloatFilterParameter.h"
 #include "SIMPLib/FilterParameters/IntFilterParameter.h"
 #include "SIMPLib/FilterParameters/LinkedBooleanFilterParameter.h"
@@ -28,11 +30,15 @@ ItkDetermineStitchingCoordinatesGeneric::ItkDetermineStitchingCoordinatesGeneric
   m_xTileDim(3),
   m_yTileDim(3),
   m_OverlapPer(50.0f),
+  m_PlacementMode(0),
+  m_CorrelationSearch(0),
+  m_SubPixelPeaks(false),
   m_UseZeissMetaData(false),
   m_MetaDataAttributeMatrixName("TileAttributeMatrix"),
   m_TileCalculatedInfoAttributeMatrixName("TileInfoAttrMat"),
   m_StitchedCoordinatesArrayName("StitchedCoordinates"),
-  m_StitchedArrayNames("StitchedArrayNames")
+  m_StitchedArrayNames("StitchedArrayNames"),
+  m_PeakToSidelobeRatiosArrayName("PeakToSidelobeRatios")
 {
 }
 
@@ -79,6 +85,39 @@ void ItkDetermineStitchingCoordinatesGeneric::setupFilterParameters()
   parameters.push_back(SIMPL_NEW_INTEGER_FP("Tile Dimensions Y", yTileDim, FilterParameter::RequiredArray, ItkDetermineStitchingCoordinatesGeneric));
   parameters.push_back(SIMPL_NEW_FLOAT_FP("Overlap Percentage (Estimate):", OverlapPer, FilterParameter::RequiredArray, ItkDetermineStitchingCoordinatesGeneric));
 
+  {
+    ChoiceFilterParameter::Pointer parameter = ChoiceFilterParameter::New();
+    parameter->setHumanLabel("Tile Placement");
+    parameter->setPropertyName("PlacementMode");
+    parameter->setSetterCallback(SIMPL_BIND_SETTER(ItkDetermineStitchingCoordinatesGeneric, this, PlacementMode));
+    parameter->setGetterCallback(SIMPL_BIND_GETTER(ItkDetermineStitchingCoordinatesGeneric, this, PlacementMode));
+
+    QVector<QString> choices;
+    choices.push_back("Chained Average");
+    choices.push_back("Global Least Squares");
+    parameter->setChoices(choices);
+    parameter->setCategory(FilterParameter::Parameter);
+    parameters.push_back(parameter);
+  }
+
+  {
+    ChoiceFilterParameter::Pointer parameter = ChoiceFilterParameter::New();
+    parameter->setHumanLabel("Correlation Search");
+    parameter->setPropertyName("CorrelationSearch");
+    parameter->setSetterCallback(SIMPL_BIND_SETTER(ItkDetermineStitchingCoordinatesGeneric, this, CorrelationSearch));
+    parameter->setGetterCallback(SIMPL_BIND_GETTER(ItkDetermineStitchingCoordinatesGeneric, this, CorrelationSearch));
+
+    QVector<QString> choices;
+    choices.push_back("Full Resolution");
+    choices.push_back("Coarse To Fine (4x)");
+    choices.push_back("Coarse To Fine (8x)");
+    parameter->setChoices(choices);
+    parameter->setCategory(FilterParameter::Parameter);
+    parameters.push_back(parameter);
+  }
+
+  parameters.push_back(SIMPL_NEW_BOOL_FP("Sub-Pixel Peaks", SubPixelPeaks, FilterParameter::Parameter, ItkDetermineStitchingCoordinatesGeneric));
+
   parameters.push_back(SeparatorFilterParameter::New("Cell Data", FilterParameter::RequiredArray));
 
   {
@@ -96,6 +135,7 @@ void ItkDetermineStitchingCoordinatesGeneric::setupFilterParameters()
   parameters.push_back(SIMPL_NEW_STRING_FP("Stitched Attribute Matrix", TileCalculatedInfoAttributeMatrixName, FilterParameter::CreatedArray, ItkDetermineStitchingCoordinatesGeneric));
   parameters.push_back(SIMPL_NEW_STRING_FP("Stitched Coordinates", StitchedCoordinatesArrayName, FilterParameter::CreatedArray, ItkDetermineStitchingCoordinatesGeneric));
   parameters.push_back(SIMPL_NEW_STRING_FP("Stitched Coordinates Names", StitchedArrayNames, FilterParameter::CreatedArray, ItkDetermineStitchingCoordinatesGeneric));
+  parameters.push_back(SIMPL_NEW_STRING_FP("Peak To Sidelobe Ratios", PeakToSidelobeRatiosArrayName, FilterParameter::CreatedArray, ItkDetermineStitchingCoordinatesGeneric));
 
   setFilterParameters(parameters);
 }
@@ -110,6 +150,9 @@ void ItkDetermineStitchingCoordinatesGeneric::readFilterParameters(AbstractFilte
   setxTileDim(reader->readValue("xTileDim", getxTileDim()));
   setyTileDim(reader->readValue("yTileDim", getyTileDim()));
   setOverlapPer(reader->readValue("OverlapPer", getOverlapPer()));
+  setPlacementMode(reader->readValue("PlacementMode", getPlacementMode()));
+  setCorrelationSearch(reader->readValue("CorrelationSearch", getCorrelationSearch()));
+  setSubPixelPeaks(reader->readValue("SubPixelPeaks", getSubPixelPeaks()));
   setAttributeMatrixName(reader->readDataArrayPath("AttributeMatrixName", getAttributeMatrixName()));
   setUseZeissMetaData(reader->readValue("UseZeissMetaData", getUseZeissMetaData()));
   setMetaDataAttributeMatrixName(reader->readDataArrayPath("MetaDataAttributeMatrixName", getMetaDataAttributeMatrixName()));
@@ -117,6 +160,7 @@ void ItkDetermineStitchingCoordinatesGeneric::readFilterParameters(AbstractFilte
   setTileCalculatedInfoAttributeMatrixName(reader->readString("TileCalculatedInfoAttributeMatrixName", getTileCalculatedInfoAttributeMatrixName()));
   setStitchedCoordinatesArrayName(reader->readString("StitchedCoordinatesArrayName", getStitchedCoordinatesArrayName()));
   setStitchedArrayNames(reader->readString("DataArrayNamesForStitchedCoordinates", getStitchedArrayNames()));
+  setPeakToSidelobeRatiosArrayName(reader->readString("PeakToSidelobeRatiosArrayName", getPeakToSidelobeRatiosArrayName()));
 
   reader->closeFilterGroup();
 }
@@ -209,6 +253,12 @@ void ItkDetermineStitchingCoordinatesGeneric::dataCheck()
   if(nullptr != m_StitchedCoordinatesPtr.lock())                              /* Validate the Weak Pointer wraps a non-nullptr pointer to a DataArray<T> object */
   { m_StitchedCoordinates = m_StitchedCoordinatesPtr.lock()->getPointer(0); } /* Now assign the raw pointer to data from the DataArray<T> object */
 
+  // One peak to sidelobe ratio for the match with the left neighbour and one for the match with the top neighbour
+  tempPath.update(getAttributeMatrixName().getDataContainerName(), getTileCalculatedInfoAttributeMatrixName(), getPeakToSidelobeRatiosArrayName());
+  m_PeakToSidelobeRatiosPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<float>, AbstractFilter, float>(this, tempPath, 0, dims);
+  if(nullptr != m_PeakToSidelobeRatiosPtr.lock())
+  { m_PeakToSidelobeRatios = m_PeakToSidelobeRatiosPtr.lock()->getPointer(0); }
+
   dims[0] = 1;
 
 
@@ -257,14 +307,7 @@ void ItkDetermineStitchingCoordinatesGeneric::execute()
   AttributeMatrix::Pointer attrMat = m->getAttributeMatrix(attrMatName);;
   FloatArrayType::Pointer temp;
 
-  // Set up the origins and resolutions (some of this data is used in legacy, some of it's used in non-legacy, some of it's used in both; for now we're including it up here; consider moving it where it's cleanest)
-  float sampleOrigin[3];
-  float voxelResolution[3];
-
-  m->getGeometryAs<ImageGeom>()->getOrigin(sampleOrigin);
-  m->getGeometryAs<ImageGeom>()->getResolution(voxelResolution);
   QVector<size_t> udims = attrMat->getTupleDimensions(); // The udims variable is filled with information about the size of each image (provided they were imported correctly) [0] = x; [1] = y; [2] = z;
-  size_t totalPoints = attrMat->getNumberOfTuples();
 
   // If mode is equal to the max value then we're using the legacy zeiss data (which we can't really use too well)
   // This code doesn't really work and I don't know how to fix it because I'm not using zeiss data. For now we'll just do this
@@ -307,18 +350,18 @@ void ItkDetermineStitchingCoordinatesGeneric::execute()
 
     // Use the helper class to do the actual stitching of the images. There are a lot
     // of parameters so make sure we understand all of them
-    temp = DetermineStitching::FindGlobalOriginsLegacy(totalPoints, udims,
-      sampleOrigin, voxelResolution,
+    temp = DetermineStitching::FindGlobalOriginsLegacy(udims,
       m_PointerList,
       xGlobCoordsList, yGlobCoordsList,
       xTileList, yTileList,
-      this);
+      this, m_PlacementMode, m_CorrelationSearch, m_SubPixelPeaks, m_PeakToSidelobeRatiosPtr.lock());
 
   }
   else
   {
     // Otherwise, we're not using the zeiss data method so call this and let everything work itself out
-    temp = DetermineStitching::FindGlobalOrigins(m_xTileDim, m_yTileDim, m_ImportMode, m_OverlapPer, m_PointerList, udims, sampleOrigin, voxelResolution);
+    temp = DetermineStitching::FindGlobalOrigins(m_xTileDim, m_yTileDim, m_ImportMode, m_OverlapPer, m_PointerList, udims, m_PlacementMode, m_CorrelationSearch, m_SubPixelPeaks,
+                                                 m_PeakToSidelobeRatiosPtr.lock());
   }
 
 #if 1
@@ -28,11 +28,15 @@ class ImageProcessing_EXPORT ItkDetermineStitchingCoordinatesGeneric : public Ab
   PYB11_PROPERTY(int xTileDim READ getxTileDim WRITE setxTileDim)
   PYB11_PROPERTY(int yTileDim READ getyTileDim WRITE setyTileDim)
   PYB11_PROPERTY(float OverlapPer READ getOverlapPer WRITE setOverlapPer)
+  PYB11_PROPERTY(int PlacementMode READ getPlacementMode WRITE setPlacementMode)
+  PYB11_PROPERTY(int CorrelationSearch READ getCorrelationSearch WRITE setCorrelationSearch)
+  PYB11_PROPERTY(bool SubPixelPeaks READ getSubPixelPeaks WRITE setSubPixelPeaks)
   PYB11_PROPERTY(bool UseZeissMetaData READ getUseZeissMetaData WRITE setUseZeissMetaData)
   PYB11_PROPERTY(DataArrayPath MetaDataAttributeMatrixName READ getMetaDataAttributeMatrixName WRITE setMetaDataAttributeMatrixName)
   PYB11_PROPERTY(QString TileCalculatedInfoAttributeMatrixName READ getTileCalculatedInfoAttributeMatrixName WRITE setTileCalculatedInfoAttributeMatrixName)
   PYB11_PROPERTY(QString StitchedCoordinatesArrayName READ getStitchedCoordinatesArrayName WRITE setStitchedCoordinatesArrayName)
   PYB11_PROPERTY(QString StitchedArrayNames READ getStitchedArrayNames WRITE setStitchedArrayNames)
+  PYB11_PROPERTY(QString PeakToSidelobeRatiosArrayName READ getPeakToSidelobeRatiosArrayName WRITE setPeakToSidelobeRatiosArrayName)
 
 public:
   SIMPL_SHARED_POINTERS(ItkDetermineStitchingCoordinatesGeneric)
@@ -67,6 +71,15 @@ public:
   SIMPL_FILTER_PARAMETER(float, OverlapPer)
   Q_PROPERTY(float OverlapPer READ getOverlapPer WRITE setOverlapPer)
 
+  SIMPL_FILTER_PARAMETER(int, PlacementMode)
+  Q_PROPERTY(int PlacementMode READ getPlacementMode WRITE setPlacementMode)
+
+  SIMPL_FILTER_PARAMETER(int, CorrelationSearch)
+  Q_PROPERTY(int CorrelationSearch READ getCorrelationSearch WRITE setCorrelationSearch)
+
+  SIMPL_FILTER_PARAMETER(bool, SubPixelPeaks)
+  Q_PROPERTY(bool SubPixelPeaks READ getSubPixelPeaks WRITE setSubPixelPeaks)
+
   SIMPL_FILTER_PARAMETER(bool, UseZeissMetaData)
   Q_PROPERTY(bool UseZeissMetaData READ getUseZeissMetaData WRITE setUseZeissMetaData)
 
@@ -82,6 +95,9 @@ public:
   SIMPL_FILTER_PARAMETER(QString, StitchedArrayNames)
   Q_PROPERTY(QString StitchedArrayNames READ getStitchedArrayNames WRITE setStitchedArrayNames)
 
+  SIMPL_FILTER_PARAMETER(QString, PeakToSidelobeRatiosArrayName)
+  Q_PROPERTY(QString PeakToSidelobeRatiosArrayName READ getPeakToSidelobeRatiosArrayName WRITE setPeakToSidelobeRatiosArrayName)
+
   /**
    * @brief getCompiledLibraryName Returns the name of the Library that this filter is a part of
    * @return
@@ -191,6 +207,7 @@ private:
   QVector<ImageProcessingConstants::DefaultPixelType*> m_PointerList;
   DEFINE_DATAARRAY_VARIABLE(ImageProcessingConstants::DefaultPixelType, SelectedCellArray)
   DEFINE_DATAARRAY_VARIABLE(float, StitchedCoordinates)
+  DEFINE_DATAARRAY_VARIABLE(float, PeakToSidelobeRatios)
   StringDataArray::WeakPointer m_DataArrayNamesForStitchedCoordinatesPtr;
   //DEFINE_DATAARRAY_VARIABLE(StringDataArray::WeakPointer, DataArrayNamesForStichedCoordinates);
   //DEFINE_DATAARRAY_VARIABLE(QString, DataArrayNamesForStitchedCoordinates);
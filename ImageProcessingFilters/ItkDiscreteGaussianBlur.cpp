@@ -39,6 +39,7 @@
 
 #include <QtCore/QString>
 
+#include "SIMPLib/FilterParameters/BooleanFilterParameter.h"
 #include "SIMPLib/FilterParameters/DataArraySelectionFilterParameter.h"
 #include "SIMPLib/FilterParameters/StringFilterParameter.h"
 #include "SIMPLib/FilterParameters/FloatFilterParameter.h"
@@ -49,6 +50,8 @@
 
 #include "SIMPLib/ITK/itkBridge.h"
 
+#include "ImageProcessing/ImageProcessingFilters/util/FusedGaussianBlur.h"
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -57,6 +60,7 @@ ItkDiscreteGaussianBlur::ItkDiscreteGaussianBlur()
 , m_NewCellArrayName("")
 , m_SaveAsNewArray(true)
 , m_Stdev(2.0)
+, m_FusedRescale(false)
 , m_SelectedCellArray(nullptr)
 , m_NewCellArray(nullptr)
 {
@@ -86,6 +90,7 @@ void ItkDiscreteGaussianBlur::setupFilterParameters()
   parameters.push_back(SIMPL_NEW_STRING_FP("Blurred Array", NewCellArrayName, FilterParameter::CreatedArray, ItkDiscreteGaussianBlur));
 
   parameters.push_back(SIMPL_NEW_FLOAT_FP("Standard Deviation", Stdev, FilterParameter::Parameter, ItkDiscreteGaussianBlur));
+  parameters.push_back(SIMPL_NEW_BOOL_FP("Fused Blur and Rescale (Low Memory)", FusedRescale, FilterParameter::Parameter, ItkDiscreteGaussianBlur));
 
   setFilterParameters(parameters);
 }
@@ -100,6 +105,7 @@ void ItkDiscreteGaussianBlur::readFilterParameters(AbstractFilterParametersReade
   setNewCellArrayName( reader->readString( "NewCellArrayName", getNewCellArrayName() ) );
   setSaveAsNewArray( reader->readValue( "SaveAsNewArray", getSaveAsNewArray() ) );
   setStdev( reader->readValue( "Stdev", getStdev() ) );
+  setFusedRescale( reader->readValue( "FusedRescale", getFusedRescale() ) );
   reader->closeFilterGroup();
 }
 
@@ -138,6 +144,13 @@ void ItkDiscreteGaussianBlur::dataCheck()
   if(nullptr != m_NewCellArrayPtr.lock())                       /* Validate the Weak Pointer wraps a non-nullptr pointer to a DataArray<T> object */
   { m_NewCellArray = m_NewCellArrayPtr.lock()->getPointer(0); } /* Now assign the raw pointer to data from the DataArray<T> object */
 
+#if ImageProcessing_BitDepth != 8
+  if(m_FusedRescale)
+  {
+    setWarningCondition(-100);
+    notifyWarningMessage(getHumanLabel(), "Fused blur and rescale needs 8 bit pixels, the ITK pipeline is used instead", getWarningCondition());
+  }
+#endif
 }
 
 // -----------------------------------------------------------------------------
@@ -166,29 +179,56 @@ void ItkDiscreteGaussianBlur::execute()
   DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getSelectedCellArrayPath().getDataContainerName());
   QString attrMatName = getSelectedCellArrayPath().getAttributeMatrixName();
 
-  //wrap m_RawImageData as itk::image
-  ImageProcessingConstants::DefaultImageType::Pointer inputImage = ITKUtilitiesType::CreateItkWrapperForDataPointer(m, attrMatName, m_SelectedCellArray);
-
-  //create Gaussian blur filter
-  typedef itk::DiscreteGaussianImageFilter< ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::FloatImageType > GaussianFilterType;
-  GaussianFilterType::Pointer gaussianFilter = GaussianFilterType::New();
-  gaussianFilter->SetInput(inputImage);
-  gaussianFilter->SetVariance(m_Stdev * m_Stdev);
-
-  //convert result back to uint8
-  typedef itk::RescaleIntensityImageFilter<ImageProcessingConstants::FloatImageType, ImageProcessingConstants::DefaultImageType> RescaleImageType;
-  RescaleImageType::Pointer rescaleFilter = RescaleImageType::New();
-  rescaleFilter->SetInput(gaussianFilter->GetOutput());
-  rescaleFilter->SetOutputMinimum(0);
-  rescaleFilter->SetOutputMaximum(255);
-
-
-  //have filter write to dream3d array instead of creating its own buffer
-  ITKUtilitiesType::SetITKFilterOutput(rescaleFilter->GetOutput(), m_NewCellArrayPtr.lock());
-
-  //execute filters
-  gaussianFilter->Update();
-  rescaleFilter->Update();
+#if ImageProcessing_BitDepth == 8
+  if(m_FusedRescale)
+  {
+    //blur and rescale slice by slice without whole volume float images
+    ImageGeom::Pointer image = m->getGeometryAs<ImageGeom>();
+    size_t udims[3] = {0, 0, 0};
+    float res[3] = {0.0f, 0.0f, 0.0f};
+    std::tie(udims[0], udims[1], udims[2]) = image->getDimensions();
+    image->getResolution(res);
+
+    FusedGaussianBlur::Pointer blur = FusedGaussianBlur::New();
+    int err = blur->setKernels(m_Stdev * m_Stdev, res);
+    if(err >= 0)
+    {
+      notifyStatusMessage(getHumanLabel(), "Blurring");
+      err = blur->execute(m_SelectedCellArray, m_NewCellArray, udims);
+    }
+    if(err < 0)
+    {
+      setErrorCondition(err);
+      notifyErrorMessage(getHumanLabel(), blur->getErrorMessage(), getErrorCondition());
+      return;
+    }
+  }
+  else
+#endif
+  {
+    //wrap m_RawImageData as itk::image
+    ImageProcessingConstants::DefaultImageType::Pointer inputImage = ITKUtilitiesType::CreateItkWrapperForDataPointer(m, attrMatName, m_SelectedCellArray);
+
+    //create Gaussian blur filter
+    typedef itk::DiscreteGaussianImageFilter< ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::FloatImageType > GaussianFilterType;
+    GaussianFilterType::Pointer gaussianFilter = GaussianFilterType::New();
+    gaussianFilter->SetInput(inputImage);
+    gaussianFilter->SetVariance(m_Stdev * m_Stdev);
+
+    //convert result back to uint8
+    typedef itk::RescaleIntensityImageFilter<ImageProcessingConstants::FloatImageType, ImageProcessingConstants::DefaultImageType> RescaleImageType;
+    RescaleImageType::Pointer rescaleFilter = RescaleImageType::New();
+    rescaleFilter->SetInput(gaussianFilter->GetOutput());
+    rescaleFilter->SetOutputMinimum(0);
+    rescaleFilter->SetOutputMaximum(255);
+
+    //have filter write to dream3d array instead of creating its own buffer
+    ITKUtilitiesType::SetITKFilterOutput(rescaleFilter->GetOutput(), m_NewCellArrayPtr.lock());
+
+    //execute filters
+    gaussianFilter->Update();
+    rescaleFilter->Update();
+  }
 
   //array name changing/cleanup
   if(!m_SaveAsNewArray)
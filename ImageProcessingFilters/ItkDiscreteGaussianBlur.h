@@ -57,6 +57,7 @@ class ImageProcessing_EXPORT ItkDiscreteGaussianBlur : public AbstractFilter
     PYB11_PROPERTY(QString NewCellArrayName READ getNewCellArrayName WRITE setNewCellArrayName)
     PYB11_PROPERTY(bool SaveAsNewArray READ getSaveAsNewArray WRITE setSaveAsNewArray)
     PYB11_PROPERTY(float Stdev READ getStdev WRITE setStdev)
+    PYB11_PROPERTY(bool FusedRescale READ getFusedRescale WRITE setFusedRescale)
 
   public:
     SIMPL_SHARED_POINTERS(ItkDiscreteGaussianBlur)
@@ -76,6 +77,9 @@ class ImageProcessing_EXPORT ItkDiscreteGaussianBlur : public AbstractFilter
     SIMPL_FILTER_PARAMETER(float, Stdev)
     Q_PROPERTY(float Stdev READ getStdev WRITE setStdev)
 
+    SIMPL_FILTER_PARAMETER(bool, FusedRescale)
+    Q_PROPERTY(bool FusedRescale READ getFusedRescale WRITE setFusedRescale)
+
     /**
      * @brief getCompiledLibraryName Returns the name of the Library that this filter is a part of
      * @return
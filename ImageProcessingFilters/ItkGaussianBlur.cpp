@@ -34,7 +34,7 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "ItkGaussianBlur.h"
 
-#include "itkGaussianBlurImageFunction.h"
+#include "itkDiscreteGaussianImageFilter.h"
 
 #include <QtCore/QString>
 
@@ -165,35 +165,34 @@ void ItkGaussianBlur::execute()
   DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getSelectedCellArrayPath().getDataContainerName());
   QString attrMatName = getSelectedCellArrayPath().getAttributeMatrixName();
 
-  //get filter to convert m_RawImageData to itk::image
-  ImageProcessingConstants::ImportUInt8FilterType::Pointer importFilter = ITKUtilitiesType::Dream3DtoITKImportFilter<ImageProcessingConstants::DefaultPixelType>(m, attrMatName, m_SelectedCellArray);
+  //wrap m_RawImageData as itk::image
+  ImageProcessingConstants::DefaultImageType::Pointer inputImage = ITKUtilitiesType::CreateItkWrapperForDataPointer(m, attrMatName, m_SelectedCellArray);
 
-  //get image from filter
-  const ImageProcessingConstants::UInt8ImageType* inputImage = importFilter->GetOutput();
-  ImageProcessingConstants::UInt8ImageType::RegionType filterRegion = inputImage->GetBufferedRegion();
-  ImageProcessingConstants::UInt8ConstIteratorType it(inputImage, filterRegion);
-
-  //create guassian blur filter
-  typedef itk::GaussianBlurImageFunction< ImageProcessingConstants::UInt8ImageType > GFunctionType;
-  GFunctionType::Pointer gaussianFunction = GFunctionType::New();
-  gaussianFunction->SetInputImage( inputImage );
+  //create guassian blur filter, the separable kernel is the one itk::GaussianBlurImageFunction built for every voxel
+  typedef itk::DiscreteGaussianImageFilter< ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::DefaultImageType > GaussianFilterType;
+  GaussianFilterType::Pointer gaussianFilter = GaussianFilterType::New();
+  gaussianFilter->SetInput(inputImage);
 
   //set guassian blur parameters
-  GFunctionType::ErrorArrayType setError;
-  setError.Fill( 0.01 );
-  gaussianFunction->SetMaximumError( setError );
-  gaussianFunction->SetSigma( 4 );
-  gaussianFunction->SetMaximumKernelWidth( 5 );
+  gaussianFilter->SetVariance(4.0 * 4.0);
+  gaussianFilter->SetMaximumError(0.01);
+  gaussianFilter->SetMaximumKernelWidth(5);
+
+  //have filter write to dream3d array instead of creating its own buffer
+  ITKUtilitiesType::SetITKFilterOutput(gaussianFilter->GetOutput(), m_NewCellArrayPtr.lock());
 
-  //loop over image running filter
+  //execute filter
   notifyStatusMessage(getHumanLabel(), "Blurring");
-  it.GoToBegin();
-  int index = 0;
-  while( !it.IsAtEnd() )
+  try
+  {
+    gaussianFilter->Update();
+  }
+  catch( itk::ExceptionObject& err )
   {
-    m_NewCellArray[index] = (gaussianFunction->EvaluateAtIndex(it.GetIndex() ));
-    ++it;
-    ++index;
+    setErrorCondition(-5);
+    QString ss = QObject::tr("Failed to execute itk::DiscreteGaussianImageFilter filter. Error Message returned from ITK:\n   %1").arg(err.GetDescription());
+    notifyErrorMessage(getHumanLabel(), ss, getErrorCondition());
+    return;
   }
 
   //array name changing/cleanup
@@ -49,6 +49,9 @@
 
 #include "SIMPLib/ITK/itkBridge.h"
 
+#include "ImageProcessing/ImageProcessingFilters/util/ItkSliceView.hpp"
+#include "ImageProcessing/ImageProcessingFilters/util/SliceExecutor.hpp"
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -175,68 +178,51 @@ void ItkHoughCircles::execute()
   size_t udims[3] = {0, 0, 0};
   std::tie(udims[0], udims[1], udims[2]) = m->getGeometryAs<ImageGeom>()->getDimensions();
 
-  int64_t dims[3] =
-  {
-    static_cast<int64_t>(udims[0]),
-    static_cast<int64_t>(udims[1]),
-    static_cast<int64_t>(udims[2]),
-  };
-
-  size_t totalPoints = m_SelectedCellArrayPtr.lock()->getNumberOfTuples();
-  for(int i = 0; i < totalPoints; ++i)
-  {
-    m_NewCellArray[i] = m_SelectedCellArray[i];
-  }
-
   //wrap raw and processed image data as itk::images
   ImageProcessingConstants::DefaultImageType::Pointer inputImage = ITKUtilitiesType::CreateItkWrapperForDataPointer(m, attrMatName, m_SelectedCellArray);
   ImageProcessingConstants::DefaultImageType::Pointer outputImage = ITKUtilitiesType::CreateItkWrapperForDataPointer(m, attrMatName, m_NewCellArray);
 
-  ImageProcessingConstants::DefaultSliceType::IndexType localIndex;
 #if ITK_VERSION_MAJOR < 5
   typedef itk::HoughTransform2DCirclesImageFilter<ImageProcessingConstants::DefaultPixelType, ImageProcessingConstants::FloatPixelType> HoughTransformFilterType;
 #else
   using HoughTransformFilterType = itk::HoughTransform2DCirclesImageFilter<ImageProcessingConstants::DefaultPixelType, ImageProcessingConstants::FloatPixelType, ImageProcessingConstants::FloatPixelType>;
 #endif
-  HoughTransformFilterType::Pointer houghFilter = HoughTransformFilterType::New();
-  houghFilter->SetNumberOfCircles( m_NumberCircles );
-  houghFilter->SetMinimumRadius( m_MinRadius );
-  houghFilter->SetMaximumRadius( m_MaxRadius );
-  /*optional parameters, these are the default values
-  houghFilter->SetSweepAngle( 0 );
-  houghFilter->SetSigmaGradient( 1 );
-  houghFilter->SetVariance( 5 );
-  houghFilter->SetDiscRadiusRatio( 10 );
-  */
-
-  //loop over slices
-  for(int i = 0; i < dims[2]; ++i)
-  {
-    //extract slice and transform
-    QString ss = QObject::tr("Hough Transforming Slice: %1").arg(i + 1);
-    notifyStatusMessage(getMessagePrefix(), getHumanLabel(), ss);
-    ImageProcessingConstants::DefaultSliceType::Pointer inputSlice = ITKUtilitiesType::ExtractSlice(inputImage, ImageProcessingConstants::ZSlice, i);
+
+  //transform slices in parallel, each with its own hough filter
+  auto houghSlice = [&](size_t z, QString& errorMessage) -> int {
+    //view slice and transform
+    ImageProcessingConstants::DefaultSliceType::Pointer inputSlice = DefaultSliceView::WrapSlice(inputImage, z);
+    HoughTransformFilterType::Pointer houghFilter = HoughTransformFilterType::New();
+    SliceExecutor::SetSingleThreaded(houghFilter.GetPointer());
+    houghFilter->SetNumberOfCircles( m_NumberCircles );
+    houghFilter->SetMinimumRadius( m_MinRadius );
+    houghFilter->SetMaximumRadius( m_MaxRadius );
+    /*optional parameters, these are the default values
+    houghFilter->SetSweepAngle( 0 );
+    houghFilter->SetSigmaGradient( 1 );
+    houghFilter->SetVariance( 5 );
+    houghFilter->SetDiscRadiusRatio( 10 );
+    */
     houghFilter->SetInput( inputSlice );
-    houghFilter->Update();
-    ImageProcessingConstants::FloatSliceType::Pointer localAccumulator = houghFilter->GetOutput();
+    try
+    {
+      houghFilter->Update();
+    }
+    catch( itk::ExceptionObject& err )
+    {
+      errorMessage = QObject::tr("Failed to execute itk::HoughTransform2DCirclesImageFilter filter. Error Message returned from ITK:\n   %1").arg(err.GetDescription());
+      return -5;
+    }
 
     //find circles
-    ss = QObject::tr("Finding Circles on Slice: %1").arg(i + 1);
-    notifyStatusMessage(getMessagePrefix(), getHumanLabel(), ss);
     HoughTransformFilterType::CirclesListType circles = houghFilter->GetCircles();
 
-    //create blank slice of same dimensions
-    ImageProcessingConstants::DefaultSliceType::Pointer outputSlice = ImageProcessingConstants::DefaultSliceType::New();
-    ImageProcessingConstants::DefaultSliceType::RegionType region;
-    region.SetSize(inputSlice->GetLargestPossibleRegion().GetSize());
-    region.SetIndex(inputSlice->GetLargestPossibleRegion().GetIndex());
-    outputSlice->SetRegions( region );
-    outputSlice->SetOrigin(inputSlice->GetOrigin());
-    outputSlice->SetSpacing(inputSlice->GetSpacing());
-    outputSlice->Allocate();
+    //clear the output slice, drawing on the view draws into the volume
+    ImageProcessingConstants::DefaultSliceType::Pointer outputSlice = DefaultSliceView::WrapSlice(outputImage, z);
     outputSlice->FillBuffer(0);
 
     //loop over circles drawing on slice
+    ImageProcessingConstants::DefaultSliceType::IndexType localIndex;
     HoughTransformFilterType::CirclesListType::const_iterator itCircles = circles.begin();
     while( itCircles != circles.end() )
     {
@@ -258,10 +244,10 @@ void ItkHoughCircles::execute()
       }
       itCircles++;
     }
-
-    //copy slice into output
-    ITKUtilitiesType::SetSlice(outputImage, outputSlice, ImageProcessingConstants::ZSlice, i);
-  }
+    return 0;
+  };
+  SliceExecutor::Execute(this, udims[2], QObject::tr("Finding Circles on Slices"), houghSlice);
+  if(getErrorCondition() < 0 || getCancel()) { return; }
 
   //array name changing/cleanup
   if(!m_SaveAsNewArray)
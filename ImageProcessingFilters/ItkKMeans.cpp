@@ -37,6 +37,7 @@
 #include "itkScalarImageKmeansImageFilter.h"
 #include "itkMinimumMaximumImageCalculator.h"
 
+
 #include "SIMPLib/Common/Constants.h"
 #include "SIMPLib/FilterParameters/IntFilterParameter.h"
 #include "SIMPLib/FilterParameters/BooleanFilterParameter.h"
@@ -49,6 +50,9 @@
 
 #include "SIMPLib/ITK/itkBridge.h"
 
+#include "ImageProcessing/ImageProcessingFilters/util/ItkSliceView.hpp"
+#include "ImageProcessing/ImageProcessingFilters/util/SliceExecutor.hpp"
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -180,13 +184,6 @@ void ItkKMeans::execute()
   size_t udims[3] = {0, 0, 0};
   std::tie(udims[0], udims[1], udims[2]) = m->getGeometryAs<ImageGeom>()->getDimensions();
 
-  int64_t dims[3] =
-  {
-    static_cast<int64_t>(udims[0]),
-    static_cast<int64_t>(udims[1]),
-    static_cast<int64_t>(udims[2]),
-  };
-
   //wrap input as itk image
   ImageProcessingConstants::DefaultImageType::Pointer inputImage = ITKUtilitiesType::CreateItkWrapperForDataPointer(m, attrMatName, m_SelectedCellArray);
 
@@ -199,11 +196,10 @@ void ItkKMeans::execute()
     //wrap output buffer as image
     ImageProcessingConstants::DefaultImageType::Pointer outputImage = ITKUtilitiesType::CreateItkWrapperForDataPointer(m, attrMatName, m_NewCellArray);
 
-    //loop over slices
-    for(int i = 0; i < dims[2]; i++)
-    {
-      //get slice
-      ImageProcessingConstants::DefaultSliceType::Pointer slice = ITKUtilitiesType::ExtractSlice(inputImage, ImageProcessingConstants::ZSlice, i);
+    //classify slices in parallel, each with its own filters
+    auto classifySlice = [&](size_t z, QString& errorMessage) -> int {
+      //view slice
+      ImageProcessingConstants::DefaultSliceType::Pointer slice = DefaultSliceView::WrapSlice(inputImage, z);
 
       //find max/min
       CalculatorType::Pointer minMaxFilter = CalculatorType::New ();
@@ -213,6 +209,7 @@ void ItkKMeans::execute()
 
       //set up kmeans filter
       KMeansType::Pointer kMeans = KMeansType::New();
+      SliceExecutor::SetSingleThreaded(kMeans.GetPointer());
       kMeans->SetInput(slice);
       ImageProcessingConstants::DefaultPixelType meanIncrement = range / m_Classes;
       ImageProcessingConstants::DefaultPixelType mean = range / (2 * m_Classes);
@@ -221,6 +218,7 @@ void ItkKMeans::execute()
         kMeans->AddClassWithInitialMean(mean);
         mean = mean + meanIncrement;
       }
+      DefaultSliceView::SetSliceAsOutput(kMeans->GetOutput(), outputImage, z);
 
       try
       {
@@ -228,14 +226,16 @@ void ItkKMeans::execute()
       }
       catch( itk::ExceptionObject& err )
       {
-        setErrorCondition(-5);
-        QString ss = QObject::tr("Failed to execute itk::KMeans filter. Error Message returned from ITK:\n   %1").arg(err.GetDescription());
-        notifyErrorMessage(getHumanLabel(), ss, getErrorCondition());
+        errorMessage = QObject::tr("Failed to execute itk::KMeans filter. Error Message returned from ITK:\n   %1").arg(err.GetDescription());
+        return -5;
       }
 
-      //copy back into volume
-      ITKUtilitiesType::SetSlice(outputImage, kMeans->GetOutput(), ImageProcessingConstants::ZSlice, i);
-    }
+      //the result is written into the volume
+      DefaultSliceView::CommitSlice(kMeans->GetOutput(), outputImage, z);
+      return 0;
+    };
+    SliceExecutor::Execute(this, udims[2], QObject::tr("Classifying Slices"), classifySlice);
+    if(getErrorCondition() < 0 || getCancel()) { return; }
   }
   else
   {
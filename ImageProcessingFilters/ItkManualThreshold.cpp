@@ -44,9 +44,11 @@
 #include "SIMPLib/Geometry/ImageGeom.h"
 
 #include "SIMPLib/ITK/itkBridge.h"
-
-//thresholding filter
+#if ImageProcessing_BitDepth == 32
 #include "itkBinaryThresholdImageFilter.h"
+#endif
+
+#include "ImageProcessing/ImageProcessingFilters/util/LookupTableThreshold.hpp"
 
 // -----------------------------------------------------------------------------
 //
@@ -161,11 +163,10 @@ void ItkManualThreshold::execute()
   if(getErrorCondition() < 0) { return; }
 
   DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getSelectedCellArrayPath().getDataContainerName());
-  QString attrMatName = getSelectedCellArrayPath().getAttributeMatrixName();
 
-  //get dims
-  size_t udims[3] = {0, 0, 0};
-  std::tie(udims[0], udims[1], udims[2]) = m->getGeometryAs<ImageGeom>()->getDimensions();
+#if ImageProcessing_BitDepth == 32
+  //lookup tables need 8 or 16 bit pixels, float volumes go through itk::BinaryThresholdImageFilter
+  QString attrMatName = getSelectedCellArrayPath().getAttributeMatrixName();
 
   //wrap input as itk image
   ImageProcessingConstants::DefaultImageType::Pointer inputImage = ITKUtilitiesType::CreateItkWrapperForDataPointer(m, attrMatName, m_SelectedCellArray);
@@ -191,7 +192,14 @@ void ItkManualThreshold::execute()
     setErrorCondition(-5);
     QString ss = QObject::tr("Failed to execute itk::ManualThreshold filter. Error Message returned from ITK:\n   %1").arg(err.GetDescription());
     notifyErrorMessage(getHumanLabel(), ss, getErrorCondition());
+    return;
   }
+#else
+  //threshold through a lookup table with the range and values of itk::BinaryThresholdImageFilter
+  LookupTableThreshold<ImageProcessingConstants::DefaultPixelType> lookupTable;
+  lookupTable.setBinary(static_cast<ImageProcessingConstants::DefaultPixelType>(m_ManualParameter), 255, 255, 0);
+  lookupTable.apply(m_SelectedCellArray, m_NewCellArray, m_NewCellArrayPtr.lock()->getNumberOfTuples());
+#endif
 
   //array name changing/cleanup
   if(!m_SaveAsNewArray)
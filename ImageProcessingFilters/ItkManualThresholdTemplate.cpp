@@ -35,6 +35,7 @@
 #include "ItkManualThresholdTemplate.h"
 
 #include <string>
+#include <type_traits>
 
 //thresholding filter
 #include "itkBinaryThresholdImageFilter.h"
@@ -51,6 +52,8 @@
 // ImageProcessing Plugin
 #include "SIMPLib/ITK/itkBridge.h"
 
+#include "ImageProcessing/ImageProcessingFilters/util/LookupTableThreshold.hpp"
+
 /**
  * @brief This is a private implementation for the filter that handles the actual algorithm implementation details
  * for us like figuring out if we can use this private implementation with the data array that is assigned.
@@ -86,6 +89,35 @@ class ManualThresholdTemplatePrivate
 
       size_t numVoxels = inputDataPtr->getNumberOfTuples();
 
+      //8 and 16 bit integers are thresholded through a lookup table, wider and floating point types by itk
+      Threshold(filter, inputData, outputData, numVoxels, manParameter, m, attrMatName, IsLookupTableType<PixelType>());
+    }
+
+  private:
+    // -----------------------------------------------------------------------------
+    // Lookup table threshold with the range, values and checks of the itk path
+    // -----------------------------------------------------------------------------
+    void static Threshold(ItkManualThresholdTemplate* filter, PixelType* inputData, PixelType* outputData, size_t numVoxels, PixelType manParameter, DataContainer::Pointer /* m */, QString /* attrMatName */, std::true_type)
+    {
+      const PixelType upperThreshold = static_cast<PixelType>(0xFF);
+      if(manParameter > upperThreshold)
+      {
+        filter->setErrorCondition(-5);
+        QString ss = QObject::tr("The threshold %1 is larger than the upper threshold %2").arg(static_cast<int>(manParameter)).arg(static_cast<int>(upperThreshold));
+        filter->notifyErrorMessage(filter->getHumanLabel(), ss, filter->getErrorCondition());
+        return;
+      }
+
+      LookupTableThreshold<PixelType> lookupTable;
+      lookupTable.setBinary(manParameter, upperThreshold, static_cast<PixelType>(255), 0);
+      lookupTable.apply(inputData, outputData, numVoxels);
+    }
+
+    // -----------------------------------------------------------------------------
+    // itk::BinaryThresholdImageFilter threshold
+    // -----------------------------------------------------------------------------
+    void static Threshold(ItkManualThresholdTemplate* filter, PixelType* inputData, PixelType* outputData, size_t numVoxels, PixelType manParameter, DataContainer::Pointer m, QString attrMatName, std::false_type)
+    {
       typedef ItkBridge<PixelType> ItkBridgeType;
 
       //wrap input as itk image
@@ -114,7 +146,7 @@ class ManualThresholdTemplatePrivate
         filter->notifyErrorMessage(filter->getHumanLabel(), ss, filter->getErrorCondition());
       }
     }
-  private:
+
     ManualThresholdTemplatePrivate(const ManualThresholdTemplatePrivate&); // Copy Constructor Not Implemented
     void operator=(const ManualThresholdTemplatePrivate&);                 // Move assignment Not Implemented
 };
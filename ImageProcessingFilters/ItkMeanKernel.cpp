@@ -46,8 +46,12 @@
 #include "SIMPLib/Geometry/ImageGeom.h"
 
 #include "SIMPLib/ITK/itkBridge.h"
+#if ImageProcessing_BitDepth != 8
 #include "itkMeanImageFilter.h"
 #include "itkRescaleIntensityImageFilter.h"
+#endif
+
+#include "ImageProcessing/ImageProcessingFilters/util/BoxMean.h"
 
 // -----------------------------------------------------------------------------
 //
@@ -141,6 +145,13 @@ void ItkMeanKernel::dataCheck()
   m_NewCellArrayPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<ImageProcessingConstants::DefaultPixelType>, AbstractFilter, ImageProcessingConstants::DefaultPixelType>(this, tempPath, 0, dims); /* Assigns the shared_ptr<> to an instance variable that is a weak_ptr<> */
   if(nullptr != m_NewCellArrayPtr.lock())                       /* Validate the Weak Pointer wraps a non-nullptr pointer to a DataArray<T> object */
   { m_NewCellArray = m_NewCellArrayPtr.lock()->getPointer(0); } /* Now assign the raw pointer to data from the DataArray<T> object */
+
+  if(m_KernelSize.x < 0 || m_KernelSize.y < 0 || m_KernelSize.z < 0)
+  {
+    QString ss = QObject::tr("The kernel size must not be negative");
+    setErrorCondition(-1000);
+    notifyErrorMessage(getHumanLabel(), ss, getErrorCondition());
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -168,11 +179,12 @@ void ItkMeanKernel::execute()
 
   /* Place all your code to execute your filter here. */
   DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getSelectedCellArrayPath().getDataContainerName());
-  QString attrMatName = getSelectedCellArrayPath().getAttributeMatrixName();
 
+#if ImageProcessing_BitDepth != 8
+  //the box sums work on 8 bit pixels, other pixel types go through the itk::MeanImageFilter pipeline
+  QString attrMatName = getSelectedCellArrayPath().getAttributeMatrixName();
   ImageProcessingConstants::DefaultImageType::Pointer inputImage = ITKUtilitiesType::CreateItkWrapperForDataPointer(m, attrMatName, m_SelectedCellArray);
 
-  //create edge filter
   typedef itk::MeanImageFilter<ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::FloatImageType> MeanFilterType;
   MeanFilterType::Pointer meanFilter = MeanFilterType::New();
   meanFilter->SetInput(inputImage);
@@ -191,33 +203,45 @@ void ItkMeanKernel::execute()
   rescaleFilter->SetOutputMinimum(0);
   rescaleFilter->SetOutputMaximum(255);
 
-
   //have filter write to dream3d array instead of creating its own buffer
   ITKUtilitiesType::SetITKFilterOutput(rescaleFilter->GetOutput(), m_NewCellArrayPtr.lock());
 
   //execute filters
   try
   {
-    meanFilter->Update();
+    rescaleFilter->Update();
   }
   catch( itk::ExceptionObject& err )
   {
     setErrorCondition(-5);
     QString ss = QObject::tr("Failed to execute itk::MeanImageFilter filter. Error Message returned from ITK:\n   %1").arg(err.GetDescription());
     notifyErrorMessage(getHumanLabel(), ss, getErrorCondition());
+    return;
   }
+#else
+  //get dims
+  size_t udims[3] = {0, 0, 0};
+  std::tie(udims[0], udims[1], udims[2]) = m->getGeometryAs<ImageGeom>()->getDimensions();
 
-
-  try
+  //kernel size is the radius of the box around every voxel
+  size_t radius[3] =
   {
-    rescaleFilter->Update();
-  }
-  catch( itk::ExceptionObject& err )
+    static_cast<size_t>(m_KernelSize.x),
+    static_cast<size_t>(m_KernelSize.y),
+    static_cast<size_t>(m_KernelSize.z),
+  };
+
+  //box sums do not depend on the kernel size, the means are rescaled onto [0, 255] as the itk::MeanImageFilter and
+  //itk::RescaleIntensityImageFilter pipeline did
+  BoxMean::Pointer mean = BoxMean::New();
+  int err = mean->execute(m_SelectedCellArray, m_NewCellArray, udims, radius);
+  if(err < 0)
   {
-    setErrorCondition(-5);
-    QString ss = QObject::tr("Failed to execute itk::RescaleIntensityImageFilter filter. Error Message returned from ITK:\n   %1").arg(err.GetDescription());
-    notifyErrorMessage(getHumanLabel(), ss, getErrorCondition());
+    setErrorCondition(err);
+    notifyErrorMessage(getHumanLabel(), mean->getErrorMessage(), getErrorCondition());
+    return;
   }
+#endif
 
   //array name changing/cleanup
   if(!m_SaveAsNewArray)
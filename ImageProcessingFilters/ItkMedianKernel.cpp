@@ -46,7 +46,11 @@
 #include "SIMPLib/Geometry/ImageGeom.h"
 
 #include "SIMPLib/ITK/itkBridge.h"
+#if ImageProcessing_BitDepth == 32
 #include "itkMedianImageFilter.h"
+#endif
+
+#include "ImageProcessing/ImageProcessingFilters/util/SlidingHistogramMedian.h"
 
 // -----------------------------------------------------------------------------
 //
@@ -141,6 +145,13 @@ void ItkMedianKernel::dataCheck()
   m_NewCellArrayPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<ImageProcessingConstants::DefaultPixelType>, AbstractFilter, ImageProcessingConstants::DefaultPixelType>(this, tempPath, 0, dims); /* Assigns the shared_ptr<> to an instance variable that is a weak_ptr<> */
   if(nullptr != m_NewCellArrayPtr.lock())                       /* Validate the Weak Pointer wraps a non-nullptr pointer to a DataArray<T> object */
   { m_NewCellArray = m_NewCellArrayPtr.lock()->getPointer(0); } /* Now assign the raw pointer to data from the DataArray<T> object */
+
+  if(m_KernelSize.x < 0 || m_KernelSize.y < 0 || m_KernelSize.z < 0)
+  {
+    QString ss = QObject::tr("The kernel size must not be negative");
+    setErrorCondition(-1000);
+    notifyErrorMessage(getHumanLabel(), ss, getErrorCondition());
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -168,11 +179,12 @@ void ItkMedianKernel::execute()
 
   /* Place all your code to execute your filter here. */
   DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getSelectedCellArrayPath().getDataContainerName());
-  QString attrMatName = getSelectedCellArrayPath().getAttributeMatrixName();
 
+#if ImageProcessing_BitDepth == 32
+  //the sliding histogram median needs 8 or 16 bit pixels, float volumes go through itk::MedianImageFilter
+  QString attrMatName = getSelectedCellArrayPath().getAttributeMatrixName();
   ImageProcessingConstants::DefaultImageType::Pointer inputImage = ITKUtilitiesType::CreateItkWrapperForDataPointer(m, attrMatName, m_SelectedCellArray);
 
-  //create edge filter
   typedef itk::MedianImageFilter < ImageProcessingConstants::DefaultImageType,  ImageProcessingConstants::DefaultImageType > MedianFilterType;
   MedianFilterType::Pointer medianFilter = MedianFilterType::New();
   medianFilter->SetInput(inputImage);
@@ -197,7 +209,31 @@ void ItkMedianKernel::execute()
     setErrorCondition(-5);
     QString ss = QObject::tr("Failed to execute itk::MedianImageFilter filter. Error Message returned from ITK:\n   %1").arg(err.GetDescription());
     notifyErrorMessage(getHumanLabel(), ss, getErrorCondition());
+    return;
+  }
+#else
+  //get dims
+  size_t udims[3] = {0, 0, 0};
+  std::tie(udims[0], udims[1], udims[2]) = m->getGeometryAs<ImageGeom>()->getDimensions();
+
+  //kernel size is the radius of the box around every voxel
+  size_t radius[3] =
+  {
+    static_cast<size_t>(m_KernelSize.x),
+    static_cast<size_t>(m_KernelSize.y),
+    static_cast<size_t>(m_KernelSize.z),
+  };
+
+  //run the sliding histogram median, it selects the same value as itk::MedianImageFilter
+  SlidingHistogramMedian::Pointer median = SlidingHistogramMedian::New();
+  int err = median->execute(m_SelectedCellArray, m_NewCellArray, udims, radius);
+  if(err < 0)
+  {
+    setErrorCondition(err);
+    notifyErrorMessage(getHumanLabel(), median->getErrorMessage(), getErrorCondition());
+    return;
   }
+#endif
 
   //array name changing/cleanup
   if(!m_SaveAsNewArray)
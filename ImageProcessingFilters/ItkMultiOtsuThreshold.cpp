@@ -47,6 +47,9 @@
 
 #include "SIMPLib/ITK/itkBridge.h"
 
+#include "ImageProcessing/ImageProcessingFilters/util/ItkSliceView.hpp"
+#include "ImageProcessing/ImageProcessingFilters/util/SliceExecutor.hpp"
+
 #include "itkOtsuMultipleThresholdsImageFilter.h"
 
 // -----------------------------------------------------------------------------
@@ -171,35 +174,29 @@ void ItkMultiOtsuThreshold::execute()
   size_t udims[3] = {0, 0, 0};
   std::tie(udims[0], udims[1], udims[2]) = m->getGeometryAs<ImageGeom>()->getDimensions();
 
-  int64_t dims[3] =
-  {
-    static_cast<int64_t>(udims[0]),
-    static_cast<int64_t>(udims[1]),
-    static_cast<int64_t>(udims[2]),
-  };
-
   //wrap input as itk image
   ImageProcessingConstants::DefaultImageType::Pointer inputImage = ITKUtilitiesType::CreateItkWrapperForDataPointer(m, attrMatName, m_SelectedCellArray);
 
   if(m_Slice)
   {
-    //define 2d histogram generator
+    //define 2d threshold filter
     typedef itk::OtsuMultipleThresholdsImageFilter< ImageProcessingConstants::DefaultSliceType, ImageProcessingConstants::DefaultSliceType > ThresholdType;
-    ThresholdType::Pointer otsuThresholder = ThresholdType::New();
 
     //wrap output buffer as image
     ImageProcessingConstants::DefaultImageType::Pointer outputImage = ITKUtilitiesType::CreateItkWrapperForDataPointer(m, attrMatName, m_NewCellArray);
 
-    //loop over slices
-    for(int i = 0; i < dims[2]; i++)
-    {
-      //get slice
-      ImageProcessingConstants::DefaultSliceType::Pointer slice = ITKUtilitiesType::ExtractSlice(inputImage, ImageProcessingConstants::ZSlice, i);
+    //threshold slices in parallel, each with its own filter
+    auto thresholdSlice = [&](size_t z, QString& errorMessage) -> int {
+      //view slice
+      ImageProcessingConstants::DefaultSliceType::Pointer slice = DefaultSliceView::WrapSlice(inputImage, z);
 
       //threshold
+      ThresholdType::Pointer otsuThresholder = ThresholdType::New();
+      SliceExecutor::SetSingleThreaded(otsuThresholder.GetPointer());
       otsuThresholder->SetInput(slice);
       otsuThresholder->SetNumberOfThresholds(m_Levels);
       otsuThresholder->SetLabelOffset(1);
+      DefaultSliceView::SetSliceAsOutput(otsuThresholder->GetOutput(), outputImage, z);
       //execute filters
       try
       {
@@ -207,14 +204,16 @@ void ItkMultiOtsuThreshold::execute()
       }
       catch( itk::ExceptionObject& err )
       {
-        setErrorCondition(-5);
-        QString ss = QObject::tr("Failed to execute itk::OtsuMultipleThresholdsImageFilter filter. Error Message returned from ITK:\n   %1").arg(err.GetDescription());
-        notifyErrorMessage(getHumanLabel(), ss, getErrorCondition());
+        errorMessage = QObject::tr("Failed to execute itk::OtsuMultipleThresholdsImageFilter filter. Error Message returned from ITK:\n   %1").arg(err.GetDescription());
+        return -5;
       }
 
-      //copy back into volume
-      ITKUtilitiesType::SetSlice(outputImage, otsuThresholder->GetOutput(), ImageProcessingConstants::ZSlice, i);
-    }
+      //the result is written into the volume
+      DefaultSliceView::CommitSlice(otsuThresholder->GetOutput(), outputImage, z);
+      return 0;
+    };
+    SliceExecutor::Execute(this, udims[2], QObject::tr("Thresholding Slices"), thresholdSlice);
+    if(getErrorCondition() < 0 || getCancel()) { return; }
   }
   else
   {
@@ -45,8 +45,13 @@
 #include "SIMPLib/Geometry/ImageGeom.h"
 
 #include "SIMPLib/ITK/itkBridge.h"
+#if ImageProcessing_BitDepth != 8
 #include "itkRescaleIntensityImageFilter.h"
 #include "itkSobelEdgeDetectionImageFilter.h"
+#endif
+
+#include "ImageProcessing/ImageProcessingFilters/util/FusedSobelEdge.h"
+#include "ImageProcessing/ImageProcessingFilters/util/SliceExecutor.hpp"
 
 // -----------------------------------------------------------------------------
 //
@@ -160,6 +165,10 @@ void ItkSobelEdge::execute()
   if(getErrorCondition() < 0) { return; }
 
   DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getSelectedCellArrayPath().getDataContainerName());
+
+#if ImageProcessing_BitDepth != 8
+  //the fused gradient works on 8 bit pixels, other pixel types go through the itk::SobelEdgeDetectionImageFilter
+  //pipeline
   QString attrMatName = getSelectedCellArrayPath().getAttributeMatrixName();
 
   //wrap m_RawImageData as itk::image
@@ -174,13 +183,6 @@ void ItkSobelEdge::execute()
     size_t udims[3] = {0, 0, 0};
     std::tie(udims[0], udims[1], udims[2]) = m->getGeometryAs<ImageGeom>()->getDimensions();
 
-    int64_t dims[3] =
-    {
-      static_cast<int64_t>(udims[0]),
-      static_cast<int64_t>(udims[1]),
-      static_cast<int64_t>(udims[2]),
-    };
-
     //create edge filter
     typedef itk::SobelEdgeDetectionImageFilter<ImageProcessingConstants::DefaultSliceType, ImageProcessingConstants::FloatSliceType> SobelFilterType;
     SobelFilterType::Pointer sobelFilter = SobelFilterType::New();
@@ -192,7 +194,7 @@ void ItkSobelEdge::execute()
     rescaleFilter->SetOutputMaximum(255);
 
     //loop over slices applying filters
-    for(int i = 0; i < dims[2]; ++i)
+    for(size_t i = 0; i < udims[2]; ++i)
     {
       QString ss = QObject::tr("Finding Edges On Slice: %1").arg(i + 1);
       notifyStatusMessage(getMessagePrefix(), getHumanLabel(), ss);
@@ -204,7 +206,6 @@ void ItkSobelEdge::execute()
       sobelFilter->SetInput(inputSlice);
       rescaleFilter->SetInput(sobelFilter->GetOutput());
 
-
       //execute filters
       try
       {
@@ -216,6 +217,7 @@ void ItkSobelEdge::execute()
         setErrorCondition(-5);
         QString ss = QObject::tr("Failed to execute itk::SobelEdgeDetectionImageFilter filter. Error Message returned from ITK:\n   %1").arg(err.GetDescription());
         notifyErrorMessage(getHumanLabel(), ss, getErrorCondition());
+        return;
       }
 
       //copy into volume
@@ -228,7 +230,6 @@ void ItkSobelEdge::execute()
     typedef itk::SobelEdgeDetectionImageFilter<ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::FloatImageType> SobelFilterType;
     SobelFilterType::Pointer sobelFilter = SobelFilterType::New();
     sobelFilter->SetInput(inputImage);
-    sobelFilter->SetObjectName(std::string("itk::SobelEdgeDetectionImageFilter"));
 
     //convert result back to uint8
     typedef itk::RescaleIntensityImageFilter<ImageProcessingConstants::FloatImageType, ImageProcessingConstants::DefaultImageType> RescaleImageType;
@@ -236,7 +237,6 @@ void ItkSobelEdge::execute()
     rescaleFilter->SetInput(sobelFilter->GetOutput());
     rescaleFilter->SetOutputMinimum(0);
     rescaleFilter->SetOutputMaximum(255);
-    rescaleFilter->SetObjectName(std::string("itk::RescaleIntensityImageFilter"));
 
     //have filter write to dream3d array instead of creating its own buffer
     ITKUtilitiesType::SetITKFilterOutput(rescaleFilter->GetOutput(), m_NewCellArrayPtr.lock());
@@ -244,7 +244,6 @@ void ItkSobelEdge::execute()
     //execute filters
     try
     {
-      sobelFilter->Update();
       rescaleFilter->Update();
     }
     catch( itk::ExceptionObject& err )
@@ -252,9 +251,37 @@ void ItkSobelEdge::execute()
       setErrorCondition(-5);
       QString ss = QObject::tr("Failed to execute itk::SobelEdgeDetectionImageFilter filter. Error Message returned from ITK:\n   %1").arg(err.GetDescription());
       notifyErrorMessage(getHumanLabel(), ss, getErrorCondition());
+      return;
     }
+  }
+#else
+  //get dimensions
+  size_t udims[3] = {0, 0, 0};
+  std::tie(udims[0], udims[1], udims[2]) = m->getGeometryAs<ImageGeom>()->getDimensions();
 
+  //gradient magnitudes are computed row by row and rescaled straight into the output array
+  FusedSobelEdge::Pointer sobel = FusedSobelEdge::New();
+  if(m_Slice)
+  {
+    //filter slices in parallel, each rescaled on its own range
+    auto edgeSlice = [&](size_t z, QString& /* errorMessage */) -> int {
+      sobel->executeSlice(m_SelectedCellArray, m_NewCellArray, udims, z);
+      return 0;
+    };
+    SliceExecutor::Execute(this, udims[2], QObject::tr("Finding Edges On Slices"), edgeSlice);
+    if(getErrorCondition() < 0 || getCancel()) { return; }
+  }
+  else
+  {
+    int err = sobel->execute(m_SelectedCellArray, m_NewCellArray, udims);
+    if(err < 0)
+    {
+      setErrorCondition(err);
+      notifyErrorMessage(getHumanLabel(), sobel->getErrorMessage(), getErrorCondition());
+      return;
+    }
   }
+#endif
 
   //array name changing/cleanup
   if(!m_SaveAsNewArray)
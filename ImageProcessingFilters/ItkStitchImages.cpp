@@ -33,12 +33,20 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "ItkStitchImages.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "SIMPLib/FilterParameters/AttributeMatrixSelectionFilterParameter.h"
 #include "SIMPLib/FilterParameters/DataArraySelectionFilterParameter.h"
 #include "SIMPLib/FilterParameters/StringFilterParameter.h"
 #include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
+#include "SIMPLib/FilterParameters/BooleanFilterParameter.h"
+#include "SIMPLib/FilterParameters/ChoiceFilterParameter.h"
+#include "SIMPLib/FilterParameters/LinkedBooleanFilterParameter.h"
+#include "SIMPLib/FilterParameters/OutputFileFilterParameter.h"
 #include "SIMPLib/FilterParameters/SeparatorFilterParameter.h"
 #include "SIMPLib/Geometry/ImageGeom.h"
+#include "SIMPLib/Utilities/FileSystemPathHelper.h"
 
 
 #include "itkMaskedFFTNormalizedCorrelationImageFilter.h"
@@ -46,11 +54,65 @@
 #include "SIMPLib/ITK/itkBridge.h"
 
 #include "itkImage.h"
-#include "itkImageFileWriter.h"
-#include "itkPasteImageFilter.h"
 
 
 #include "ImageProcessing/ImageProcessingHelpers.hpp"
+#include "ImageProcessing/ImageProcessingFilters/util/MosaicCompositor.h"
+#include "ImageProcessing/ImageProcessingFilters/util/TiledTiffWriter.h"
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_scheduler_init.h>
+#endif
+
+namespace
+{
+// Rows per band when the mosaic is composited in memory
+const size_t k_BandHeight = 256;
+} // namespace
+
+/**
+ * @brief The CompositeMosaicBandsImpl class composites a range of bands of the mosaic directly into the montage array.
+ * The bands cover disjoint rows, so any number of them can be composited at the same time.
+ */
+class CompositeMosaicBandsImpl
+{
+public:
+  CompositeMosaicBandsImpl(MosaicCompositor* compositor, ImageProcessingConstants::DefaultPixelType* mosaic, size_t bandHeight)
+  : m_Compositor(compositor)
+  , m_Mosaic(mosaic)
+  , m_BandHeight(bandHeight)
+  {
+  }
+
+  virtual ~CompositeMosaicBandsImpl() = default;
+
+  void convert(size_t start, size_t end) const
+  {
+    const size_t mosaicWidth = m_Compositor->getMosaicWidth();
+    const size_t mosaicHeight = m_Compositor->getMosaicHeight();
+    for(size_t band = start; band < end; band++)
+    {
+      const size_t rowStart = band * m_BandHeight;
+      const size_t rowEnd = std::min(rowStart + m_BandHeight, mosaicHeight);
+      m_Compositor->compositeBand(rowStart, rowEnd, m_Mosaic + rowStart * mosaicWidth);
+    }
+  }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    convert(r.begin(), r.end());
+  }
+#endif
+
+private:
+  MosaicCompositor* m_Compositor;
+  ImageProcessingConstants::DefaultPixelType* m_Mosaic;
+  size_t m_BandHeight;
+};
 
 // -----------------------------------------------------------------------------
 //
@@ -61,6 +123,10 @@ ItkStitchImages::ItkStitchImages()
 , m_StitchedVolumeDataContainerName("MontagedImageDataContainer")
 , m_StitchedImagesArrayName("Montage")
 , m_StitchedAttributeMatrixName("MontageAttributeMatrix")
+, m_StreamToFile(false)
+, m_OutputFile("")
+, m_WritePyramid(false)
+, m_BlendMode(MosaicCompositor::Overwrite)
 , m_StitchedCoordinates(nullptr)
 , m_StitchedImageArray(nullptr)
 {
@@ -93,6 +159,29 @@ void ItkStitchImages::setupFilterParameters()
     parameters.push_back(SIMPL_NEW_DA_SELECTION_FP("Stitched Coordinates Names", AttributeArrayNamesPath, FilterParameter::RequiredArray, ItkStitchImages, req));
   }
 
+  QStringList linkedProps;
+  linkedProps << "OutputFile"
+              << "WritePyramid";
+  parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Write Mosaic Directly to File", StreamToFile, FilterParameter::Parameter, ItkStitchImages, linkedProps));
+  parameters.push_back(SIMPL_NEW_OUTPUT_FILE_FP("Output Mosaic File", OutputFile, FilterParameter::Parameter, ItkStitchImages, "*.tif", "TIFF"));
+  parameters.push_back(SIMPL_NEW_BOOL_FP("Write Pyramid Levels", WritePyramid, FilterParameter::Parameter, ItkStitchImages));
+
+  {
+    ChoiceFilterParameter::Pointer parameter = ChoiceFilterParameter::New();
+    parameter->setHumanLabel("Overlap Blending");
+    parameter->setPropertyName("BlendMode");
+    parameter->setSetterCallback(SIMPL_BIND_SETTER(ItkStitchImages, this, BlendMode));
+    parameter->setGetterCallback(SIMPL_BIND_GETTER(ItkStitchImages, this, BlendMode));
+
+    QVector<QString> choices;
+    choices.push_back("None (Last Tile Wins)");
+    choices.push_back("Linear Feathering");
+    choices.push_back("Multi-Band (Slow)");
+    parameter->setChoices(choices);
+    parameter->setCategory(FilterParameter::Parameter);
+    parameters.push_back(parameter);
+  }
+
   parameters.push_back(SIMPL_NEW_STRING_FP("Stitched Image Data Container", StitchedVolumeDataContainerName, FilterParameter::CreatedArray, ItkStitchImages));
   parameters.push_back(SeparatorFilterParameter::New("Cell Data", FilterParameter::CreatedArray));
   parameters.push_back(SIMPL_NEW_STRING_FP("Montage Attribute Matrix", StitchedAttributeMatrixName, FilterParameter::CreatedArray, ItkStitchImages));
@@ -113,6 +202,10 @@ void ItkStitchImages::readFilterParameters(AbstractFilterParametersReader* reade
   setStitchedImagesArrayName(reader->readString("StitchedImagesArrayName", getStitchedImagesArrayName()));
   setStitchedAttributeMatrixName(reader->readString("StitchedAttributeMatrixName", getStitchedAttributeMatrixName()));
   setAttributeArrayNamesPath(reader->readDataArrayPath("AttributeArrayNamesPath", getAttributeArrayNamesPath()));
+  setStreamToFile(reader->readValue("StreamToFile", getStreamToFile()));
+  setOutputFile(reader->readString("OutputFile", getOutputFile()));
+  setWritePyramid(reader->readValue("WritePyramid", getWritePyramid()));
+  setBlendMode(reader->readValue("BlendMode", getBlendMode()));
   reader->closeFilterGroup();
 
 }
@@ -181,6 +274,18 @@ void ItkStitchImages::dataCheck()
   if(nullptr != m_StitchedCoordinatesPtr.lock())                              /* Validate the Weak Pointer wraps a non-nullptr pointer to a DataArray<T> object */
   { m_StitchedCoordinates = m_StitchedCoordinatesPtr.lock()->getPointer(0); } /* Now assign the raw pointer to data from the DataArray<T> object */
 
+  if(getBlendMode() < MosaicCompositor::Overwrite || getBlendMode() > MosaicCompositor::MultiBand)
+  {
+    QString ss = QObject::tr("The overlap blending choice %1 is not valid").arg(getBlendMode());
+    setErrorCondition(-76003);
+    notifyErrorMessage(getHumanLabel(), ss, getErrorCondition());
+  }
+
+  if(getStreamToFile())
+  {
+    FileSystemPathHelper::CheckOutputFile(this, "Output Mosaic File", getOutputFile(), true);
+  }
+
   DataContainer::Pointer m = getDataContainerArray()->getPrereqDataContainer(this, getStitchedCoordinatesArrayPath().getDataContainerName(), false);
   if(getErrorCondition() < 0 || nullptr == m) { return; }
 
@@ -209,6 +314,11 @@ void ItkStitchImages::dataCheck()
   if(getErrorCondition() < 0) { return; }
   dims[0] = 1;
 
+  // When the mosaic is written straight to disk it is never held in memory, so no montage array is created
+  if(getStreamToFile())
+  {
+    return;
+  }
 
   tempPath.update(getStitchedVolumeDataContainerName(), getStitchedAttributeMatrixName(), getStitchedImagesArrayName() );
   m_StitchedImageArrayPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<ImageProcessingConstants::DefaultPixelType>, AbstractFilter, ImageProcessingConstants::DefaultPixelType>(this, tempPath, 0, dims); /* Assigns the shared_ptr<> to an instance variable that is a weak_ptr<> */
@@ -274,13 +384,9 @@ void ItkStitchImages::execute()
   }
 
   UInt8ArrayType::Pointer imagePtr = UInt8ArrayType::NullPointer();
-  IDataArray::Pointer iDataArray = IDataArray::NullPointer();
-  uint8_t* image = nullptr;
 
   DataArrayPath tempPath;
 
-  // getting the fist data container just to get the dimensions of each image.
-  DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getAttributeMatrixName().getDataContainerName());
   DataContainer::Pointer m2 = getDataContainerArray()->getDataContainer(getStitchedVolumeDataContainerName());
 
   QVector<size_t> udims;
@@ -298,92 +404,148 @@ void ItkStitchImages::execute()
   }
 
 
-  //    ImageProcessingConstants::UInt8ImageType* image2 = ImageProcessingConstants::UInt8ImageType::New();
-  ImageProcessingConstants::UInt8ImageType::Pointer image2 = ImageProcessingConstants::UInt8ImageType::New();
-  ImageProcessingConstants::UInt8ImageType::RegionType region;
-  ImageProcessingConstants::UInt8ImageType::IndexType start;
-  start[0] = 0;
-  start[1] = 0;
-  start[2] = 0;
-
-  ImageProcessingConstants::UInt8ImageType::SizeType size;
   unsigned int NumRows = udims[0] + abs(int(maxx)) + abs(int(minx));
   unsigned int NumCols = udims[1] + abs(int(maxy)) + abs(int(miny));
-  size[0] = NumRows;
-  size[1] = NumCols;
-  size[2] = 1;
-
-  region.SetSize(size);
-  region.SetIndex(start);
-
-
-  image2->SetRegions(region);
-  image2->Allocate();
-
-  typedef itk::PasteImageFilter <ImageProcessingConstants::UInt8ImageType, ImageProcessingConstants::UInt8ImageType > PasteImageFilterType;
-  PasteImageFilterType::Pointer pasteFilter = PasteImageFilterType::New ();
-
-  typedef itk::ImageFileWriter< ImageProcessingConstants::UInt8ImageType > WriterType;
-  WriterType::Pointer writer = WriterType::New();
-
-  ImageProcessingConstants::UInt8ImageType::IndexType destinationIndex;
 
   QVector<size_t> tDims(3);
   tDims[0] = NumRows;
   tDims[1] = NumCols;
   tDims[2] = 1;
-
   m2->getAttributeMatrix(getStitchedAttributeMatrixName())->resizeAttributeArrays(tDims);
   m2->getGeometryAs<ImageGeom>()->setDimensions(tDims[0], tDims[1], tDims[2]);
 
-  QVector<size_t> cDims(1, 1);
+  // The mosaic is assembled one band of rows at a time straight from the tile arrays
+  MosaicCompositor::Pointer compositor = MosaicCompositor::New();
+  compositor->setTileDimensions(udims[0], udims[1]);
+  compositor->setMosaicDimensions(NumRows, NumCols);
+  compositor->setBlendMode(getBlendMode());
 
-  // run through all the data containers (images)
+  QVector<size_t> cDims(1, 1);
   for(size_t i = 0; i < names.size(); i++)
   {
     tempPath.update(getAttributeMatrixName().getDataContainerName(), getAttributeMatrixName().getAttributeMatrixName(), names[i]);
-    iDataArray = getDataContainerArray()->getPrereqArrayFromPath<UInt8ArrayType, AbstractFilter>(this, tempPath, cDims);
-
-    imagePtr = std::dynamic_pointer_cast<UInt8ArrayType>(iDataArray);
-
+    imagePtr = getDataContainerArray()->getPrereqArrayFromPath<UInt8ArrayType, AbstractFilter>(this, tempPath, cDims);
     if(nullptr != imagePtr.get())
     {
-      image = imagePtr->getPointer(0);
-      ImageProcessingConstants::ImportUInt8FilterType::Pointer importFilter = ITKUtilitiesType::Dream3DtoITKImportFilter<ImageProcessingConstants::DefaultPixelType>(m, getAttributeMatrixName().getAttributeMatrixName(), image);
-      ImageProcessingConstants::UInt8ImageType* currentImage = importFilter->GetOutput();
-
-
-      destinationIndex[0] = m_StitchedCoordinates[2 * i] + abs(int(minx));
-      destinationIndex[1] = m_StitchedCoordinates[2 * i + 1] + abs(int(miny));;
-      destinationIndex[2] = 0;
-
-      pasteFilter->InPlaceOn();
-      pasteFilter->SetSourceImage(currentImage);
-      pasteFilter->SetDestinationImage(image2);
-      pasteFilter->SetSourceRegion(currentImage->GetLargestPossibleRegion());
-      pasteFilter->SetDestinationIndex(destinationIndex);
-      pasteFilter->Update();
-      image2 = pasteFilter->GetOutput();
-      image2->DisconnectPipeline();
-      ITKUtilitiesType::SetITKFilterOutput(pasteFilter->GetOutput(), m_StitchedImageArrayPtr.lock());
-      pasteFilter->Update();
+      // Tile origins are truncated to whole pixels
+      int64_t x = static_cast<int64_t>(m_StitchedCoordinates[2 * i] + abs(int(minx)));
+      int64_t y = static_cast<int64_t>(m_StitchedCoordinates[2 * i + 1] + abs(int(miny)));
+      compositor->addTile(imagePtr->getPointer(0), x, y);
     }
   }
 
-#if 0
-  writer->SetFileName( "/Users/megnashah/Desktop/testImage.tiff");
-  writer->SetInput( image2 );
-  writer->Update();
-#endif
+  if(getStreamToFile())
+  {
+    writeMosaicToFile(compositor.get());
+  }
+  else
+  {
+    // Resizing the attribute matrix reallocated the montage array
+    compositeMosaic(compositor.get(), m_StitchedImageArrayPtr.lock()->getPointer(0));
+  }
+  if(getErrorCondition() < 0 || getCancel())
+  {
+    return;
+  }
+
+  notifyStatusMessage(getHumanLabel(), "Complete");
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ItkStitchImages::writeMosaicToFile(MosaicCompositor* compositor)
+{
+  const size_t mosaicWidth = compositor->getMosaicWidth();
+  const size_t mosaicHeight = compositor->getMosaicHeight();
+
+  TiledTiffWriter::Pointer writer = TiledTiffWriter::New();
+  writer->setWritePyramid(getWritePyramid());
+  int err = writer->open(getOutputFile(), mosaicWidth, mosaicHeight);
+  if(err < 0)
+  {
+    setErrorCondition(-76010);
+    notifyErrorMessage(getHumanLabel(), writer->getErrorMessage(), getErrorCondition());
+    return;
+  }
+
+  // One band is one row of TIFF tiles, which is all the mosaic memory that is needed at any time
+  const size_t bandHeight = writer->getTileSize();
+  std::vector<ImageProcessingConstants::DefaultPixelType> band(bandHeight * mosaicWidth);
+  for(size_t rowStart = 0; rowStart < mosaicHeight; rowStart += bandHeight)
+  {
+    if(getCancel())
+    {
+      writer->abort();
+      return;
+    }
 
+    const size_t rowEnd = std::min(rowStart + bandHeight, mosaicHeight);
+    compositor->compositeBand(rowStart, rowEnd, band.data());
+    err = writer->writeBand(band.data(), rowEnd - rowStart);
+    if(err < 0)
+    {
+      setErrorCondition(-76011);
+      notifyErrorMessage(getHumanLabel(), writer->getErrorMessage(), getErrorCondition());
+      writer->abort();
+      return;
+    }
 
+    QString ss = QObject::tr("Writing Mosaic Rows %1 to %2 of %3").arg(rowStart).arg(rowEnd).arg(mosaicHeight);
+    notifyStatusMessage(getMessagePrefix(), getHumanLabel(), ss);
+  }
 
+  if(getWritePyramid())
+  {
+    QString ss = QObject::tr("Writing %1 Pyramid Levels").arg(writer->getNumberOfPyramidLevels());
+    notifyStatusMessage(getMessagePrefix(), getHumanLabel(), ss);
+  }
+  err = writer->close();
+  if(err < 0)
+  {
+    setErrorCondition(-76012);
+    notifyErrorMessage(getHumanLabel(), writer->getErrorMessage(), getErrorCondition());
+  }
+}
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ItkStitchImages::compositeMosaic(MosaicCompositor* compositor, ImageProcessingConstants::DefaultPixelType* mosaic)
+{
+  const size_t mosaicHeight = compositor->getMosaicHeight();
+  const size_t numBands = (mosaicHeight + k_BandHeight - 1) / k_BandHeight;
 
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  tbb::task_scheduler_init init;
+  bool doParallel = true;
+#endif
 
+  // Bands are dispatched in groups so that cancelling and progress messages are handled between groups
+  const size_t bandsPerGroup = 32;
+  for(size_t groupStart = 0; groupStart < numBands; groupStart += bandsPerGroup)
+  {
+    if(getCancel())
+    {
+      return;
+    }
 
+    const size_t groupEnd = std::min(groupStart + bandsPerGroup, numBands);
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    if(doParallel)
+    {
+      tbb::parallel_for(tbb::blocked_range<size_t>(groupStart, groupEnd, 1), CompositeMosaicBandsImpl(compositor, mosaic, k_BandHeight), tbb::auto_partitioner());
+    }
+    else
+#endif
+    {
+      CompositeMosaicBandsImpl serial(compositor, mosaic, k_BandHeight);
+      serial.convert(groupStart, groupEnd);
+    }
 
-  notifyStatusMessage(getHumanLabel(), "Complete");
+    QString ss = QObject::tr("Compositing Mosaic Rows 0 to %1 of %2").arg(std::min(groupEnd * k_BandHeight, mosaicHeight)).arg(mosaicHeight);
+    notifyStatusMessage(getMessagePrefix(), getHumanLabel(), ss);
+  }
 }
 
 // -----------------------------------------------------------------------------
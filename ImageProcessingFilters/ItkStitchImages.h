@@ -44,6 +44,8 @@
 
 #include "ImageProcessing/ImageProcessingDLLExport.h"
 
+class MosaicCompositor;
+
 /**
  * @class StitchImages StitchImages.h ImageProcessing/ImageProcessingFilters/StitchImages.h
  * @brief
@@ -61,6 +63,10 @@ class ImageProcessing_EXPORT ItkStitchImages : public AbstractFilter
     PYB11_PROPERTY(QString StitchedVolumeDataContainerName READ getStitchedVolumeDataContainerName WRITE setStitchedVolumeDataContainerName)
     PYB11_PROPERTY(QString StitchedImagesArrayName READ getStitchedImagesArrayName WRITE setStitchedImagesArrayName)
     PYB11_PROPERTY(QString StitchedAttributeMatrixName READ getStitchedAttributeMatrixName WRITE setStitchedAttributeMatrixName)
+    PYB11_PROPERTY(bool StreamToFile READ getStreamToFile WRITE setStreamToFile)
+    PYB11_PROPERTY(QString OutputFile READ getOutputFile WRITE setOutputFile)
+    PYB11_PROPERTY(bool WritePyramid READ getWritePyramid WRITE setWritePyramid)
+    PYB11_PROPERTY(int BlendMode READ getBlendMode WRITE setBlendMode)
 
   public:
     SIMPL_SHARED_POINTERS(ItkStitchImages)
@@ -87,6 +93,18 @@ class ImageProcessing_EXPORT ItkStitchImages : public AbstractFilter
     SIMPL_FILTER_PARAMETER(QString, StitchedAttributeMatrixName)
     Q_PROPERTY(QString StitchedAttributeMatrixName READ getStitchedAttributeMatrixName WRITE setStitchedAttributeMatrixName)
 
+    SIMPL_FILTER_PARAMETER(bool, StreamToFile)
+    Q_PROPERTY(bool StreamToFile READ getStreamToFile WRITE setStreamToFile)
+
+    SIMPL_FILTER_PARAMETER(QString, OutputFile)
+    Q_PROPERTY(QString OutputFile READ getOutputFile WRITE setOutputFile)
+
+    SIMPL_FILTER_PARAMETER(bool, WritePyramid)
+    Q_PROPERTY(bool WritePyramid READ getWritePyramid WRITE setWritePyramid)
+
+    SIMPL_FILTER_PARAMETER(int, BlendMode)
+    Q_PROPERTY(int BlendMode READ getBlendMode WRITE setBlendMode)
+
     /**
      * @brief getCompiledLibraryName Returns the name of the Library that this filter is a part of
      * @return
@@ -186,6 +204,20 @@ class ImageProcessing_EXPORT ItkStitchImages : public AbstractFilter
      */
     void initialize();
 
+    /**
+     * @brief writeMosaicToFile Composites the mosaic one band of rows at a time and writes each band to the output
+     * tiled TIFF file, so the full mosaic is never held in memory
+     * @param compositor Compositor holding every tile and its position
+     */
+    void writeMosaicToFile(MosaicCompositor* compositor);
+
+    /**
+     * @brief compositeMosaic Composites the mosaic into the montage array. Bands of rows do not depend on each other
+     * in any blend mode, so they are composited in parallel.
+     * @param compositor Compositor holding every tile and its position
+     * @param mosaic Montage array sized to the mosaic
+     */
+    void compositeMosaic(MosaicCompositor* compositor, ImageProcessingConstants::DefaultPixelType* mosaic);
 
   private:
     DEFINE_DATAARRAY_WEAKPTR(ImageProcessingConstants::DefaultPixelType, SelectedCellArray)
@@ -34,6 +34,10 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "ItkWriteImage.h"
 
+#include <algorithm>
+#include <limits>
+#include <tuple>
+
 #include <QtCore/QString>
 #include <QtCore/QFileInfo>
 
@@ -44,6 +48,7 @@
 
 #include "SIMPLib/Common/TemplateHelpers.h"
 #include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
+#include "SIMPLib/FilterParameters/ChoiceFilterParameter.h"
 #include "SIMPLib/FilterParameters/DataArraySelectionFilterParameter.h"
 #include "SIMPLib/FilterParameters/OutputFileFilterParameter.h"
 #include "SIMPLib/FilterParameters/SeparatorFilterParameter.h"
@@ -52,6 +57,15 @@
 
 #include "SIMPLib/ITK/itkBridge.h"
 
+#include "ImageProcessing/ImageProcessingFilters/util/ChunkedTiffWriter.h"
+
+namespace
+{
+// Values of the WriterMode parameter
+const int k_ItkImageWriter = 0;
+const int k_ChunkedTiff = 1;
+} // namespace
+
 /**
  * @brief This is a private implementation for the filter that handles the actual algorithm implementation details
  * for us like figuring out if we can use this private implementation with the data array that is assigned.
@@ -73,6 +87,21 @@ class WriteImagePrivate
       return (std::dynamic_pointer_cast<DataArrayType>(p).get() != nullptr);
     }
 
+    // -----------------------------------------------------------------------------
+    // Writes the array with the writer selected by the WriterMode parameter
+    // -----------------------------------------------------------------------------
+    void static Write(ItkWriteImage* filter, DataContainer::Pointer m, QString attrMatName, IDataArray::Pointer inputDataArray, QString outputFile, int writerMode)
+    {
+      if(k_ChunkedTiff == writerMode)
+      {
+        ExecuteChunked(filter, m, inputDataArray, outputFile);
+      }
+      else
+      {
+        Execute(filter, m, attrMatName, inputDataArray, outputFile);
+      }
+    }
+
     // -----------------------------------------------------------------------------
     // This is the actual templated algorithm
     // -----------------------------------------------------------------------------
@@ -163,6 +192,65 @@ class WriteImagePrivate
         filter->notifyErrorMessage(filter->getHumanLabel(), ss, filter->getErrorCondition());
       }
     }
+
+    // -----------------------------------------------------------------------------
+    // Writes the volume as a tiled, deflate compressed multi-page TIFF one z slice at a time
+    // -----------------------------------------------------------------------------
+    void static ExecuteChunked(ItkWriteImage* filter, DataContainer::Pointer m, IDataArray::Pointer inputDataArray, QString outputFile)
+    {
+      typename DataArrayType::Pointer inputDataPtr = std::dynamic_pointer_cast<DataArrayType>(inputDataArray);
+      TInputType* inputData = inputDataPtr->getPointer(0);
+      const size_t numComp = static_cast<size_t>(inputDataPtr->getNumberOfComponents());
+
+      size_t dims[3] = { 0, 0, 0 };
+      std::tie(dims[0], dims[1], dims[2]) = m->getGeometryAs<ImageGeom>()->getDimensions();
+      if(dims[0] * dims[1] * dims[2] != inputDataPtr->getNumberOfTuples())
+      {
+        filter->setErrorCondition(-6);
+        QString ss = QObject::tr("The number of tuples of the selected array (%1) does not match the image geometry").arg(inputDataPtr->getNumberOfTuples());
+        filter->notifyErrorMessage(filter->getHumanLabel(), ss, filter->getErrorCondition());
+        return;
+      }
+
+      int sampleFormat = ChunkedTiffWriter::FloatingPoint;
+      if(std::numeric_limits<TInputType>::is_integer)
+      {
+        sampleFormat = std::numeric_limits<TInputType>::is_signed ? ChunkedTiffWriter::SignedInteger : ChunkedTiffWriter::UnsignedInteger;
+      }
+
+      ChunkedTiffWriter::Pointer writer = ChunkedTiffWriter::New();
+      int err = writer->open(outputFile, dims[0], dims[1], dims[2], numComp, sizeof(TInputType), sampleFormat);
+      const size_t sliceValues = dims[0] * dims[1] * numComp;
+      const size_t slicesPerBatch = writer->getSlicesPerBatch();
+      for(size_t z = 0; z < dims[2] && err >= 0; z += slicesPerBatch)
+      {
+        if(filter->getCancel())
+        {
+          writer->abort();
+          return;
+        }
+        const size_t count = std::min(slicesPerBatch, dims[2] - z);
+        QString ss = QObject::tr("Writing slice %1 of %2").arg(z + count).arg(dims[2]);
+        filter->notifyStatusMessage(filter->getMessagePrefix(), filter->getHumanLabel(), ss);
+        err = writer->writeSlices(inputData + z * sliceValues, count);
+      }
+      if(err >= 0)
+      {
+        err = writer->close();
+      }
+      else
+      {
+        writer->abort();
+      }
+
+      if(err < 0)
+      {
+        filter->setErrorCondition(-7);
+        QString ss = QObject::tr("Failed to write image. %1").arg(writer->getErrorMessage());
+        filter->notifyErrorMessage(filter->getHumanLabel(), ss, filter->getErrorCondition());
+      }
+    }
+
   private:
     WriteImagePrivate(const WriteImagePrivate&); // Copy Constructor Not Implemented
     void operator=(const WriteImagePrivate&);    // Move assignment Not Implemented
@@ -174,6 +262,7 @@ class WriteImagePrivate
 ItkWriteImage::ItkWriteImage()
 : m_SelectedCellArrayPath("", "", "")
 , m_OutputFileName("")
+, m_WriterMode(k_ItkImageWriter)
 , m_SelectedCellArray(nullptr)
 {
 }
@@ -195,6 +284,20 @@ void ItkWriteImage::setupFilterParameters()
     parameters.push_back(SIMPL_NEW_DA_SELECTION_FP("Color Data", SelectedCellArrayPath, FilterParameter::RequiredArray, ItkWriteImage, req));
   }
   parameters.push_back(SIMPL_NEW_OUTPUT_FILE_FP("Output File Name", OutputFileName, FilterParameter::Parameter, ItkWriteImage, "*.tif", "TIFF"));
+  {
+    ChoiceFilterParameter::Pointer parameter = ChoiceFilterParameter::New();
+    parameter->setHumanLabel("Writer Mode");
+    parameter->setPropertyName("WriterMode");
+    parameter->setSetterCallback(SIMPL_BIND_SETTER(ItkWriteImage, this, WriterMode));
+    parameter->setGetterCallback(SIMPL_BIND_GETTER(ItkWriteImage, this, WriterMode));
+
+    QVector<QString> choices;
+    choices.push_back("ITK Image Writer");
+    choices.push_back("Tiled TIFF (Parallel Deflate)");
+    parameter->setChoices(choices);
+    parameter->setCategory(FilterParameter::Parameter);
+    parameters.push_back(parameter);
+  }
   setFilterParameters(parameters);
 }
 
@@ -206,6 +309,7 @@ void ItkWriteImage::readFilterParameters(AbstractFilterParametersReader* reader,
   reader->openFilterGroup(this, index);
   setSelectedCellArrayPath( reader->readDataArrayPath( "SelectedCellArrayPath", getSelectedCellArrayPath() ) );
   setOutputFileName( reader->readString( "OutputFileName", getOutputFileName() ) );
+  setWriterMode( reader->readValue( "WriterMode", getWriterMode() ) );
   reader->closeFilterGroup();
 }
 
@@ -227,6 +331,18 @@ void ItkWriteImage::dataCheck()
 
   FileSystemPathHelper::CheckOutputFile(this, "Image Output File", getOutputFileName(), true);
 
+  if(k_ChunkedTiff == getWriterMode())
+  {
+    QString suffix = QFileInfo(getOutputFileName()).suffix().toLower();
+    if(suffix != "tif" && suffix != "tiff")
+    {
+      QString message = QObject::tr("The tiled TIFF writer mode needs an output file with a .tif or .tiff extension");
+      setErrorCondition(-104);
+      notifyErrorMessage(getHumanLabel(), message, getErrorCondition());
+      return;
+    }
+  }
+
   //pass empty dimensions to allow any size
   QVector<size_t> compDims;
   m_SelectedCellArrayPtr = TemplateHelpers::GetPrereqArrayFromPath()(this, getSelectedCellArrayPath(), compDims);
@@ -236,6 +352,18 @@ void ItkWriteImage::dataCheck()
   }
   if(getErrorCondition() < 0) { return; }
 
+  if(k_ChunkedTiff == getWriterMode())
+  {
+    size_t numComp = m_SelectedCellArrayPtr.lock()->getNumberOfComponents();
+    if(numComp != 1 && numComp != 3 && numComp != 4)
+    {
+      QString message = QObject::tr("The tiled TIFF writer mode needs an array with 1, 3 or 4 components but '%1' has %2").arg(getSelectedCellArrayPath().getDataArrayName()).arg(numComp);
+      setErrorCondition(-105);
+      notifyErrorMessage(getHumanLabel(), message, getErrorCondition());
+      return;
+    }
+  }
+
   getDataContainerArray()->getPrereqGeometryFromDataContainer<ImageGeom, AbstractFilter>(this, getSelectedCellArrayPath().getDataContainerName());
   // Ignore returning from the dataCheck if this errors out. We are just trying to
   // ensure an ImageGeometry is selected. If code is added below that starts depending
@@ -307,43 +435,43 @@ void ItkWriteImage::execute()
 
   if(WriteImagePrivate<int8_t>()(inputData))
   {
-    WriteImagePrivate<int8_t>::Execute(this, m, attrMatName, inputData, m_OutputFileName);
+    WriteImagePrivate<int8_t>::Write(this, m, attrMatName, inputData, m_OutputFileName, m_WriterMode);
   }
   else if(WriteImagePrivate<uint8_t>()(inputData) )
   {
-    WriteImagePrivate<uint8_t>::Execute(this, m, attrMatName, inputData, m_OutputFileName);
+    WriteImagePrivate<uint8_t>::Write(this, m, attrMatName, inputData, m_OutputFileName, m_WriterMode);
   }
   else if(WriteImagePrivate<int16_t>()(inputData) )
   {
-    WriteImagePrivate<int16_t>::Execute(this, m, attrMatName, inputData, m_OutputFileName);
+    WriteImagePrivate<int16_t>::Write(this, m, attrMatName, inputData, m_OutputFileName, m_WriterMode);
   }
   else if(WriteImagePrivate<uint16_t>()(inputData) )
   {
-    WriteImagePrivate<uint16_t>::Execute(this, m, attrMatName, inputData, m_OutputFileName);
+    WriteImagePrivate<uint16_t>::Write(this, m, attrMatName, inputData, m_OutputFileName, m_WriterMode);
   }
   else if(WriteImagePrivate<int32_t>()(inputData) )
   {
-    WriteImagePrivate<int32_t>::Execute(this, m, attrMatName, inputData, m_OutputFileName);
+    WriteImagePrivate<int32_t>::Write(this, m, attrMatName, inputData, m_OutputFileName, m_WriterMode);
   }
   else if(WriteImagePrivate<uint32_t>()(inputData) )
   {
-    WriteImagePrivate<uint32_t>::Execute(this, m, attrMatName, inputData, m_OutputFileName);
+    WriteImagePrivate<uint32_t>::Write(this, m, attrMatName, inputData, m_OutputFileName, m_WriterMode);
   }
   else if(WriteImagePrivate<int64_t>()(inputData) )
   {
-    WriteImagePrivate<int64_t>::Execute(this, m, attrMatName, inputData, m_OutputFileName);
+    WriteImagePrivate<int64_t>::Write(this, m, attrMatName, inputData, m_OutputFileName, m_WriterMode);
   }
   else if(WriteImagePrivate<uint64_t>()(inputData) )
   {
-    WriteImagePrivate<uint64_t>::Execute(this, m, attrMatName, inputData, m_OutputFileName);
+    WriteImagePrivate<uint64_t>::Write(this, m, attrMatName, inputData, m_OutputFileName, m_WriterMode);
   }
   else if(WriteImagePrivate<float>()(inputData) )
   {
-    WriteImagePrivate<float>::Execute(this, m, attrMatName, inputData, m_OutputFileName);
+    WriteImagePrivate<float>::Write(this, m, attrMatName, inputData, m_OutputFileName, m_WriterMode);
   }
   else if(WriteImagePrivate<double>()(inputData) )
   {
-    WriteImagePrivate<double>::Execute(this, m, attrMatName, inputData, m_OutputFileName);
+    WriteImagePrivate<double>::Write(this, m, attrMatName, inputData, m_OutputFileName, m_WriterMode);
   }
   else
   {
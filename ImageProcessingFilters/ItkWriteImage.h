@@ -58,6 +58,7 @@ class ImageProcessing_EXPORT ItkWriteImage : public AbstractFilter
     PYB11_CREATE_BINDINGS(ItkWriteImage SUPERCLASS AbstractFilter)
     PYB11_PROPERTY(DataArrayPath SelectedCellArrayPath READ getSelectedCellArrayPath WRITE setSelectedCellArrayPath)
     PYB11_PROPERTY(QString OutputFileName READ getOutputFileName WRITE setOutputFileName)
+    PYB11_PROPERTY(int WriterMode READ getWriterMode WRITE setWriterMode)
 
   public:
     SIMPL_SHARED_POINTERS(ItkWriteImage)
@@ -72,6 +73,9 @@ class ImageProcessing_EXPORT ItkWriteImage : public AbstractFilter
     SIMPL_FILTER_PARAMETER(QString, OutputFileName)
     Q_PROPERTY(QString OutputFileName READ getOutputFileName WRITE setOutputFileName)
 
+    SIMPL_FILTER_PARAMETER(int, WriterMode)
+    Q_PROPERTY(int WriterMode READ getWriterMode WRITE setWriterMode)
+
     /**
      * @brief getCompiledLibraryName Returns the name of the Library that this filter is a part of
      * @return
@@ -85,7 +85,21 @@ endforeach()
 
 #-------------
 # These are files that need to be compiled into the plugin but are NOT filters
+ADD_SIMPL_SUPPORT_CLASS(${ImageProcessing_SOURCE_DIR} ${_filterGroupName} util/BoxMean)
+ADD_SIMPL_SUPPORT_CLASS(${ImageProcessing_SOURCE_DIR} ${_filterGroupName} util/ChunkedTiffWriter)
+ADD_SIMPL_SUPPORT_CLASS(${ImageProcessing_SOURCE_DIR} ${_filterGroupName} util/CorrelationContext)
 ADD_SIMPL_SUPPORT_CLASS(${ImageProcessing_SOURCE_DIR} ${_filterGroupName} util/DetermineStitching)
+ADD_SIMPL_SUPPORT_CLASS(${ImageProcessing_SOURCE_DIR} ${_filterGroupName} util/FusedGaussianBlur)
+ADD_SIMPL_SUPPORT_CLASS(${ImageProcessing_SOURCE_DIR} ${_filterGroupName} util/FusedSobelEdge)
+ADD_SIMPL_SUPPORT_CLASS(${ImageProcessing_SOURCE_DIR} ${_filterGroupName} util/HistogramCache)
+ADD_SIMPL_SUPPORT_CLASS(${ImageProcessing_SOURCE_DIR} ${_filterGroupName} util/MosaicCompositor)
+ADD_SIMPL_SUPPORT_CLASS(${ImageProcessing_SOURCE_DIR} ${_filterGroupName} util/SlidingHistogramMedian)
+ADD_SIMPL_SUPPORT_CLASS(${ImageProcessing_SOURCE_DIR} ${_filterGroupName} util/TiledTiffWriter)
+ADD_SIMPL_SUPPORT_HEADER(${ImageProcessing_SOURCE_DIR} ${_filterGroupName} util/ItkSliceView.hpp)
+ADD_SIMPL_SUPPORT_HEADER(${ImageProcessing_SOURCE_DIR} ${_filterGroupName} util/LinearRescale.hpp)
+ADD_SIMPL_SUPPORT_HEADER(${ImageProcessing_SOURCE_DIR} ${_filterGroupName} util/LookupTableThreshold.hpp)
+ADD_SIMPL_SUPPORT_HEADER(${ImageProcessing_SOURCE_DIR} ${_filterGroupName} util/SliceExecutor.hpp)
+ADD_SIMPL_SUPPORT_HEADER(${ImageProcessing_SOURCE_DIR} ${_filterGroupName} util/TileView.hpp)
 
 #---------------------
 # This macro must come last after we are done adding all the filters and support files.
@@ -0,0 +1,503 @@
+/* ============================================================================
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the names of any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#include "BoxMean.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QObject>
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/task_scheduler_init.h>
+#endif
+
+#include "ImageProcessing/ImageProcessingFilters/util/LinearRescale.hpp"
+
+namespace
+{
+// Volumes with fewer slices than this are split into bands of rows, so every core gets work
+const size_t k_MinSlicesWithoutBands = 32;
+const size_t k_RowsPerBand = 64;
+
+/**
+ * @brief ClampIndex Maps an index outside of [0, size) onto the nearest boundary voxel
+ */
+inline size_t ClampIndex(int64_t index, size_t size)
+{
+  return static_cast<size_t>(std::min(std::max(index, int64_t(0)), static_cast<int64_t>(size) - 1));
+}
+
+/**
+ * @brief AddWindow Calls add(index, weight) for every distinct index of the clamped window [center - radius,
+ * center + radius] of an axis of the given size, weight being the number of times the window repeats that index
+ */
+template <typename AddFunction>
+void AddWindow(size_t center, size_t radius, size_t size, AddFunction add)
+{
+  const int64_t c = static_cast<int64_t>(center);
+  const int64_t r = static_cast<int64_t>(radius);
+  const size_t first = ClampIndex(c - r, size);
+  const size_t last = ClampIndex(c + r, size);
+  for(size_t i = first; i <= last; i++)
+  {
+    uint64_t weight = 1;
+    if(i == 0)
+    {
+      weight += static_cast<uint64_t>(std::max(r - c, int64_t(0)));
+    }
+    if(i == size - 1)
+    {
+      weight += static_cast<uint64_t>(std::max(c + r - static_cast<int64_t>(i), int64_t(0)));
+    }
+    add(i, weight);
+  }
+}
+
+/**
+ * @brief The BoxSumScratch struct holds the buffers of BoxSums, so a thread can reuse them for all of its bands
+ */
+struct BoxSumScratch
+{
+  std::vector<uint64_t> rowSums;
+  std::vector<uint64_t> planeSums;
+  std::vector<uint64_t> runningRow;
+  std::vector<uint64_t> runningPlane;
+};
+
+/**
+ * @brief The ScratchPool class hands every thread its own BoxSumScratch
+ */
+class ScratchPool
+{
+  public:
+    BoxSumScratch& local()
+    {
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+      return m_ThreadScratch.local();
+#else
+      return m_Scratch;
+#endif
+    }
+
+  private:
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    tbb::enumerable_thread_specific<BoxSumScratch> m_ThreadScratch;
+#else
+    BoxSumScratch m_Scratch;
+#endif
+};
+
+/**
+ * @brief The BoxSums class computes the box sums of rows [yStart, yEnd) of consecutive z slices one slice at a time
+ */
+class BoxSums
+{
+  public:
+    BoxSums(const uint8_t* input, const size_t* dims, const size_t* radius, size_t yStart, size_t yEnd, BoxSumScratch& scratch)
+    : m_Input(input)
+    , m_Dims(dims)
+    , m_Radius(radius)
+    , m_YStart(yStart)
+    , m_YEnd(yEnd)
+    , m_RowStart(ClampIndex(static_cast<int64_t>(yStart) - static_cast<int64_t>(radius[1]), dims[1]))
+    , m_RowSums(scratch.rowSums)
+    , m_PlaneSums(scratch.planeSums)
+    , m_RunningRow(scratch.runningRow)
+    , m_RunningPlane(scratch.runningPlane)
+    {
+      const size_t rowEnd = ClampIndex(static_cast<int64_t>(yEnd - 1 + radius[1]), dims[1]) + 1;
+      const size_t bandSize = (yEnd - yStart) * dims[0];
+      m_RowSums.resize((rowEnd - m_RowStart) * dims[0]);
+      m_PlaneSums.resize(bandSize);
+      m_RunningRow.resize(dims[0]);
+      m_RunningPlane.resize(bandSize);
+    }
+
+    /**
+     * @brief sweep Calls function(z, sums) for every slice z of [zStart, zEnd) with the box sums of the rows of that slice
+     */
+    template <typename SliceFunction>
+    void sweep(size_t zStart, size_t zEnd, SliceFunction function)
+    {
+      const int64_t rz = static_cast<int64_t>(m_Radius[2]);
+      const size_t bandSize = m_RunningPlane.size();
+      std::fill(m_RunningPlane.begin(), m_RunningPlane.end(), 0);
+
+      // the window of zStart, with every distinct slice summed once
+      AddWindow(zStart, m_Radius[2], m_Dims[2], [&](size_t s, uint64_t weight) {
+        sumPlane(s);
+        for(size_t i = 0; i < bandSize; i++)
+        {
+          m_RunningPlane[i] += weight * m_PlaneSums[i];
+        }
+      });
+
+      for(size_t z = zStart; z < zEnd; z++)
+      {
+        function(z, m_RunningPlane.data());
+        if(z + 1 == zEnd)
+        {
+          break;
+        }
+
+        // slide the window, the plane entering it is added before the plane leaving it is subtracted
+        const size_t entering = ClampIndex(static_cast<int64_t>(z) + rz + 1, m_Dims[2]);
+        const size_t leaving = ClampIndex(static_cast<int64_t>(z) - rz, m_Dims[2]);
+        if(entering == leaving)
+        {
+          continue;
+        }
+        sumPlane(entering);
+        for(size_t i = 0; i < bandSize; i++)
+        {
+          m_RunningPlane[i] += m_PlaneSums[i];
+        }
+        sumPlane(leaving);
+        for(size_t i = 0; i < bandSize; i++)
+        {
+          m_RunningPlane[i] -= m_PlaneSums[i];
+        }
+      }
+    }
+
+  private:
+    const uint8_t* m_Input;
+    const size_t* m_Dims;
+    const size_t* m_Radius;
+    size_t m_YStart;
+    size_t m_YEnd;
+    size_t m_RowStart;
+    std::vector<uint64_t>& m_RowSums;
+    std::vector<uint64_t>& m_PlaneSums;
+    std::vector<uint64_t>& m_RunningRow;
+    std::vector<uint64_t>& m_RunningPlane;
+
+    /**
+     * @brief sumPlane Writes the x and y box sums of the band rows of slice z into m_PlaneSums
+     */
+    void sumPlane(size_t z)
+    {
+      const size_t dimX = m_Dims[0];
+      const size_t dimY = m_Dims[1];
+      const int64_t rx = static_cast<int64_t>(m_Radius[0]);
+      const int64_t ry = static_cast<int64_t>(m_Radius[1]);
+      const size_t numRows = m_RowSums.size() / dimX;
+
+      // running sums along x of the band rows and the rows the y kernel reaches beyond them
+      for(size_t r = 0; r < numRows; r++)
+      {
+        const uint8_t* row = m_Input + (z * dimY + m_RowStart + r) * dimX;
+        uint64_t* rowSums = m_RowSums.data() + r * dimX;
+        uint64_t sum = 0;
+        AddWindow(0, m_Radius[0], dimX, [&](size_t i, uint64_t weight) { sum += weight * row[i]; });
+        for(size_t x = 0; x < dimX; x++)
+        {
+          rowSums[x] = sum;
+          sum += row[ClampIndex(static_cast<int64_t>(x) + rx + 1, dimX)];
+          sum -= row[ClampIndex(static_cast<int64_t>(x) - rx, dimX)];
+        }
+      }
+
+      // running sums of whole rows along y
+      std::fill(m_RunningRow.begin(), m_RunningRow.end(), 0);
+      AddWindow(m_YStart, m_Radius[1], dimY, [&](size_t i, uint64_t weight) {
+        const uint64_t* rowSums = m_RowSums.data() + (i - m_RowStart) * dimX;
+        for(size_t x = 0; x < dimX; x++)
+        {
+          m_RunningRow[x] += weight * rowSums[x];
+        }
+      });
+      for(size_t y = m_YStart; y < m_YEnd; y++)
+      {
+        std::copy(m_RunningRow.begin(), m_RunningRow.end(), m_PlaneSums.begin() + (y - m_YStart) * dimX);
+        const size_t entering = ClampIndex(static_cast<int64_t>(y) + ry + 1, dimY);
+        const size_t leaving = ClampIndex(static_cast<int64_t>(y) - ry, dimY);
+        if(y + 1 == m_YEnd || entering == leaving)
+        {
+          continue;
+        }
+        const uint64_t* enteringSums = m_RowSums.data() + (entering - m_RowStart) * dimX;
+        const uint64_t* leavingSums = m_RowSums.data() + (leaving - m_RowStart) * dimX;
+        for(size_t x = 0; x < dimX; x++)
+        {
+          m_RunningRow[x] += enteringSums[x];
+          m_RunningRow[x] -= leavingSums[x];
+        }
+      }
+    }
+};
+
+/**
+ * @brief SweepBands Calls function(z, yStart, yEnd, sums) for the work items [start, end). Work item i covers rows
+ * [(i / depth) * bandRows, ...) of slice i % depth, so a range of work items is a run of consecutive slices of one band
+ * or more.
+ */
+template <typename SliceFunction>
+void SweepBands(const uint8_t* input, const size_t* dims, const size_t* radius, size_t bandRows, ScratchPool& scratchPool, size_t start, size_t end, SliceFunction function)
+{
+  const size_t depth = dims[2];
+  BoxSumScratch& scratch = scratchPool.local();
+  for(size_t runStart = start; runStart < end;)
+  {
+    const size_t band = runStart / depth;
+    const size_t runEnd = std::min(end, (band + 1) * depth);
+    const size_t yStart = band * bandRows;
+    const size_t yEnd = std::min(yStart + bandRows, dims[1]);
+    BoxSums boxSums(input, dims, radius, yStart, yEnd, scratch);
+    boxSums.sweep(runStart - band * depth, runEnd - band * depth, [&](size_t z, const uint64_t* sums) { function(z, yStart, yEnd, sums); });
+    runStart = runEnd;
+  }
+}
+
+/**
+ * @brief The FindRangeImpl class finds the smallest and largest box sum of a range of work items
+ */
+class FindRangeImpl
+{
+  public:
+    FindRangeImpl(const uint8_t* input, const size_t* dims, const size_t* radius, size_t bandRows, ScratchPool& scratchPool, uint64_t& minimum, uint64_t& maximum, QMutex& mutex)
+    : m_Input(input)
+    , m_Dims(dims)
+    , m_Radius(radius)
+    , m_BandRows(bandRows)
+    , m_ScratchPool(scratchPool)
+    , m_Minimum(minimum)
+    , m_Maximum(maximum)
+    , m_Mutex(mutex)
+    {
+    }
+
+    void convert(size_t start, size_t end) const
+    {
+      uint64_t minimum = std::numeric_limits<uint64_t>::max();
+      uint64_t maximum = 0;
+      SweepBands(m_Input, m_Dims, m_Radius, m_BandRows, m_ScratchPool, start, end, [&](size_t, size_t yStart, size_t yEnd, const uint64_t* sums) {
+        for(size_t i = 0; i < (yEnd - yStart) * m_Dims[0]; i++)
+        {
+          minimum = std::min(minimum, sums[i]);
+          maximum = std::max(maximum, sums[i]);
+        }
+      });
+
+      QMutexLocker lock(&m_Mutex);
+      m_Minimum = std::min(m_Minimum, minimum);
+      m_Maximum = std::max(m_Maximum, maximum);
+    }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    void operator()(const tbb::blocked_range<size_t>& r) const
+    {
+      convert(r.begin(), r.end());
+    }
+#endif
+
+  private:
+    const uint8_t* m_Input;
+    const size_t* m_Dims;
+    const size_t* m_Radius;
+    size_t m_BandRows;
+    ScratchPool& m_ScratchPool;
+    uint64_t& m_Minimum;
+    uint64_t& m_Maximum;
+    QMutex& m_Mutex;
+};
+
+/**
+ * @brief The WriteMeanImpl class writes the means of a range of work items, rescaled or rounded
+ */
+class WriteMeanImpl
+{
+  public:
+    WriteMeanImpl(const uint8_t* input, uint8_t* output, const size_t* dims, const size_t* radius, size_t bandRows, ScratchPool& scratchPool, uint64_t kernelSize,
+                  const LinearRescale<uint8_t>* rescale)
+    : m_Input(input)
+    , m_Output(output)
+    , m_Dims(dims)
+    , m_Radius(radius)
+    , m_BandRows(bandRows)
+    , m_ScratchPool(scratchPool)
+    , m_KernelSize(kernelSize)
+    , m_Rescale(rescale)
+    {
+    }
+
+    void convert(size_t start, size_t end) const
+    {
+      const double kernelSize = static_cast<double>(m_KernelSize);
+      SweepBands(m_Input, m_Dims, m_Radius, m_BandRows, m_ScratchPool, start, end, [&](size_t z, size_t yStart, size_t yEnd, const uint64_t* sums) {
+        const size_t bandSize = (yEnd - yStart) * m_Dims[0];
+        uint8_t* output = m_Output + (z * m_Dims[1] + yStart) * m_Dims[0];
+        if(nullptr != m_Rescale)
+        {
+          for(size_t i = 0; i < bandSize; i++)
+          {
+            output[i] = (*m_Rescale)(static_cast<double>(sums[i]) / kernelSize);
+          }
+        }
+        else
+        {
+          for(size_t i = 0; i < bandSize; i++)
+          {
+            output[i] = static_cast<uint8_t>((sums[i] + m_KernelSize / 2) / m_KernelSize);
+          }
+        }
+      });
+    }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    void operator()(const tbb::blocked_range<size_t>& r) const
+    {
+      convert(r.begin(), r.end());
+    }
+#endif
+
+  private:
+    const uint8_t* m_Input;
+    uint8_t* m_Output;
+    const size_t* m_Dims;
+    const size_t* m_Radius;
+    size_t m_BandRows;
+    ScratchPool& m_ScratchPool;
+    uint64_t m_KernelSize;
+    const LinearRescale<uint8_t>* m_Rescale;
+};
+
+/**
+ * @brief FilterBands Runs a band filter over all work items, bands of bandRows rows of every z slice
+ */
+template <typename BandFilter>
+void FilterBands(const BandFilter& bandFilter, const size_t dims[3], size_t bandRows, size_t radiusZ)
+{
+  const size_t numItems = dims[2] * ((dims[1] + bandRows - 1) / bandRows);
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  tbb::task_scheduler_init init;
+  bool doParallel = true;
+#endif
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  if(doParallel)
+  {
+    // every run of slices first sums the up to 2 radiusZ + 1 slices of its starting window, runs of about radiusZ
+    // slices keep that below the cost of sliding through the run while still giving every thread a run
+    const size_t numThreads = static_cast<size_t>(std::max(tbb::task_scheduler_init::default_num_threads(), 1));
+    const size_t grainSize = std::max<size_t>(std::min(radiusZ, (numItems + numThreads - 1) / numThreads), 1);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, numItems, grainSize), bandFilter, tbb::auto_partitioner());
+  }
+  else
+#endif
+  {
+    bandFilter.convert(0, numItems);
+  }
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+BoxMean::BoxMean() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+BoxMean::~BoxMean() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void BoxMean::setRescale(bool rescale)
+{
+  m_Rescale = rescale;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool BoxMean::getRescale() const
+{
+  return m_Rescale;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString BoxMean::getErrorMessage() const
+{
+  return m_ErrorMessage;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int BoxMean::execute(const uint8_t* input, uint8_t* output, const size_t dims[3], const size_t radius[3])
+{
+  if(nullptr == input || nullptr == output || input == output)
+  {
+    m_ErrorMessage = QObject::tr("The mean filter needs separate input and output buffers");
+    return -1;
+  }
+  // 255 times the kernel size has to fit the 64 bit sums
+  const double kernelVolume = (2.0 * radius[0] + 1.0) * (2.0 * radius[1] + 1.0) * (2.0 * radius[2] + 1.0);
+  if(kernelVolume > static_cast<double>(1ULL << 48))
+  {
+    m_ErrorMessage = QObject::tr("The mean kernel of radius %1 x %2 x %3 is too large").arg(radius[0]).arg(radius[1]).arg(radius[2]);
+    return -2;
+  }
+  if(dims[0] == 0 || dims[1] == 0 || dims[2] == 0)
+  {
+    return 0;
+  }
+  const uint64_t kernelSize = static_cast<uint64_t>(kernelVolume);
+  const size_t bandRows = (dims[2] < k_MinSlicesWithoutBands) ? k_RowsPerBand : dims[1];
+  ScratchPool scratchPool;
+
+  if(!m_Rescale)
+  {
+    FilterBands(WriteMeanImpl(input, output, dims, radius, bandRows, scratchPool, kernelSize, nullptr), dims, bandRows, radius[2]);
+    return 0;
+  }
+
+  uint64_t minimum = std::numeric_limits<uint64_t>::max();
+  uint64_t maximum = 0;
+  QMutex rangeMutex;
+  FilterBands(FindRangeImpl(input, dims, radius, bandRows, scratchPool, minimum, maximum, rangeMutex), dims, bandRows, radius[2]);
+
+  const LinearRescale<uint8_t> rescale(static_cast<double>(minimum) / kernelVolume, static_cast<double>(maximum) / kernelVolume, 0, 255);
+  FilterBands(WriteMeanImpl(input, output, dims, radius, bandRows, scratchPool, kernelSize, &rescale), dims, bandRows, radius[2]);
+  return 0;
+}
@@ -0,0 +1,89 @@
+/* ============================================================================
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the names of any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#pragma once
+
+#include <cstdint>
+
+#include <QtCore/QString>
+
+#include "SIMPLib/Common/SIMPLibSetGetMacros.h"
+#include "SIMPLib/SIMPLib.h"
+
+/**
+ * @brief The BoxMean class is a box mean filter for 8 bit volumes whose cost does not depend on the kernel size.
+ * Voxels outside of the volume repeat the nearest boundary voxel, as in itk::MeanImageFilter.
+ *
+ * The box sums are separable running sums in 64 bit integers: every row is summed along x, the rows of a plane are
+ * summed along y and a running plane of sums slides along z by adding the plane entering the kernel and subtracting
+ * the plane leaving it. The volume is split into runs of z slices that are filtered in parallel, volumes with few slices
+ * also into bands of rows. Every thread reuses its sum buffers for all of its runs. By default the means are
+ * rescaled onto [0, 255] like a following itk::RescaleIntensityImageFilter, which takes a first sweep to find the range
+ * of the box sums; without rescaling the rounded means are written in a single sweep.
+ */
+class BoxMean
+{
+  public:
+    SIMPL_SHARED_POINTERS(BoxMean)
+    SIMPL_STATIC_NEW_MACRO(BoxMean)
+
+    virtual ~BoxMean();
+
+    /**
+     * @brief setRescale Sets whether the means are rescaled onto [0, 255] (the default) or written rounded
+     */
+    void setRescale(bool rescale);
+    bool getRescale() const;
+
+    /**
+     * @brief execute Writes the mean of the box around every voxel of input into output
+     * @param input Row major volume of dims[0] x dims[1] x dims[2] voxels
+     * @param output Buffer of the same size as input, must not overlap it
+     * @param dims Volume dimensions
+     * @param radius Kernel radius along x, y and z
+     * @return 0 on success, a negative value otherwise. See getErrorMessage()
+     */
+    int execute(const uint8_t* input, uint8_t* output, const size_t dims[3], const size_t radius[3]);
+
+    QString getErrorMessage() const;
+
+  protected:
+    BoxMean();
+
+  private:
+    bool m_Rescale = true;
+    QString m_ErrorMessage;
+
+  public:
+    BoxMean(const BoxMean&) = delete; // Copy Constructor Not Implemented
+    BoxMean(BoxMean&&) = delete;      // Move Constructor Not Implemented
+    BoxMean& operator=(const BoxMean&) = delete; // Copy Assignment Not Implemented
+    BoxMean& operator=(BoxMean&&) = delete;      // Move Assignment Not Implemented
+};
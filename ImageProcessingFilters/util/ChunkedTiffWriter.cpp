@@ -0,0 +1,383 @@
+/* ============================================================================
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the names of any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#include "ChunkedTiffWriter.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <QtCore/QFile>
+#include <QtCore/QObject>
+
+#include "itk_tiff.h"
+#include "itk_zlib.h"
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_scheduler_init.h>
+#endif
+
+namespace
+{
+// Stay well below the 4 GB offset limit of a classic TIFF to leave room for the tile tables and tags
+const uint64_t k_ClassicTiffLimit = 0xF0000000ULL;
+
+// Enough tiles per batch to keep all cores busy when the slices are small
+const size_t k_MinTilesPerBatch = 256;
+
+// The page number tag holds 16 bit values
+const size_t k_MaxNumberedPages = 0xFFFF;
+
+/**
+ * @brief The CompressTilesImpl class copies tiles out of consecutive slices, pads edge tiles with 0 and deflate
+ * compresses them. Tile t belongs to slice t / tilesPerSlice.
+ */
+class CompressTilesImpl
+{
+  public:
+    CompressTilesImpl(const uint8_t* slices, size_t width, size_t height, size_t pixelBytes, size_t tileSize, int level, std::vector<std::vector<uint8_t>>& compressedTiles)
+    : m_Slices(slices)
+    , m_Width(width)
+    , m_Height(height)
+    , m_PixelBytes(pixelBytes)
+    , m_TileSize(tileSize)
+    , m_Level(level)
+    , m_CompressedTiles(compressedTiles)
+    {
+    }
+    virtual ~CompressTilesImpl() = default;
+
+    void convert(size_t start, size_t end) const
+    {
+      const size_t tilesAcross = (m_Width + m_TileSize - 1) / m_TileSize;
+      const size_t tilesPerSlice = tilesAcross * ((m_Height + m_TileSize - 1) / m_TileSize);
+      const size_t tileBytes = m_TileSize * m_TileSize * m_PixelBytes;
+      std::vector<uint8_t> tile(tileBytes);
+      for(size_t t = start; t < end; t++)
+      {
+        const uint8_t* slice = m_Slices + (t / tilesPerSlice) * m_Width * m_Height * m_PixelBytes;
+        const size_t sliceTile = t % tilesPerSlice;
+        const size_t x0 = (sliceTile % tilesAcross) * m_TileSize;
+        const size_t y0 = (sliceTile / tilesAcross) * m_TileSize;
+        const size_t copyWidth = std::min(m_TileSize, m_Width - x0);
+        const size_t copyHeight = std::min(m_TileSize, m_Height - y0);
+        if(copyWidth < m_TileSize || copyHeight < m_TileSize)
+        {
+          std::fill(tile.begin(), tile.end(), 0);
+        }
+        for(size_t y = 0; y < copyHeight; y++)
+        {
+          std::memcpy(&tile[y * m_TileSize * m_PixelBytes], slice + ((y0 + y) * m_Width + x0) * m_PixelBytes, copyWidth * m_PixelBytes);
+        }
+
+        // An empty result marks a tile that failed to compress
+        std::vector<uint8_t>& compressed = m_CompressedTiles[t];
+        uLongf compressedSize = compressBound(static_cast<uLong>(tileBytes));
+        compressed.resize(compressedSize);
+        if(compress2(compressed.data(), &compressedSize, tile.data(), static_cast<uLong>(tileBytes), m_Level) != Z_OK)
+        {
+          compressedSize = 0;
+        }
+        compressed.resize(compressedSize);
+      }
+    }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    void operator()(const tbb::blocked_range<size_t>& r) const
+    {
+      convert(r.begin(), r.end());
+    }
+#endif
+
+  private:
+    const uint8_t* m_Slices;
+    size_t m_Width;
+    size_t m_Height;
+    size_t m_PixelBytes;
+    size_t m_TileSize;
+    int m_Level;
+    std::vector<std::vector<uint8_t>>& m_CompressedTiles;
+};
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ChunkedTiffWriter::ChunkedTiffWriter() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ChunkedTiffWriter::~ChunkedTiffWriter()
+{
+  abort();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ChunkedTiffWriter::setCompressionLevel(int level)
+{
+  m_CompressionLevel = std::max(1, std::min(level, 9));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int ChunkedTiffWriter::open(const QString& filePath, size_t width, size_t height, size_t numSlices, size_t samplesPerPixel, size_t bytesPerSample, int sampleFormat, size_t tileSize)
+{
+  abort();
+  m_ErrorMessage.clear();
+
+  if(width == 0 || height == 0 || numSlices == 0 || tileSize == 0 || tileSize % 16 != 0)
+  {
+    m_ErrorMessage = QObject::tr("Invalid tiled TIFF dimensions %1 x %2 x %3 with a tile size of %4").arg(width).arg(height).arg(numSlices).arg(tileSize);
+    return -1;
+  }
+  if((samplesPerPixel != 1 && samplesPerPixel != 3 && samplesPerPixel != 4) || (bytesPerSample != 1 && bytesPerSample != 2 && bytesPerSample != 4 && bytesPerSample != 8) ||
+     (FloatingPoint == sampleFormat && bytesPerSample < 4))
+  {
+    m_ErrorMessage = QObject::tr("Unsupported pixel layout with %1 samples of %2 bytes").arg(samplesPerPixel).arg(bytesPerSample);
+    return -2;
+  }
+
+  // Deflate can not make a tile much larger than it is, so the uncompressed size decides if BigTIFF is needed
+  const uint64_t tilesAcross = (width + tileSize - 1) / tileSize;
+  const uint64_t tilesDown = (height + tileSize - 1) / tileSize;
+  const uint64_t totalBytes = tilesAcross * tilesDown * tileSize * tileSize * samplesPerPixel * bytesPerSample * numSlices;
+  const char* mode = (totalBytes >= k_ClassicTiffLimit) ? "w8" : "w";
+  TIFF* tiff = TIFFOpen(filePath.toLocal8Bit().constData(), mode);
+  if(nullptr == tiff)
+  {
+    m_ErrorMessage = QObject::tr("Could not open '%1' for writing").arg(filePath);
+    return -3;
+  }
+
+  m_Tiff = tiff;
+  m_FilePath = filePath;
+  m_Width = width;
+  m_Height = height;
+  m_NumSlices = numSlices;
+  m_SamplesPerPixel = samplesPerPixel;
+  m_BytesPerSample = bytesPerSample;
+  m_SampleFormat = sampleFormat;
+  m_TileSize = tileSize;
+  m_NextSlice = 0;
+  m_TilesPerSlice = tilesAcross * tilesDown;
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ChunkedTiffWriter::writePageTags()
+{
+  TIFF* tiff = static_cast<TIFF*>(m_Tiff);
+  uint16_t sampleFormat = SAMPLEFORMAT_UINT;
+  if(SignedInteger == m_SampleFormat)
+  {
+    sampleFormat = SAMPLEFORMAT_INT;
+  }
+  else if(FloatingPoint == m_SampleFormat)
+  {
+    sampleFormat = SAMPLEFORMAT_IEEEFP;
+  }
+
+  TIFFSetField(tiff, TIFFTAG_IMAGEWIDTH, static_cast<uint32_t>(m_Width));
+  TIFFSetField(tiff, TIFFTAG_IMAGELENGTH, static_cast<uint32_t>(m_Height));
+  TIFFSetField(tiff, TIFFTAG_BITSPERSAMPLE, static_cast<uint16_t>(m_BytesPerSample * 8));
+  TIFFSetField(tiff, TIFFTAG_SAMPLESPERPIXEL, static_cast<uint16_t>(m_SamplesPerPixel));
+  TIFFSetField(tiff, TIFFTAG_SAMPLEFORMAT, sampleFormat);
+  TIFFSetField(tiff, TIFFTAG_PHOTOMETRIC, (1 == m_SamplesPerPixel) ? PHOTOMETRIC_MINISBLACK : PHOTOMETRIC_RGB);
+  if(4 == m_SamplesPerPixel)
+  {
+    uint16_t extraSamples[1] = { EXTRASAMPLE_UNASSALPHA };
+    TIFFSetField(tiff, TIFFTAG_EXTRASAMPLES, 1, extraSamples);
+  }
+  TIFFSetField(tiff, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+  TIFFSetField(tiff, TIFFTAG_COMPRESSION, COMPRESSION_ADOBE_DEFLATE);
+  TIFFSetField(tiff, TIFFTAG_TILEWIDTH, static_cast<uint32_t>(m_TileSize));
+  TIFFSetField(tiff, TIFFTAG_TILELENGTH, static_cast<uint32_t>(m_TileSize));
+  if(m_NumSlices > 1)
+  {
+    TIFFSetField(tiff, TIFFTAG_SUBFILETYPE, FILETYPE_PAGE);
+  }
+  // Readers fall back to the order of the pages when the number does not fit into the tag
+  if(m_NumSlices > 1 && m_NumSlices <= k_MaxNumberedPages)
+  {
+    TIFFSetField(tiff, TIFFTAG_PAGENUMBER, static_cast<uint16_t>(m_NextSlice), static_cast<uint16_t>(m_NumSlices));
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t ChunkedTiffWriter::getSlicesPerBatch() const
+{
+  if(0 == m_TilesPerSlice)
+  {
+    return 1;
+  }
+  return std::max<size_t>(1, (k_MinTilesPerBatch + m_TilesPerSlice - 1) / m_TilesPerSlice);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int ChunkedTiffWriter::writeSlice(const void* slice)
+{
+  return writeSlices(slice, 1);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int ChunkedTiffWriter::writeSlices(const void* slices, size_t count)
+{
+  if(nullptr == m_Tiff)
+  {
+    m_ErrorMessage = QObject::tr("The tiled TIFF file is not open");
+    return -4;
+  }
+  if(count > m_NumSlices - m_NextSlice)
+  {
+    m_ErrorMessage = QObject::tr("Writing %1 slices after slice %2 exceeds the %3 slices of the file").arg(count).arg(m_NextSlice).arg(m_NumSlices);
+    return -5;
+  }
+
+  // The tiles of all slices are compressed together, so small slices still spread over all cores
+  const size_t numTiles = m_TilesPerSlice * count;
+  if(m_CompressedTiles.size() < numTiles)
+  {
+    m_CompressedTiles.resize(numTiles);
+  }
+  const size_t pixelBytes = m_SamplesPerPixel * m_BytesPerSample;
+  CompressTilesImpl compressor(static_cast<const uint8_t*>(slices), m_Width, m_Height, pixelBytes, m_TileSize, m_CompressionLevel, m_CompressedTiles);
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  tbb::task_scheduler_init init;
+  bool doParallel = true;
+#endif
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  if(doParallel)
+  {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, numTiles), compressor, tbb::auto_partitioner());
+  }
+  else
+#endif
+  {
+    compressor.convert(0, numTiles);
+  }
+
+  // The tiles are already deflate streams, so they are written without passing through the libtiff encoder
+  TIFF* tiff = static_cast<TIFF*>(m_Tiff);
+  for(size_t s = 0; s < count; s++)
+  {
+    writePageTags();
+    for(size_t t = 0; t < m_TilesPerSlice; t++)
+    {
+      std::vector<uint8_t>& compressed = m_CompressedTiles[s * m_TilesPerSlice + t];
+      if(compressed.empty() || TIFFWriteRawTile(tiff, static_cast<uint32_t>(t), compressed.data(), static_cast<tmsize_t>(compressed.size())) < 0)
+      {
+        m_ErrorMessage = QObject::tr("Error writing tile %1 of slice %2").arg(t).arg(m_NextSlice);
+        return -6;
+      }
+    }
+    if(TIFFWriteDirectory(tiff) == 0)
+    {
+      m_ErrorMessage = QObject::tr("Error writing the directory of slice %1").arg(m_NextSlice);
+      return -7;
+    }
+    m_NextSlice++;
+  }
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int ChunkedTiffWriter::close()
+{
+  if(nullptr == m_Tiff)
+  {
+    return 0;
+  }
+
+  int err = 0;
+  if(m_NextSlice != m_NumSlices)
+  {
+    m_ErrorMessage = QObject::tr("Only %1 of %2 slices were written").arg(m_NextSlice).arg(m_NumSlices);
+    err = -8;
+  }
+
+  closeHandle();
+  if(err < 0)
+  {
+    // A file with missing pages would still open as a TIFF, so it is not left behind
+    QFile::remove(m_FilePath);
+  }
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ChunkedTiffWriter::abort()
+{
+  if(nullptr == m_Tiff)
+  {
+    return;
+  }
+  closeHandle();
+  QFile::remove(m_FilePath);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ChunkedTiffWriter::closeHandle()
+{
+  TIFFClose(static_cast<TIFF*>(m_Tiff));
+  m_Tiff = nullptr;
+  m_TilesPerSlice = 0;
+  m_CompressedTiles.clear();
+  m_CompressedTiles.shrink_to_fit();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ChunkedTiffWriter::getErrorMessage() const
+{
+  return m_ErrorMessage;
+}
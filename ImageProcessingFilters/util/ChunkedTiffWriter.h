@@ -0,0 +1,158 @@
+/* ============================================================================
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the names of any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <QtCore/QString>
+
+#include "SIMPLib/Common/SIMPLibSetGetMacros.h"
+#include "SIMPLib/SIMPLib.h"
+
+/**
+ * @brief The ChunkedTiffWriter class writes a volume as a multi-page TIFF with one page per z slice. Every page is
+ * split into square tiles that are deflate compressed in parallel and then written as they are, so compression is not
+ * limited to the single thread of the libtiff encoder. writeSlices() compresses the tiles of several slices at once,
+ * which keeps all cores busy when a single slice has only a few tiles. Files whose pixel data could exceed the size of
+ * a classic TIFF are written as BigTIFF. Pages only carry a page number when there are at most 65535 of them.
+ *
+ * Usage: open(), then writeSlice() or writeSlices() for every z slice from first to last, then close(). A file that is
+ * not completed, because abort() is called, close() fails or the writer is destroyed while the file is still open, is
+ * removed.
+ */
+class ChunkedTiffWriter
+{
+  public:
+    SIMPL_SHARED_POINTERS(ChunkedTiffWriter)
+    SIMPL_STATIC_NEW_MACRO(ChunkedTiffWriter)
+
+    virtual ~ChunkedTiffWriter();
+
+    /**
+     * @brief The SampleFormat enum tells how the bytes of a sample are interpreted
+     */
+    enum SampleFormat
+    {
+      UnsignedInteger = 0,
+      SignedInteger = 1,
+      FloatingPoint = 2
+    };
+
+    /**
+     * @brief open Creates the file
+     * @param filePath
+     * @param width Slice width in pixels
+     * @param height Slice height in pixels
+     * @param numSlices Number of z slices
+     * @param samplesPerPixel 1 for grayscale, 3 for RGB or 4 for RGBA
+     * @param bytesPerSample 1, 2, 4 or 8
+     * @param sampleFormat One of the SampleFormat values
+     * @param tileSize Width and height of the TIFF tiles, must be a multiple of 16
+     * @return 0 on success, a negative value otherwise. See getErrorMessage()
+     */
+    int open(const QString& filePath, size_t width, size_t height, size_t numSlices, size_t samplesPerPixel, size_t bytesPerSample, int sampleFormat, size_t tileSize = 256);
+
+    /**
+     * @brief writeSlice Compresses and writes the next z slice
+     * @param slice Row major pixels of the slice with interleaved samples
+     * @return 0 on success, a negative value otherwise. See getErrorMessage()
+     */
+    int writeSlice(const void* slice);
+
+    /**
+     * @brief writeSlices Compresses and writes the next consecutive z slices
+     * @param slices Row major pixels of the slices with interleaved samples, one slice after the other
+     * @param count Number of slices
+     * @return 0 on success, a negative value otherwise. See getErrorMessage()
+     */
+    int writeSlices(const void* slices, size_t count);
+
+    /**
+     * @brief getSlicesPerBatch Returns how many slices to pass to writeSlices() so there are enough tiles to use all
+     * cores. Only valid after open()
+     */
+    size_t getSlicesPerBatch() const;
+
+    /**
+     * @brief close Flushes and closes the file
+     * @return 0 on success, a negative value otherwise. See getErrorMessage()
+     */
+    int close();
+
+    /**
+     * @brief abort Closes the file without completing it and removes it
+     */
+    void abort();
+
+    /**
+     * @brief setCompressionLevel Sets the zlib compression level from 1 (fastest) to 9 (smallest), 6 by default
+     */
+    void setCompressionLevel(int level);
+
+    QString getErrorMessage() const;
+
+  protected:
+    ChunkedTiffWriter();
+
+  private:
+    void* m_Tiff = nullptr;
+    QString m_FilePath;
+    size_t m_Width = 0;
+    size_t m_Height = 0;
+    size_t m_NumSlices = 0;
+    size_t m_SamplesPerPixel = 0;
+    size_t m_BytesPerSample = 0;
+    int m_SampleFormat = UnsignedInteger;
+    size_t m_TileSize = 0;
+    size_t m_NextSlice = 0;
+    size_t m_TilesPerSlice = 0;
+    int m_CompressionLevel = 6;
+    std::vector<std::vector<uint8_t>> m_CompressedTiles;
+    QString m_ErrorMessage;
+
+    /**
+     * @brief writePageTags Sets the tags of the page for the next slice
+     */
+    void writePageTags();
+
+    /**
+     * @brief closeHandle Closes the libtiff handle and releases the compression buffers
+     */
+    void closeHandle();
+
+  public:
+    ChunkedTiffWriter(const ChunkedTiffWriter&) = delete; // Copy Constructor Not Implemented
+    ChunkedTiffWriter(ChunkedTiffWriter&&) = delete;      // Move Constructor Not Implemented
+    ChunkedTiffWriter& operator=(const ChunkedTiffWriter&) = delete; // Copy Assignment Not Implemented
+    ChunkedTiffWriter& operator=(ChunkedTiffWriter&&) = delete;      // Move Assignment Not Implemented
+};
+
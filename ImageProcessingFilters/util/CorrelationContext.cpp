@@ -0,0 +1,677 @@
+/* ============================================================================
+ * Copyright (c) 2014 Michael A. Jackson (BlueQuartz Software)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of Michael A. Jackson, BlueQuartz Software nor the names of
+ * its contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#include "CorrelationContext.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include "itkImage.h"
+#include "itkMaskedFFTNormalizedCorrelationImageFilter.h"
+#include "itkMinimumMaximumImageCalculator.h"
+
+namespace
+{
+// Downsampled windows smaller than this no longer hold enough structure to find the peak reliably
+const size_t k_MinimumCoarseSize = 16;
+
+// Correlation values within this distance of the peak belong to the peak and are left out of the sidelobe
+const size_t k_SidelobeExclusionRadius = 5;
+
+/**
+ * @brief QuadraticPeakOffset Returns the position of the vertex of the parabola through three equally spaced
+ * values relative to the center one. Returns 0 if the center value is not a maximum.
+ */
+inline double QuadraticPeakOffset(double previous, double center, double next)
+{
+  const double curvature = previous - 2.0 * center + next;
+  if(curvature >= 0.0)
+  {
+    return 0.0;
+  }
+  return std::min(std::max(0.5 * (previous - next) / curvature, -0.5), 0.5);
+}
+
+/**
+ * @brief OverlapLength Returns the number of pixels a fixed and a moving window of the given sizes share along one
+ * axis at output index k, which shifts the moving window by k - (movingSize - 1)
+ */
+inline size_t OverlapLength(size_t k, size_t fixedSize, size_t movingSize)
+{
+  const int64_t shift = static_cast<int64_t>(k) - static_cast<int64_t>(movingSize - 1);
+  const int64_t first = std::max<int64_t>(0, shift);
+  const int64_t last = std::min<int64_t>(static_cast<int64_t>(fixedSize), static_cast<int64_t>(movingSize) + shift);
+  return (last > first) ? static_cast<size_t>(last - first) : 0;
+}
+
+/**
+ * @brief PeakToSidelobeRatio Returns (peak - mean) / standard deviation of the correlation values outside the square of
+ * k_SidelobeExclusionRadius around the peak. Only shifts whose windows overlap by at least
+ * requiredNumberOfOverlappingPixels, the ones the correlation filter computes, are part of the sidelobe. Returns 0 if
+ * the sidelobe is empty or constant.
+ */
+double PeakToSidelobeRatio(const float* values, size_t width, size_t height, size_t fixedWidth, size_t fixedHeight, size_t movingWidth, size_t movingHeight,
+                           double requiredNumberOfOverlappingPixels, size_t peakX, size_t peakY, double peakValue)
+{
+  std::vector<size_t> overlapWidths(width);
+  for(size_t x = 0; x < width; x++)
+  {
+    overlapWidths[x] = OverlapLength(x, fixedWidth, movingWidth);
+  }
+
+  double sum = 0.0;
+  double squaredSum = 0.0;
+  size_t count = 0;
+  for(size_t y = 0; y < height; y++)
+  {
+    const size_t overlapHeight = OverlapLength(y, fixedHeight, movingHeight);
+    const bool nearPeakRow = (y + k_SidelobeExclusionRadius >= peakY && y <= peakY + k_SidelobeExclusionRadius);
+    for(size_t x = 0; x < width; x++)
+    {
+      if(static_cast<double>(overlapWidths[x] * overlapHeight) < requiredNumberOfOverlappingPixels ||
+         (nearPeakRow && x + k_SidelobeExclusionRadius >= peakX && x <= peakX + k_SidelobeExclusionRadius))
+      {
+        continue;
+      }
+      const double value = static_cast<double>(values[y * width + x]);
+      sum += value;
+      squaredSum += value * value;
+      count++;
+    }
+  }
+  if(count < 2)
+  {
+    return 0.0;
+  }
+  const double mean = sum / static_cast<double>(count);
+  const double variance = std::max(squaredSum / static_cast<double>(count) - mean * mean, 0.0);
+  if(variance <= 0.0)
+  {
+    return 0.0;
+  }
+  return (peakValue - mean) / std::sqrt(variance);
+}
+
+/**
+ * @brief CopyWindow Copies a window into the buffer of an image of the same size and marks the image as modified so
+ * the filters reading it run again
+ */
+void CopyWindow(const ImageProcessingConstants::DefaultPixelType* data, size_t stride, size_t width, size_t height, ImageProcessingConstants::DefaultImageType* image)
+{
+  ImageProcessingConstants::DefaultPixelType* buffer = image->GetBufferPointer();
+  for(size_t y = 0; y < height; y++)
+  {
+    std::copy(data + y * stride, data + y * stride + width, buffer + y * width);
+  }
+  image->Modified();
+}
+
+/**
+ * @brief CreateWindowImage Allocates a width x height x 1 image at the origin with unit spacing, the geometry
+ * CropAndCrossCorrelate used to give the cropped windows before handing them to the correlation filter
+ */
+ImageProcessingConstants::DefaultImageType::Pointer CreateWindowImage(size_t width, size_t height)
+{
+  ImageProcessingConstants::DefaultImageType::RegionType region;
+  region.SetIndex(0, 0);
+  region.SetIndex(1, 0);
+  region.SetIndex(2, 0);
+  region.SetSize(0, width);
+  region.SetSize(1, height);
+  region.SetSize(2, 1);
+
+  ImageProcessingConstants::DefaultImageType::Pointer image = ImageProcessingConstants::DefaultImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+  return image;
+}
+
+/**
+ * @brief BuildSummedAreaTables Fills the (width + 1) x (height + 1) tables of the running sums of the pixel
+ * values and of their squares. Row and column 0 are left at 0 so a rectangle sum never needs a bounds check.
+ */
+void BuildSummedAreaTables(const ImageProcessingConstants::DefaultPixelType* data, size_t stride, size_t width, size_t height, std::vector<double>& sums, std::vector<double>& squaredSums)
+{
+  const size_t tableWidth = width + 1;
+  std::fill(sums.begin(), sums.begin() + tableWidth, 0.0);
+  std::fill(squaredSums.begin(), squaredSums.begin() + tableWidth, 0.0);
+  for(size_t y = 0; y < height; y++)
+  {
+    const ImageProcessingConstants::DefaultPixelType* row = data + y * stride;
+    double* sumRow = &sums[(y + 1) * tableWidth];
+    double* squaredSumRow = &squaredSums[(y + 1) * tableWidth];
+    const double* sumRowAbove = &sums[y * tableWidth];
+    const double* squaredSumRowAbove = &squaredSums[y * tableWidth];
+    double rowSum = 0.0;
+    double rowSquaredSum = 0.0;
+    sumRow[0] = 0.0;
+    squaredSumRow[0] = 0.0;
+    for(size_t x = 0; x < width; x++)
+    {
+      const double value = static_cast<double>(row[x]);
+      rowSum += value;
+      rowSquaredSum += value * value;
+      sumRow[x + 1] = sumRowAbove[x + 1] + rowSum;
+      squaredSumRow[x + 1] = squaredSumRowAbove[x + 1] + rowSquaredSum;
+    }
+  }
+}
+
+/**
+ * @brief RectangleSum Returns the sum over [x0, x1) x [y0, y1) from a summed area table
+ */
+inline double RectangleSum(const std::vector<double>& table, size_t tableWidth, size_t x0, size_t y0, size_t x1, size_t y1)
+{
+  return table[y1 * tableWidth + x1] - table[y0 * tableWidth + x1] - table[y1 * tableWidth + x0] + table[y0 * tableWidth + x0];
+}
+
+/**
+ * @brief DotProduct Returns the sum of the products of two rows of 8 bit pixels. The products are summed in 32 bit
+ * chunks that can not overflow, which lets the inner loop vectorize.
+ */
+inline uint64_t DotProduct(const ImageProcessingConstants::DefaultPixelType* first, const ImageProcessingConstants::DefaultPixelType* second, size_t count)
+{
+  const size_t chunkSize = 65536;
+  uint64_t total = 0;
+  for(size_t start = 0; start < count; start += chunkSize)
+  {
+    const size_t end = std::min(count, start + chunkSize);
+    uint32_t partial = 0;
+    for(size_t i = start; i < end; i++)
+    {
+      partial += static_cast<uint32_t>(first[i]) * static_cast<uint32_t>(second[i]);
+    }
+    total += partial;
+  }
+  return total;
+}
+
+/**
+ * @brief The ShiftSearch class evaluates the normalized cross correlation of two windows at single shifts directly in
+ * the spatial domain, with the same overlap rule and precision tolerance as itk::MaskedFFTNormalizedCorrelationImageFilter.
+ * A shift (tx, ty) places the moving window at (tx, ty) in the fixed window, which is output index
+ * (tx + movingWidth - 1, ty + movingHeight - 1).
+ */
+class ShiftSearch
+{
+public:
+  ShiftSearch(const ImageProcessingConstants::DefaultPixelType* fixed, size_t fixedStride, size_t fixedWidth, size_t fixedHeight, const ImageProcessingConstants::DefaultPixelType* moving,
+              size_t movingStride, size_t movingWidth, size_t movingHeight, double requiredFractionOfOverlappingPixels)
+  : m_Fixed(fixed)
+  , m_FixedStride(fixedStride)
+  , m_FixedWidth(fixedWidth)
+  , m_FixedHeight(fixedHeight)
+  , m_Moving(moving)
+  , m_MovingStride(movingStride)
+  , m_MovingWidth(movingWidth)
+  , m_MovingHeight(movingHeight)
+  , m_FixedSums((fixedWidth + 1) * (fixedHeight + 1))
+  , m_FixedSquaredSums((fixedWidth + 1) * (fixedHeight + 1))
+  , m_MovingSums((movingWidth + 1) * (movingHeight + 1))
+  , m_MovingSquaredSums((movingWidth + 1) * (movingHeight + 1))
+  {
+    BuildSummedAreaTables(fixed, fixedStride, fixedWidth, fixedHeight, m_FixedSums, m_FixedSquaredSums);
+    BuildSummedAreaTables(moving, movingStride, movingWidth, movingHeight, m_MovingSums, m_MovingSquaredSums);
+    m_RequiredNumberOfOverlappingPixels = requiredFractionOfOverlappingPixels * static_cast<double>(std::min(fixedWidth, movingWidth) * std::min(fixedHeight, movingHeight));
+  }
+
+  virtual ~ShiftSearch() = default;
+
+  /**
+   * @brief evaluate Computes the numerator and denominator of the correlation at one shift. Both are 0 when the
+   * windows do not overlap by enough pixels.
+   */
+  void evaluate(int64_t tx, int64_t ty, double& numerator, double& denominator) const
+  {
+    numerator = 0.0;
+    denominator = 0.0;
+    const int64_t x0 = std::max<int64_t>(0, tx);
+    const int64_t x1 = std::min<int64_t>(static_cast<int64_t>(m_FixedWidth), static_cast<int64_t>(m_MovingWidth) + tx);
+    const int64_t y0 = std::max<int64_t>(0, ty);
+    const int64_t y1 = std::min<int64_t>(static_cast<int64_t>(m_FixedHeight), static_cast<int64_t>(m_MovingHeight) + ty);
+    if(x1 <= x0 || y1 <= y0)
+    {
+      return;
+    }
+    const double numberOfOverlappingPixels = static_cast<double>((x1 - x0) * (y1 - y0));
+    if(numberOfOverlappingPixels < m_RequiredNumberOfOverlappingPixels)
+    {
+      return;
+    }
+
+    uint64_t crossSum = 0;
+    const size_t count = static_cast<size_t>(x1 - x0);
+    for(int64_t y = y0; y < y1; y++)
+    {
+      crossSum += DotProduct(m_Fixed + y * m_FixedStride + x0, m_Moving + (y - ty) * m_MovingStride + (x0 - tx), count);
+    }
+
+    const double fixedSum = RectangleSum(m_FixedSums, m_FixedWidth + 1, x0, y0, x1, y1);
+    const double fixedSquaredSum = RectangleSum(m_FixedSquaredSums, m_FixedWidth + 1, x0, y0, x1, y1);
+    const double movingSum = RectangleSum(m_MovingSums, m_MovingWidth + 1, x0 - tx, y0 - ty, x1 - tx, y1 - ty);
+    const double movingSquaredSum = RectangleSum(m_MovingSquaredSums, m_MovingWidth + 1, x0 - tx, y0 - ty, x1 - tx, y1 - ty);
+    const double fixedDenominator = std::max(fixedSquaredSum - fixedSum * fixedSum / numberOfOverlappingPixels, 0.0);
+    const double movingDenominator = std::max(movingSquaredSum - movingSum * movingSum / numberOfOverlappingPixels, 0.0);
+    numerator = static_cast<double>(crossSum) - fixedSum * movingSum / numberOfOverlappingPixels;
+    denominator = std::sqrt(fixedDenominator * movingDenominator);
+  }
+
+  /**
+   * @brief findPeak Finds the best shift within radius of (tx, ty). While the best shift lies on the border of the
+   * searched square the square is moved there and searched again, so a slightly wrong estimate still ends on the peak.
+   * @param tx Starting estimate on input, best shift on output
+   * @param ty Starting estimate on input, best shift on output
+   * @param radius
+   * @return The correlation value at the best shift
+   */
+  double findPeak(int64_t& tx, int64_t& ty, int64_t radius)
+  {
+    const int64_t minX = 1 - static_cast<int64_t>(m_MovingWidth);
+    const int64_t maxX = static_cast<int64_t>(m_FixedWidth) - 1;
+    const int64_t minY = 1 - static_cast<int64_t>(m_MovingHeight);
+    const int64_t maxY = static_cast<int64_t>(m_FixedHeight) - 1;
+    const int k_MaximumMoves = 8;
+
+    std::vector<double> denominators;
+    double peakValue = 0.0;
+    for(int move = 0; move <= k_MaximumMoves; move++)
+    {
+      const int64_t x0 = std::min(std::max(tx - radius, minX), maxX);
+      const int64_t x1 = std::min(std::max(tx + radius, minX), maxX);
+      const int64_t y0 = std::min(std::max(ty - radius, minY), maxY);
+      const int64_t y1 = std::min(std::max(ty + radius, minY), maxY);
+      const size_t searchWidth = static_cast<size_t>(x1 - x0 + 1);
+      m_Values.resize(searchWidth * static_cast<size_t>(y1 - y0 + 1));
+      denominators.resize(m_Values.size());
+      m_SearchX0 = x0;
+      m_SearchY0 = y0;
+      m_SearchWidth = searchWidth;
+      m_SearchHeight = static_cast<size_t>(y1 - y0 + 1);
+
+      double maxDenominator = 0.0;
+      for(int64_t sy = y0; sy <= y1; sy++)
+      {
+        for(int64_t sx = x0; sx <= x1; sx++)
+        {
+          const size_t index = static_cast<size_t>(sy - y0) * searchWidth + static_cast<size_t>(sx - x0);
+          evaluate(sx, sy, m_Values[index], denominators[index]);
+          maxDenominator = std::max(maxDenominator, denominators[index]);
+        }
+      }
+
+      // The tolerance is taken relative to the largest denominator of the searched shifts instead of all shifts
+      double precisionTolerance = 0.0;
+      if(maxDenominator > 0.0)
+      {
+        precisionTolerance = 1000.0 * static_cast<double>(std::numeric_limits<float>::epsilon()) * std::pow(2.0, std::floor(std::log2(maxDenominator)));
+      }
+
+      // The numerators are replaced by the correlation values so subPixelOffset() can look at the neighbours of the peak
+      size_t peakIndex = 0;
+      peakValue = -std::numeric_limits<double>::max();
+      for(size_t index = 0; index < m_Values.size(); index++)
+      {
+        double value = 0.0;
+        if(denominators[index] >= precisionTolerance && denominators[index] > 0.0)
+        {
+          value = static_cast<double>(static_cast<float>(m_Values[index] / denominators[index]));
+        }
+        m_Values[index] = value;
+        if(value > peakValue)
+        {
+          peakValue = value;
+          peakIndex = index;
+        }
+      }
+
+      tx = x0 + static_cast<int64_t>(peakIndex % searchWidth);
+      ty = y0 + static_cast<int64_t>(peakIndex / searchWidth);
+      const bool onBorder = (tx == x0 && x0 > minX) || (tx == x1 && x1 < maxX) || (ty == y0 && y0 > minY) || (ty == y1 && y1 < maxY);
+      if(!onBorder)
+      {
+        break;
+      }
+    }
+    return peakValue;
+  }
+
+  /**
+   * @brief subPixelOffset Fits a parabola along x and one along y through the correlation values at the shift found by
+   * the last findPeak() and its direct neighbours. An offset stays 0 if a neighbour was not searched.
+   */
+  void subPixelOffset(int64_t tx, int64_t ty, double& offsetX, double& offsetY) const
+  {
+    offsetX = 0.0;
+    offsetY = 0.0;
+    const int64_t x = tx - m_SearchX0;
+    const int64_t y = ty - m_SearchY0;
+    const size_t index = static_cast<size_t>(y) * m_SearchWidth + static_cast<size_t>(x);
+    if(x > 0 && x + 1 < static_cast<int64_t>(m_SearchWidth))
+    {
+      offsetX = QuadraticPeakOffset(m_Values[index - 1], m_Values[index], m_Values[index + 1]);
+    }
+    if(y > 0 && y + 1 < static_cast<int64_t>(m_SearchHeight))
+    {
+      offsetY = QuadraticPeakOffset(m_Values[index - m_SearchWidth], m_Values[index], m_Values[index + m_SearchWidth]);
+    }
+  }
+
+private:
+  const ImageProcessingConstants::DefaultPixelType* m_Fixed;
+  size_t m_FixedStride;
+  size_t m_FixedWidth;
+  size_t m_FixedHeight;
+  const ImageProcessingConstants::DefaultPixelType* m_Moving;
+  size_t m_MovingStride;
+  size_t m_MovingWidth;
+  size_t m_MovingHeight;
+  std::vector<double> m_FixedSums;
+  std::vector<double> m_FixedSquaredSums;
+  std::vector<double> m_MovingSums;
+  std::vector<double> m_MovingSquaredSums;
+  double m_RequiredNumberOfOverlappingPixels = 0.0;
+  std::vector<double> m_Values;
+  int64_t m_SearchX0 = 0;
+  int64_t m_SearchY0 = 0;
+  size_t m_SearchWidth = 0;
+  size_t m_SearchHeight = 0;
+};
+} // namespace
+
+/**
+ * @brief The Workspace struct holds the window images and the correlation pipeline for one pair of window sizes
+ */
+struct CorrelationContext::Workspace
+{
+  typedef itk::MaskedFFTNormalizedCorrelationImageFilter<ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::FloatImageType, ImageProcessingConstants::DefaultImageType>
+      XCFilterType;
+  typedef itk::MinimumMaximumImageCalculator<ImageProcessingConstants::FloatImageType> MinMaxCalculatorType;
+
+  Workspace(const WindowKey& key)
+  : fixedImage(CreateWindowImage(key[0], key[1]))
+  , movingImage(CreateWindowImage(key[2], key[3]))
+  , xCorrFilter(XCFilterType::New())
+  , calculator(MinMaxCalculatorType::New())
+  {
+    xCorrFilter->SetFixedImage(fixedImage);
+    xCorrFilter->SetMovingImage(movingImage);
+  }
+
+  ImageProcessingConstants::DefaultImageType::Pointer fixedImage;
+  ImageProcessingConstants::DefaultImageType::Pointer movingImage;
+  XCFilterType::Pointer xCorrFilter;
+  MinMaxCalculatorType::Pointer calculator;
+};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+CorrelationContext::CorrelationContext() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void CorrelationContext::setSubPixelPeak(bool subPixelPeak)
+{
+  m_SubPixelPeak = subPixelPeak;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool CorrelationContext::getSubPixelPeak() const
+{
+  return m_SubPixelPeak;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+CorrelationContext::~CorrelationContext() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+std::unique_ptr<CorrelationContext::Workspace> CorrelationContext::checkOutWorkspace(const WindowKey& key)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    std::vector<std::unique_ptr<Workspace>>& freeList = m_FreeWorkspaces[key];
+    if(!freeList.empty())
+    {
+      std::unique_ptr<Workspace> workspace = std::move(freeList.back());
+      freeList.pop_back();
+      return workspace;
+    }
+  }
+
+  // Allocating happens outside of the lock so other threads can keep checking out workspaces
+  return std::unique_ptr<Workspace>(new Workspace(key));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void CorrelationContext::returnWorkspace(const WindowKey& key, std::unique_ptr<Workspace> workspace)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_FreeWorkspaces[key].push_back(std::move(workspace));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+std::vector<float> CorrelationContext::correlate(const ImageProcessingConstants::DefaultPixelType* fixed, size_t fixedStride, size_t fixedWidth, size_t fixedHeight,
+                                                 const ImageProcessingConstants::DefaultPixelType* moving, size_t movingStride, size_t movingWidth, size_t movingHeight,
+                                                 double requiredFractionOfOverlappingPixels)
+{
+  std::vector<float> newXYOrigin(4, 0);
+  if(fixedWidth == 0 || fixedHeight == 0 || movingWidth == 0 || movingHeight == 0)
+  {
+    return newXYOrigin;
+  }
+
+  const WindowKey key = {{fixedWidth, fixedHeight, movingWidth, movingHeight}};
+  std::unique_ptr<Workspace> ws = checkOutWorkspace(key);
+  CopyWindow(fixed, fixedStride, fixedWidth, fixedHeight, ws->fixedImage);
+  CopyWindow(moving, movingStride, movingWidth, movingHeight, ws->movingImage);
+
+  //CROSS CORRELATE THE 2 WINDOWS.
+  ws->xCorrFilter->SetRequiredFractionOfOverlappingPixels(requiredFractionOfOverlappingPixels);
+  ws->xCorrFilter->Update();
+  ImageProcessingConstants::FloatImageType* xcoutputImage = ws->xCorrFilter->GetOutput();
+
+  // The first maximum in raster order wins
+  ws->calculator->SetImage(xcoutputImage);
+  ws->calculator->Compute();
+  const size_t peakX = static_cast<size_t>(ws->calculator->GetIndexOfMaximum()[0]);
+  const size_t peakY = static_cast<size_t>(ws->calculator->GetIndexOfMaximum()[1]);
+  const double peakValue = static_cast<double>(ws->calculator->GetMaximum());
+
+  const size_t outputWidth = xcoutputImage->GetLargestPossibleRegion().GetSize()[0];
+  const size_t outputHeight = xcoutputImage->GetLargestPossibleRegion().GetSize()[1];
+  const float* values = xcoutputImage->GetBufferPointer();
+  const size_t peakIndex = peakY * outputWidth + peakX;
+  double offsetX = 0.0;
+  double offsetY = 0.0;
+  if(m_SubPixelPeak)
+  {
+    if(peakX > 0 && peakX + 1 < outputWidth)
+    {
+      offsetX = QuadraticPeakOffset(values[peakIndex - 1], peakValue, values[peakIndex + 1]);
+    }
+    if(peakY > 0 && peakY + 1 < outputHeight)
+    {
+      offsetY = QuadraticPeakOffset(values[peakIndex - outputWidth], peakValue, values[peakIndex + outputWidth]);
+    }
+  }
+
+  const double requiredNumberOfOverlappingPixels = requiredFractionOfOverlappingPixels * static_cast<double>(std::min(fixedWidth, movingWidth) * std::min(fixedHeight, movingHeight));
+  newXYOrigin[0] = static_cast<float>(static_cast<double>(peakX) + offsetX - static_cast<double>(fixedWidth));
+  newXYOrigin[1] = static_cast<float>(static_cast<double>(peakY) + offsetY - static_cast<double>(fixedHeight));
+  newXYOrigin[2] = ws->calculator->GetMaximum(); // add this for when more than one image pair has to be xcorrelated - want ot use this value to find best fit location
+  newXYOrigin[3] = static_cast<float>(PeakToSidelobeRatio(values, outputWidth, outputHeight, fixedWidth, fixedHeight, movingWidth, movingHeight, requiredNumberOfOverlappingPixels, peakX, peakY,
+                                                          peakValue));
+
+  // The output buffer belongs to the filter, so the workspace is only handed back once nothing reads it anymore
+  returnWorkspace(key, std::move(ws));
+  return newXYOrigin;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t CorrelationContext::CoarseToFineFactor(size_t width, size_t height, size_t downsampleFactor)
+{
+  // Each refinement level halves the factor, so only powers of two are used
+  size_t factor = 1;
+  while(factor * 2 <= downsampleFactor && width / (factor * 2) >= k_MinimumCoarseSize && height / (factor * 2) >= k_MinimumCoarseSize)
+  {
+    factor *= 2;
+  }
+  return factor;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void CorrelationContext::DownsampleWindow(const ImageProcessingConstants::DefaultPixelType* data, size_t stride, size_t width, size_t height, size_t factor,
+                                          std::vector<ImageProcessingConstants::DefaultPixelType>& downsampled)
+{
+  const size_t downsampledWidth = width / factor;
+  const size_t downsampledHeight = height / factor;
+  const uint32_t count = static_cast<uint32_t>(factor * factor);
+  downsampled.resize(downsampledWidth * downsampledHeight);
+
+  // Sum factor rows column by column first, then each group of factor columns
+  std::vector<uint32_t> columnSums(downsampledWidth * factor);
+  for(size_t y = 0; y < downsampledHeight; y++)
+  {
+    std::fill(columnSums.begin(), columnSums.end(), 0);
+    for(size_t row = 0; row < factor; row++)
+    {
+      const ImageProcessingConstants::DefaultPixelType* input = data + (y * factor + row) * stride;
+      for(size_t x = 0; x < columnSums.size(); x++)
+      {
+        columnSums[x] += input[x];
+      }
+    }
+    ImageProcessingConstants::DefaultPixelType* output = downsampled.data() + y * downsampledWidth;
+    for(size_t x = 0; x < downsampledWidth; x++)
+    {
+      uint32_t sum = 0;
+      for(size_t column = 0; column < factor; column++)
+      {
+        sum += columnSums[x * factor + column];
+      }
+      output[x] = static_cast<ImageProcessingConstants::DefaultPixelType>((sum + count / 2) / count);
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+std::vector<float> CorrelationContext::correlateCoarseToFine(const ImageProcessingConstants::DefaultPixelType* fixed, size_t fixedStride, size_t fixedWidth, size_t fixedHeight,
+                                                             const ImageProcessingConstants::DefaultPixelType* moving, size_t movingStride, size_t movingWidth, size_t movingHeight,
+                                                             double requiredFractionOfOverlappingPixels, size_t downsampleFactor)
+{
+  const size_t factor = CoarseToFineFactor(std::min(fixedWidth, movingWidth), std::min(fixedHeight, movingHeight), downsampleFactor);
+  if(factor <= 1)
+  {
+    return correlate(fixed, fixedStride, fixedWidth, fixedHeight, moving, movingStride, movingWidth, movingHeight, requiredFractionOfOverlappingPixels);
+  }
+
+  std::vector<ImageProcessingConstants::DefaultPixelType> coarseFixed;
+  std::vector<ImageProcessingConstants::DefaultPixelType> coarseMoving;
+  DownsampleWindow(fixed, fixedStride, fixedWidth, fixedHeight, factor, coarseFixed);
+  DownsampleWindow(moving, movingStride, movingWidth, movingHeight, factor, coarseMoving);
+  std::vector<float> coarsePeak = correlate(coarseFixed.data(), fixedWidth / factor, fixedWidth / factor, fixedHeight / factor, coarseMoving.data(), movingWidth / factor, movingWidth / factor,
+                                            movingHeight / factor, requiredFractionOfOverlappingPixels);
+  return refinePeak(fixed, fixedStride, fixedWidth, fixedHeight, moving, movingStride, movingWidth, movingHeight, requiredFractionOfOverlappingPixels, coarsePeak, factor);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+std::vector<float> CorrelationContext::refinePeak(const ImageProcessingConstants::DefaultPixelType* fixed, size_t fixedStride, size_t fixedWidth, size_t fixedHeight,
+                                                  const ImageProcessingConstants::DefaultPixelType* moving, size_t movingStride, size_t movingWidth, size_t movingHeight,
+                                                  double requiredFractionOfOverlappingPixels, const std::vector<float>& coarsePeak, size_t downsampleFactor)
+{
+  std::vector<float> newXYOrigin(4, 0);
+  if(fixedWidth == 0 || fixedHeight == 0 || movingWidth == 0 || movingHeight == 0)
+  {
+    return newXYOrigin;
+  }
+
+  // Turn the peak index of the coarse correlation back into the shift of the moving window. A sub pixel coarse peak is
+  // rounded to the nearest pixel first.
+  int64_t tx = static_cast<int64_t>(std::floor(coarsePeak[0] + 0.5f)) + static_cast<int64_t>(fixedWidth / downsampleFactor) - static_cast<int64_t>(movingWidth / downsampleFactor) + 1;
+  int64_t ty = static_cast<int64_t>(std::floor(coarsePeak[1] + 0.5f)) + static_cast<int64_t>(fixedHeight / downsampleFactor) - static_cast<int64_t>(movingHeight / downsampleFactor) + 1;
+  double peakValue = static_cast<double>(coarsePeak[2]);
+  double offsetX = 0.0;
+  double offsetY = 0.0;
+
+  // A pixel of one level covers two pixels of the next finer level, so the doubled shift is off by at most one pixel
+  // plus whatever the box averages blur away. Searching two pixels around it (and further if the peak sits on the
+  // border of the search) only touches a few dozen shifts per level.
+  std::vector<ImageProcessingConstants::DefaultPixelType> levelFixed;
+  std::vector<ImageProcessingConstants::DefaultPixelType> levelMoving;
+  for(size_t factor = downsampleFactor / 2; factor >= 1; factor /= 2)
+  {
+    tx *= 2;
+    ty *= 2;
+    if(factor == 1)
+    {
+      ShiftSearch search(fixed, fixedStride, fixedWidth, fixedHeight, moving, movingStride, movingWidth, movingHeight, requiredFractionOfOverlappingPixels);
+      peakValue = search.findPeak(tx, ty, 2);
+      if(m_SubPixelPeak)
+      {
+        search.subPixelOffset(tx, ty, offsetX, offsetY);
+      }
+      break;
+    }
+    DownsampleWindow(fixed, fixedStride, fixedWidth, fixedHeight, factor, levelFixed);
+    DownsampleWindow(moving, movingStride, movingWidth, movingHeight, factor, levelMoving);
+    ShiftSearch search(levelFixed.data(), fixedWidth / factor, fixedWidth / factor, fixedHeight / factor, levelMoving.data(), movingWidth / factor, movingWidth / factor, movingHeight / factor,
+                       requiredFractionOfOverlappingPixels);
+    peakValue = search.findPeak(tx, ty, 2);
+  }
+
+  // Only the coarse level has the whole correlation surface, so the peak to sidelobe ratio is the coarse one
+  newXYOrigin[0] = static_cast<float>(static_cast<double>(tx + static_cast<int64_t>(movingWidth) - 1 - static_cast<int64_t>(fixedWidth)) + offsetX);
+  newXYOrigin[1] = static_cast<float>(static_cast<double>(ty + static_cast<int64_t>(movingHeight) - 1 - static_cast<int64_t>(fixedHeight)) + offsetY);
+  newXYOrigin[2] = static_cast<float>(peakValue);
+  newXYOrigin[3] = coarsePeak[3];
+  return newXYOrigin;
+}
@@ -0,0 +1,162 @@
+/* ============================================================================
+ * Copyright (c) 2014 Michael A. Jackson (BlueQuartz Software)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of Michael A. Jackson, BlueQuartz Software nor the names of
+ * its contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#pragma once
+
+#include <array>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "SIMPLib/ITK/itkSupportConstants.h"
+#include "SIMPLib/Common/SIMPLibSetGetMacros.h"
+#include "SIMPLib/SIMPLib.h"
+
+/**
+ * @brief The CorrelationContext class computes the normalized cross correlation of two rectangular image windows
+ * with itk::MaskedFFTNormalizedCorrelationImageFilter and finds its peak with itk::MinimumMaximumImageCalculator,
+ * exactly as DetermineStitching::CropAndCrossCorrelate always did. The images the windows are copied into, the
+ * correlation filter and the calculator are kept per window size and handed out to one caller at a time, so a single
+ * context can be shared by all the threads correlating tile pairs and repeated calls with the same window size do not
+ * rebuild the pipeline.
+ *
+ * Every result also carries the peak to sidelobe ratio: the peak minus the mean of the correlation values more than
+ * 5 pixels away from it, divided by their standard deviation. A low ratio flags a pair whose peak barely stands out,
+ * for example because the overlap is featureless. When sub pixel peaks are enabled the peak position is refined by
+ * fitting a parabola through the peak and its neighbours along each axis.
+ */
+class CorrelationContext
+{
+  public:
+    SIMPL_SHARED_POINTERS(CorrelationContext)
+    SIMPL_STATIC_NEW_MACRO(CorrelationContext)
+
+    virtual ~CorrelationContext();
+
+    /**
+     * @brief setSubPixelPeak Enables the parabolic sub pixel refinement of the peak position. Set this before the
+     * context is shared between threads.
+     */
+    void setSubPixelPeak(bool subPixelPeak);
+    bool getSubPixelPeak() const;
+
+    /**
+     * @brief Correlate Cross correlates the moving window against the fixed window and finds the peak
+     * @param fixed Pointer to the first pixel of the fixed window
+     * @param fixedStride Distance in pixels between two rows of the fixed window
+     * @param fixedWidth
+     * @param fixedHeight
+     * @param moving Pointer to the first pixel of the moving window
+     * @param movingStride Distance in pixels between two rows of the moving window
+     * @param movingWidth
+     * @param movingHeight
+     * @param requiredFractionOfOverlappingPixels Shifts with fewer overlapping pixels than this fraction of the largest overlap are set to 0
+     * @return X and Y index of the correlation peak minus the fixed window size, followed by the peak value and the peak to sidelobe ratio
+     */
+    std::vector<float> correlate(const ImageProcessingConstants::DefaultPixelType* fixed, size_t fixedStride, size_t fixedWidth, size_t fixedHeight,
+                                 const ImageProcessingConstants::DefaultPixelType* moving, size_t movingStride, size_t movingWidth, size_t movingHeight,
+                                 double requiredFractionOfOverlappingPixels);
+
+    /**
+     * @brief correlateCoarseToFine Same as correlate(), but the peak is first found on copies of the windows that are box
+     * downsampled by downsampleFactor and then refined one level at a time by evaluating the correlation at the few shifts
+     * around the doubled estimate. This is much faster for large windows and ends on the same peak as correlate() as long
+     * as the downsampled windows still show the structure the peak comes from. See CoarseToFineFactor().
+     * @param fixed
+     * @param fixedStride
+     * @param fixedWidth
+     * @param fixedHeight
+     * @param moving
+     * @param movingStride
+     * @param movingWidth
+     * @param movingHeight
+     * @param requiredFractionOfOverlappingPixels
+     * @param downsampleFactor Largest downsampling factor to use (a power of two)
+     * @return X and Y index of the correlation peak minus the fixed window size, followed by the peak value and the peak to sidelobe ratio
+     */
+    std::vector<float> correlateCoarseToFine(const ImageProcessingConstants::DefaultPixelType* fixed, size_t fixedStride, size_t fixedWidth, size_t fixedHeight,
+                                             const ImageProcessingConstants::DefaultPixelType* moving, size_t movingStride, size_t movingWidth, size_t movingHeight,
+                                             double requiredFractionOfOverlappingPixels, size_t downsampleFactor);
+
+    /**
+     * @brief refinePeak Refines the peak found by correlating the windows downsampled by downsampleFactor (see
+     * DownsampleWindow()) to full resolution. The peak to sidelobe ratio is taken over from the coarse correlation, the
+     * only level whose whole correlation surface is computed.
+     * @param coarsePeak Result of correlate() for the downsampled windows
+     * @param downsampleFactor Factor the windows were downsampled by (a power of two)
+     * @return X and Y index of the correlation peak minus the fixed window size, followed by the peak value and the peak to sidelobe ratio
+     */
+    std::vector<float> refinePeak(const ImageProcessingConstants::DefaultPixelType* fixed, size_t fixedStride, size_t fixedWidth, size_t fixedHeight,
+                                  const ImageProcessingConstants::DefaultPixelType* moving, size_t movingStride, size_t movingWidth, size_t movingHeight,
+                                  double requiredFractionOfOverlappingPixels, const std::vector<float>& coarsePeak, size_t downsampleFactor);
+
+    /**
+     * @brief CoarseToFineFactor Returns the largest power of two up to downsampleFactor that still leaves a window of the
+     * given size at least 16 pixels wide and high once downsampled. A factor of 1 means the window is correlated at full resolution.
+     */
+    static size_t CoarseToFineFactor(size_t width, size_t height, size_t downsampleFactor);
+
+    /**
+     * @brief DownsampleWindow Averages blocks of factor x factor pixels. The result is (width / factor) x (height / factor)
+     * pixels with a stride equal to its width; the pixels of partial blocks at the right and bottom are dropped.
+     */
+    static void DownsampleWindow(const ImageProcessingConstants::DefaultPixelType* data, size_t stride, size_t width, size_t height, size_t factor,
+                                 std::vector<ImageProcessingConstants::DefaultPixelType>& downsampled);
+
+  protected:
+    CorrelationContext();
+
+  private:
+    struct Workspace;
+    typedef std::array<size_t, 4> WindowKey; // Fixed width and height, moving width and height
+
+    bool m_SubPixelPeak = false;
+    std::mutex m_Mutex;
+    std::map<WindowKey, std::vector<std::unique_ptr<Workspace>>> m_FreeWorkspaces;
+
+    /**
+     * @brief checkOutWorkspace Returns a workspace for the given window sizes that no other thread is using,
+     * creating one only if all cached workspaces for those sizes are in use
+     */
+    std::unique_ptr<Workspace> checkOutWorkspace(const WindowKey& key);
+
+    /**
+     * @brief returnWorkspace Hands a workspace back so the next call with the same window sizes can reuse it
+     */
+    void returnWorkspace(const WindowKey& key, std::unique_ptr<Workspace> workspace);
+
+  public:
+    CorrelationContext(const CorrelationContext&) = delete; // Copy Constructor Not Implemented
+    CorrelationContext(CorrelationContext&&) = delete;      // Move Constructor Not Implemented
+    CorrelationContext& operator=(const CorrelationContext&) = delete; // Copy Assignment Not Implemented
+    CorrelationContext& operator=(CorrelationContext&&) = delete;      // Move Assignment Not Implemented
+};
@@ -31,18 +31,21 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "DetermineStitching.h"
 
-#include <QtCore/QDir>
+#include <algorithm>
+#include <cmath>
 
-#include "itkMaskedFFTNormalizedCorrelationImageFilter.h"
 #include "itkImage.h"
-#include "itkImageFileWriter.h"
-#include "itkRegionOfInterestImageFilter.h"
-#include "itkChangeInformationImageFilter.h"
-#include "itkMinimumMaximumImageCalculator.h"
 
 #include "ImageProcessing/ImageProcessingHelpers.hpp"
 #include "SIMPLib/ITK/itkBridge.h"
 
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_scheduler_init.h>
+#endif
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -64,14 +67,188 @@ T FindMaxValue(QVector<T> inputVector)
   return *it;
 }
 
+/**
+ * @brief MakeTilePair Records the shift found between a tile and one of its neighbours
+ */
+static DetermineStitching::TilePair MakeTilePair(size_t combIndex, size_t neighborIndex, bool fromLeft, const std::vector<float>& cropSpecsIm1Im2, const std::vector<float>& newXYOrigin)
+{
+  DetermineStitching::TilePair pair;
+  pair.combIndex = combIndex;
+  pair.neighborIndex = neighborIndex;
+  pair.fromLeft = fromLeft;
+  pair.cropSpecsIm1Im2 = cropSpecsIm1Im2;
+  pair.newXYOrigin = newXYOrigin;
+  return pair;
+}
+
+/**
+ * @brief The CrossCorrelateTilePairsImpl class computes the local shifts for a range of tile pairs. The overlap
+ * windows are read straight from the tile data, so ranges can be handed to different threads.
+ */
+class CrossCorrelateTilePairsImpl
+{
+public:
+  CrossCorrelateTilePairsImpl(std::vector<DetermineStitching::TilePair>& pairs, const QVector<size_t>& combIndexList, QVector<size_t> udims,
+                              const QVector<ImageProcessingConstants::DefaultPixelType*>& dataArrayList, CorrelationContext* context, size_t downsampleFactor)
+  : m_Pairs(pairs)
+  , m_CombIndexList(combIndexList)
+  , m_Udims(udims)
+  , m_DataArrayList(dataArrayList)
+  , m_Context(context)
+  , m_DownsampleFactor(downsampleFactor)
+  {
+  }
+
+  virtual ~CrossCorrelateTilePairsImpl() = default;
+
+  void convert(size_t start, size_t end) const
+  {
+    for(size_t p = start; p < end; p++)
+    {
+      DetermineStitching::TilePair& pair = m_Pairs[p];
+
+      //view the tile pixels in place
+      const ConstTileView currentImage(m_DataArrayList[m_CombIndexList[pair.combIndex]], m_Udims[0], m_Udims[1]);
+      const ConstTileView neighborImage(m_DataArrayList[m_CombIndexList[pair.neighborIndex]], m_Udims[0], m_Udims[1]);
+
+      //Cross correlate the image windows and return the local shifts between the two images
+      pair.newXYOrigin = DetermineStitching::CropAndCrossCorrelate(pair.cropSpecsIm1Im2, currentImage, neighborImage, m_Context, m_DownsampleFactor);
+    }
+  }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    convert(r.begin(), r.end());
+  }
+#endif
+
+private:
+  std::vector<DetermineStitching::TilePair>& m_Pairs;
+  const QVector<size_t>& m_CombIndexList;
+  QVector<size_t> m_Udims;
+  const QVector<ImageProcessingConstants::DefaultPixelType*>& m_DataArrayList;
+  CorrelationContext* m_Context;
+  size_t m_DownsampleFactor;
+};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+std::vector<DetermineStitching::TilePair> DetermineStitching::BuildTilePairs(size_t numTiles, size_t numXtiles, QVector<size_t> udims, float overlapPer)
+{
+  std::vector<TilePair> pairs;
+  pairs.reserve(2 * numTiles);
+
+  // IMPORTANT:
+  // cropSpecIm1Im2 is a rather important variable so it's good to understand what each value means
+  // The first 6 values in the array are the crop origin that we'll be looking at (starts at the top left)
+  // The last 6 values in the array are the crop dimensions (size) that we'll look at (goes down to bottom right)
+  // Tiles in the top row are only matched to the left, tiles in the first column are only matched to the top
+  // and every other tile is matched to the top first and then to the left.
+  for(size_t i = 1; i < numTiles; i++)
+  {
+    if(i >= numXtiles) // Every tile below the first row has a neighbour above it
+    {
+      TilePair pair;
+      pair.combIndex = i;
+      pair.neighborIndex = i - numXtiles;
+      pair.fromLeft = false;
+      pair.cropSpecsIm1Im2.resize(12, 0);
+
+      // Determine the windows to be cross correlated depending on the rough overlap as found from the global coordinates
+      pair.cropSpecsIm1Im2[0] = 0; //top image X Origin
+      pair.cropSpecsIm1Im2[1] = udims[1] - (udims[1] * (overlapPer / 100)); //top image Y Origin
+      pair.cropSpecsIm1Im2[2] = 0; //top image Z Origin
+      pair.cropSpecsIm1Im2[3] = 0; //current image X Origin
+      pair.cropSpecsIm1Im2[4] = 0; //current image Y Origin
+      pair.cropSpecsIm1Im2[5] = 0; //current image Z Origin
+
+      pair.cropSpecsIm1Im2[6] = udims[0]; //top image X Size
+      pair.cropSpecsIm1Im2[7] = udims[1] * (overlapPer / 100); //top image Y Size
+      pair.cropSpecsIm1Im2[8] = 1; //top image Z Size
+      pair.cropSpecsIm1Im2[9] = udims[0]; //current image X Size
+      pair.cropSpecsIm1Im2[10] = udims[1] * (overlapPer / 100); //current image Y Size
+      pair.cropSpecsIm1Im2[11] = 1; //current image Z Size
+      pairs.push_back(pair);
+    }
 
+    if(i % numXtiles != 0) // Every tile that is not in the first column has a neighbour to its left
+    {
+      TilePair pair;
+      pair.combIndex = i;
+      pair.neighborIndex = i - 1;
+      pair.fromLeft = true;
+      pair.cropSpecsIm1Im2.resize(12, 0);
+
+      // Width of the image * the percentage (say 20%) = the size of the crop we're looking at. Subtract that from the width of the image and you have the origin
+      pair.cropSpecsIm1Im2[0] = udims[0] - (udims[0] * (overlapPer / 100)); //left image X Origin
+      pair.cropSpecsIm1Im2[1] = 0; //left image Y Origin
+      pair.cropSpecsIm1Im2[2] = 0; //left image Z Origin
+      pair.cropSpecsIm1Im2[3] = 0; //current image X Origin
+      pair.cropSpecsIm1Im2[4] = 0; //current image Y Origin
+      pair.cropSpecsIm1Im2[5] = 0; //current image Z Origin
+
+      pair.cropSpecsIm1Im2[6] = udims[0] * (overlapPer / 100); //left image X Size
+      pair.cropSpecsIm1Im2[7] = udims[1]; //left image Y Size
+      pair.cropSpecsIm1Im2[8] = 1; //left image Z Size
+      pair.cropSpecsIm1Im2[9] = udims[0] * (overlapPer / 100); //current image X Size
+      pair.cropSpecsIm1Im2[10] = udims[1]; //current image Y Size
+      pair.cropSpecsIm1Im2[11] = 1; //current image Z Size
+      pairs.push_back(pair);
+    }
+  }
+
+  return pairs;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void DetermineStitching::CrossCorrelateTilePairs(std::vector<TilePair>& pairs,
+                                                 const QVector<size_t>& combIndexList,
+                                                 QVector<size_t> udims,
+                                                 QVector<ImageProcessingConstants::DefaultPixelType*> dataArrayList,
+                                                 size_t downsampleFactor,
+                                                 bool subPixelPeak)
+{
+  // Every pair of a stitch has the same overlap window size, so the workspaces created by the first pairs are reused by all the others
+  CorrelationContext::Pointer context = CorrelationContext::New();
+  context->setSubPixelPeak(subPixelPeak);
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  tbb::task_scheduler_init init;
+  bool doParallel = true;
+#endif
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  if(doParallel)
+  {
+    // A grain size of 1 lets idle threads steal single pairs, which keeps every core busy even though
+    // the cost of a pair depends on the size of its overlap window
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, pairs.size(), 1), CrossCorrelateTilePairsImpl(pairs, combIndexList, udims, dataArrayList, context.get(), downsampleFactor),
+                      tbb::auto_partitioner());
+  }
+  else
+#endif
+  {
+    CrossCorrelateTilePairsImpl serial(pairs, combIndexList, udims, dataArrayList, context.get(), downsampleFactor);
+    serial.convert(0, pairs.size());
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
 FloatArrayType::Pointer DetermineStitching::FindGlobalOrigins(int xTileCount, int yTileCount,
   int ImportMode,
   float overlapPer,
   QVector<ImageProcessingConstants::DefaultPixelType*> dataArrayList,
   QVector<size_t> udims,
-  float sampleOrigin[],
-  float voxelResolution[]
+  int placementMode,
+  int correlationSearch,
+  bool subPixelPeak,
+  FloatArrayType::Pointer peakToSidelobeRatios
   )
 {
   // Basically the same thing as the legacy method, but with several values changed to make up for the fact that we're not using
@@ -97,21 +274,41 @@ FloatArrayType::Pointer DetermineStitching::FindGlobalOrigins(int xTileCount, in
 
   combIndexList = ReturnProperIndex(ImportMode, xTileCount,yTileCount);
 
-  ImageProcessingConstants::UInt8ImageType* currentImage;
-  ImageProcessingConstants::UInt8ImageType* leftImage;
-  ImageProcessingConstants::UInt8ImageType* aboveImage;
-  ImageProcessingConstants::ImportUInt8FilterType::Pointer importFilter;
-  ImageProcessingConstants::ImportUInt8FilterType::Pointer importFilter2;
-  std::vector<float> cropSpecsIm1Im2(12, 0);
-  std::vector<float> newXYOrigin(2, 0);
-  std::vector<float> newXYOrigin2(2, 0);
-
   //set the stitched global coordinates of the first tile to the top left corner
   xyStitchedGlobalListPtr->setValue(0, 0);
   xyStitchedGlobalListPtr->setValue(1, 0);
   xyStitchedGlobalListPtr_orig->setValue(0, 0);
   xyStitchedGlobalListPtr_orig->setValue(1, 0);
 
+  // The pairwise cross correlations do not depend on each other, only on the image data. Compute all of them
+  // up front and then walk the tiles in comb order to turn the local shifts into global origins.
+  std::vector<TilePair> pairs = BuildTilePairs(combIndexList.size(), numXtiles, udims, overlapPer);
+  CrossCorrelateTilePairs(pairs, combIndexList, udims, dataArrayList, SearchDownsampleFactor(correlationSearch), subPixelPeak);
+
+  // Report how clearly each pair's peak stands out, in the original tile order. The first tile has no pairs.
+  if(nullptr != peakToSidelobeRatios.get())
+  {
+    peakToSidelobeRatios->initializeWithZeros();
+    for(const TilePair& pair : pairs)
+    {
+      peakToSidelobeRatios->setComponent(combIndexList[pair.combIndex], pair.fromLeft ? 0 : 1, pair.newXYOrigin[3]);
+    }
+  }
+
+  // Index the computed pairs by the tile being placed so the fold below can look them up
+  std::vector<const TilePair*> leftPairs(combIndexList.size(), nullptr);
+  std::vector<const TilePair*> topPairs(combIndexList.size(), nullptr);
+  for(const TilePair& pair : pairs)
+  {
+    if(pair.fromLeft)
+    {
+      leftPairs[pair.combIndex] = &pair;
+    }
+    else
+    {
+      topPairs[pair.combIndex] = &pair;
+    }
+  }
 
   //helper variables to store previous stitched global values
   float previousXleft = 0;
@@ -126,175 +323,61 @@ FloatArrayType::Pointer DetermineStitching::FindGlobalOrigins(int xTileCount, in
   float newXfromtop = 0;
   float newYfromtop = 0;
 
-  // IMPORTANT:
-  // This method is set up a bit weird so hopefully this will help
-  // cropSpecIm1Im2 is a rather important variable so it's good to understand what each value means
-  // The first 6 values in the array are the crop origin that we'll be looking at (starts at the top left)
-  // The last 6 values in the array are the crop dimensions (size) that we'll look at (goes down to bottom right)
-  // The CropAndCrossCorrelate method crops the images and compares them with each other looking for a spike in similar values (a simplified explanation)
-  // The loop compares 2 images at once, so if you have a 3 x 3 image, the loop will only go through 8 times. You'll compare the second image with the first image
+  // The fold compares 2 images at once, so if you have a 3 x 3 image, the loop will only go through 8 times. You'll compare the second image with the first image
   //		first thing so the first if statement will only trigger twice before triggering the second if statement
-
   for (size_t i = 1; i < combIndexList.size(); i++)
   {
     if (i < numXtiles) //if the image is in the top row of images, we need only the image to the left
     {
-
-      //get filter to convert m_RawImageData to itk::image
-
-      importFilter = ITKUtilitiesType::Dream3DtoITKImportFilterDataArray<ImageProcessingConstants::DefaultPixelType>(totalPoints, udims, sampleOrigin, voxelResolution, dataArrayList[combIndexList[i]]);
-      currentImage = importFilter->GetOutput();
-      importFilter2 = ITKUtilitiesType::Dream3DtoITKImportFilterDataArray<ImageProcessingConstants::DefaultPixelType>(totalPoints, udims, sampleOrigin, voxelResolution, dataArrayList[combIndexList[i - 1]]);
-      leftImage = importFilter2->GetOutput();
-
-      // Determine the windows to be cross correlated depending on the rough overlap as found from the global coordinates
-      cropSpecsIm1Im2[0] = udims[0] - (udims[0] * (overlapPer / 100)); // Width of the image * the percentage (say 20%) = the size of the crop we're looking at. Subtract that from the width of the image and you have the origin
-      cropSpecsIm1Im2[1] = 0; //left image Y Origin
-      cropSpecsIm1Im2[2] = 0; //left image Z Origin
-      cropSpecsIm1Im2[3] = 0; //current image X Origin
-      cropSpecsIm1Im2[4] = 0; //current image Y Origin
-      cropSpecsIm1Im2[5] = 0; //current image Z Origin
-
-      cropSpecsIm1Im2[6] = udims[0] * (overlapPer/100); //left image X Size
-      cropSpecsIm1Im2[7] = udims[1]; //left image Y Size
-      cropSpecsIm1Im2[8] = 1; //left image Z Size
-      cropSpecsIm1Im2[9] = udims[0] * (overlapPer / 100); //current image X Size
-      cropSpecsIm1Im2[10] = udims[1]; //current image Y Size
-      cropSpecsIm1Im2[11] = 1; //current image Z Size
-
-      //Cross correlate the image windows and return the local shifts between the two images
-      newXYOrigin = CropAndCrossCorrelate(cropSpecsIm1Im2, currentImage, leftImage);
+      const TilePair& left = *leftPairs[i];
 
       previousXleft = xyStitchedGlobalListPtr->getValue(2 * (i - 1));
       previousYleft = xyStitchedGlobalListPtr->getValue(2 * (i - 1) + 1);
 
-      newXfromleft = previousXleft + cropSpecsIm1Im2[0] + newXYOrigin[0];
-      newYfromleft = previousYleft + newXYOrigin[1];
+      newXfromleft = previousXleft + left.cropSpecsIm1Im2[0] + left.newXYOrigin[0];
+      newYfromleft = previousYleft + left.newXYOrigin[1];
 
       xyStitchedGlobalListPtr->setValue(2 * i, newXfromleft);
       xyStitchedGlobalListPtr->setValue(2 * i + 1, newYfromleft);
-
-
-
-
     }
     else if (i % numXtiles == 0) //if the image is in the first (left most) column of images, we only need the top image
     {
-      //int iZerothIndex = i - 1;
-      //get filter to convert m_RawImageData to itk::image
-
-      importFilter = ITKUtilitiesType::Dream3DtoITKImportFilterDataArray<ImageProcessingConstants::DefaultPixelType>(totalPoints, udims, sampleOrigin, voxelResolution, dataArrayList[combIndexList[i]]);
-      currentImage = importFilter->GetOutput();
-      importFilter2 = ITKUtilitiesType::Dream3DtoITKImportFilterDataArray<ImageProcessingConstants::DefaultPixelType>(totalPoints, udims, sampleOrigin, voxelResolution, dataArrayList[combIndexList[i - numXtiles]]);
-      aboveImage = importFilter2->GetOutput();
-
-
-      // Determine the windows to be cross correlated depending on the rough overlap as found from the global coordinates
-
-      cropSpecsIm1Im2[0] = 0; //top image X Origin
-      cropSpecsIm1Im2[1] = udims[1] - (udims[1] * (overlapPer / 100)); //yGlobCoordsList[combIndexList[i]] - xyStitchedGlobalListPtr->getValue(2*(i-numXtiles)+1) - yGlobCoordsList[0]; //top image Y Origin
-      cropSpecsIm1Im2[2] = 0; //top image Z Origin
-      cropSpecsIm1Im2[3] = 0; //current image X Origin
-      cropSpecsIm1Im2[4] = 0; //current image Y Origin
-      cropSpecsIm1Im2[5] = 0; //current image Z Origin
-
-      cropSpecsIm1Im2[6] = udims[0]; //top image X Size
-      cropSpecsIm1Im2[7] = udims[1] * (overlapPer / 100); //top image Y Size
-      cropSpecsIm1Im2[8] = 1; //top image Z Size
-      cropSpecsIm1Im2[9] = udims[0]; //current image X Size
-      cropSpecsIm1Im2[10] = udims[1] * (overlapPer / 100); //current image Y Size
-      cropSpecsIm1Im2[11] = 1; //current image Z Size
-
-      //Cross correlate the image windows and return the local shifts between the two images
-      newXYOrigin = CropAndCrossCorrelate(cropSpecsIm1Im2, currentImage, aboveImage);
+      const TilePair& top = *topPairs[i];
 
       previousXtop = xyStitchedGlobalListPtr->getValue(2 * (i - numXtiles));
       previousYtop = xyStitchedGlobalListPtr->getValue(2 * (i - numXtiles) + 1);
 
       //Add the local shifts to the preivous global value to get the current stitched global shift
-      newXfromtop = previousXtop + newXYOrigin[0];
-      newYfromtop = previousYtop + newXYOrigin[1] + cropSpecsIm1Im2[1];
-
+      newXfromtop = previousXtop + top.newXYOrigin[0];
+      newYfromtop = previousYtop + top.newXYOrigin[1] + top.cropSpecsIm1Im2[1];
 
       xyStitchedGlobalListPtr->setValue(2 * i, newXfromtop);
       xyStitchedGlobalListPtr->setValue(2 * i+ 1, newYfromtop);
-
-
     }
-
     else  //for all other images, we need to match to the top and the left
     {
+      const TilePair& top = *topPairs[i];
+      const TilePair& left = *leftPairs[i];
 
-      //get filter to convert m_RawImageData to itk::image
       ///TOP IMAGE FIRST
-      importFilter = ITKUtilitiesType::Dream3DtoITKImportFilterDataArray<ImageProcessingConstants::DefaultPixelType>(totalPoints, udims, sampleOrigin, voxelResolution, dataArrayList[combIndexList[i]]);
-      currentImage = importFilter->GetOutput();
-      importFilter2 = ITKUtilitiesType::Dream3DtoITKImportFilterDataArray<ImageProcessingConstants::DefaultPixelType>(totalPoints, udims, sampleOrigin, voxelResolution, dataArrayList[combIndexList[i - numXtiles]]);
-      aboveImage = importFilter2->GetOutput();
-
-
-      // Determine the windows to be cross correlated depending on the rough overlap as found from the global coordinates
-
-      cropSpecsIm1Im2[0] = 0; //top image X Origin
-      cropSpecsIm1Im2[1] = udims[1] - (udims[1] * (overlapPer/100)); //yGlobCoordsList[combIndexList[i]] - xyStitchedGlobalListPtr->getValue(2*(i-numXtiles)+1) - yGlobCoordsList[0]; //top image Y Origin
-      cropSpecsIm1Im2[2] = 0; //top image Z Origin
-      cropSpecsIm1Im2[3] = 0; //current image X Origin
-      cropSpecsIm1Im2[4] = 0; //current image Y Origin
-      cropSpecsIm1Im2[5] = 0; //current image Z Origin
-
-      cropSpecsIm1Im2[6] = udims[0]; //top image X Size
-      cropSpecsIm1Im2[7] = udims[1] * (overlapPer / 100); //top image Y Size
-      cropSpecsIm1Im2[8] = 1; //top image Z Size
-      cropSpecsIm1Im2[9] = udims[0]; //current image X Size
-      cropSpecsIm1Im2[10] = udims[1] * (overlapPer / 100); //current image Y Size
-      cropSpecsIm1Im2[11] = 1; //current image Z Size
-
-      //Cross correlate the image windows and return the local shifts between the two images
-      newXYOrigin2 = CropAndCrossCorrelate(cropSpecsIm1Im2, currentImage, aboveImage);
-
       previousXtop = xyStitchedGlobalListPtr->getValue(2 * (i - numXtiles));
       previousYtop = xyStitchedGlobalListPtr->getValue(2 * (i - numXtiles) + 1);
 
       //Add the local shifts to the preivous global value to get the current stitched global shift
-      newXfromtop = previousXtop + newXYOrigin2[0];
-      newYfromtop = previousYtop + newXYOrigin2[1] + cropSpecsIm1Im2[1];
+      newXfromtop = previousXtop + top.newXYOrigin[0];
+      newYfromtop = previousYtop + top.newXYOrigin[1] + top.cropSpecsIm1Im2[1];
 
       //BOTTOM IMAGE NEXT
-      importFilter = ITKUtilitiesType::Dream3DtoITKImportFilterDataArray<ImageProcessingConstants::DefaultPixelType>(totalPoints, udims, sampleOrigin, voxelResolution, dataArrayList[combIndexList[i]]);
-      currentImage = importFilter->GetOutput();
-      importFilter2 = ITKUtilitiesType::Dream3DtoITKImportFilterDataArray<ImageProcessingConstants::DefaultPixelType>(totalPoints, udims, sampleOrigin, voxelResolution, dataArrayList[combIndexList[i - 1]]);
-      leftImage = importFilter2->GetOutput();
-
-      cropSpecsIm1Im2[0] = udims[0] - (udims[0] * (overlapPer/100)); //xGlobCoordsList[combIndexList[i]] - xyStitchedGlobalListPtr->getValue(2*(i-1)) - xGlobCoordsList[0]; //left image X Origin
-      cropSpecsIm1Im2[1] = 0; //left image Y Origin
-      cropSpecsIm1Im2[2] = 0; //left image Z Origin
-      cropSpecsIm1Im2[3] = 0; //current image X Origin
-      cropSpecsIm1Im2[4] = 0; //current image Y Origin
-      cropSpecsIm1Im2[5] = 0; //current image Z Origin
-
-      cropSpecsIm1Im2[6] = udims[0] * (overlapPer/100); //left image X Size
-      cropSpecsIm1Im2[7] = udims[1]; //left image Y Size
-      cropSpecsIm1Im2[8] = 1; //left image Z Size
-      cropSpecsIm1Im2[9] = udims[0] * (overlapPer/100); //current image X Size
-      cropSpecsIm1Im2[10] = udims[1]; //current image Y Size
-      cropSpecsIm1Im2[11] = 1; //current image Z Size
-
-      //Cross correlate the image windows and return the local shifts between the two images
-      newXYOrigin = CropAndCrossCorrelate(cropSpecsIm1Im2, currentImage, leftImage);
-
       previousXleft = xyStitchedGlobalListPtr->getValue(2 * (i - 1));
       previousYleft = xyStitchedGlobalListPtr->getValue(2 * (i - 1) + 1);
 
       //Add the local shifts to the preivous global value to get the current stitched global shift
-      newXfromleft = previousXleft + cropSpecsIm1Im2[0] + newXYOrigin[0];
-      newYfromleft = previousYleft + newXYOrigin[1];
-
+      newXfromleft = previousXleft + left.cropSpecsIm1Im2[0] + left.newXYOrigin[0];
+      newYfromleft = previousYleft + left.newXYOrigin[1];
 
       //AVERAGE the two new locations
       xyStitchedGlobalListPtr->setValue(2 * i, (newXfromtop + newXfromleft) / 2.0);
       xyStitchedGlobalListPtr->setValue(2 * i + 1, (newYfromtop + newYfromleft) / 2.0);
-
-
     }
 
 
@@ -303,23 +386,237 @@ FloatArrayType::Pointer DetermineStitching::FindGlobalOrigins(int xTileCount, in
     xyStitchedGlobalListPtr_orig->setValue(2 * combIndexList[i] + 1, xyStitchedGlobalListPtr->getValue(2 * i + 1));
   }
 
+  if(placementMode == GlobalLeastSquares)
+  {
+    ApplyGlobalLeastSquares(pairs, combIndexList, xyStitchedGlobalListPtr, xyStitchedGlobalListPtr_orig);
+  }
+
   return xyStitchedGlobalListPtr_orig;
 }
 
+namespace
+{
+/**
+ * @brief One weighted edge of the tile placement graph
+ */
+struct PlacementEdge
+{
+  size_t other;
+  double weight;
+};
+
+// Pairs with a non-positive correlation peak still have to keep the grid connected, so they get a tiny weight
+const double k_MinimumPairWeight = 1.0E-3;
+
+// -----------------------------------------------------------------------------
+// Computes y = A * x for the weighted graph Laplacian with the first tile removed (held at zero)
+// -----------------------------------------------------------------------------
+void MultiplyPlacementMatrix(const std::vector<std::vector<PlacementEdge>>& adjacency, const std::vector<double>& diagonal, const std::vector<double>& x, std::vector<double>& y)
+{
+  y[0] = 0.0;
+  for(size_t i = 1; i < adjacency.size(); i++)
+  {
+    double value = diagonal[i] * x[i];
+    for(const PlacementEdge& edge : adjacency[i])
+    {
+      if(edge.other != 0)
+      {
+        value -= edge.weight * x[edge.other];
+      }
+    }
+    y[i] = value;
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Jacobi preconditioned conjugate gradient solve of the placement normal equations. Every iteration is linear
+// in the number of tiles because each tile has at most four neighbours.
+// -----------------------------------------------------------------------------
+void SolvePlacementSystem(const std::vector<std::vector<PlacementEdge>>& adjacency, const std::vector<double>& diagonal, const std::vector<double>& rhs, std::vector<double>& x)
+{
+  size_t n = adjacency.size();
+  std::vector<double> r(n, 0.0);
+  std::vector<double> z(n, 0.0);
+  std::vector<double> p(n, 0.0);
+  std::vector<double> ap(n, 0.0);
+
+  x[0] = 0.0;
+  MultiplyPlacementMatrix(adjacency, diagonal, x, ap);
+
+  double rhsNorm = 0.0;
+  double rz = 0.0;
+  for(size_t i = 1; i < n; i++)
+  {
+    r[i] = rhs[i] - ap[i];
+    z[i] = r[i] / diagonal[i];
+    p[i] = z[i];
+    rz += r[i] * z[i];
+    rhsNorm += rhs[i] * rhs[i];
+  }
+  rhsNorm = std::sqrt(rhsNorm);
+  if(rhsNorm == 0.0)
+  {
+    rhsNorm = 1.0;
+  }
+
+  const double tolerance = 1.0E-10;
+  const size_t maxIterations = 10 * n + 100;
+  for(size_t iter = 0; iter < maxIterations; iter++)
+  {
+    double residualNorm = 0.0;
+    for(size_t i = 1; i < n; i++)
+    {
+      residualNorm += r[i] * r[i];
+    }
+    if(std::sqrt(residualNorm) <= tolerance * rhsNorm)
+    {
+      break;
+    }
+
+    MultiplyPlacementMatrix(adjacency, diagonal, p, ap);
+    double pAp = 0.0;
+    for(size_t i = 1; i < n; i++)
+    {
+      pAp += p[i] * ap[i];
+    }
+    if(pAp <= 0.0)
+    {
+      break;
+    }
+
+    double alpha = rz / pAp;
+    double rzNew = 0.0;
+    for(size_t i = 1; i < n; i++)
+    {
+      x[i] += alpha * p[i];
+      r[i] -= alpha * ap[i];
+      z[i] = r[i] / diagonal[i];
+      rzNew += r[i] * z[i];
+    }
+
+    double beta = rzNew / rz;
+    rz = rzNew;
+    for(size_t i = 1; i < n; i++)
+    {
+      p[i] = z[i] + beta * p[i];
+    }
+  }
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void DetermineStitching::SolveGlobalOrigins(const std::vector<TilePair>& pairs, size_t numTiles, std::vector<double>& xyCombOrigins)
+{
+  if(numTiles < 2)
+  {
+    return;
+  }
+
+  // Every pair says origin(current) - origin(neighbour) = measured offset. Minimizing the weighted squared error of all
+  // of those equations gives the normal equations L * origins = b where L is the weighted Laplacian of the tile grid.
+  std::vector<std::vector<PlacementEdge>> adjacency(numTiles);
+  std::vector<double> diagonal(numTiles, 0.0);
+  std::vector<double> rhsX(numTiles, 0.0);
+  std::vector<double> rhsY(numTiles, 0.0);
+
+  for(const TilePair& pair : pairs)
+  {
+    double offsetX = 0.0;
+    double offsetY = 0.0;
+    if(pair.fromLeft)
+    {
+      offsetX = pair.cropSpecsIm1Im2[0] + pair.newXYOrigin[0];
+      offsetY = pair.newXYOrigin[1];
+    }
+    else
+    {
+      offsetX = pair.newXYOrigin[0];
+      offsetY = pair.newXYOrigin[1] + pair.cropSpecsIm1Im2[1];
+    }
+
+    double weight = std::max(static_cast<double>(pair.newXYOrigin[2]), k_MinimumPairWeight);
+
+    adjacency[pair.combIndex].push_back({pair.neighborIndex, weight});
+    adjacency[pair.neighborIndex].push_back({pair.combIndex, weight});
+    diagonal[pair.combIndex] += weight;
+    diagonal[pair.neighborIndex] += weight;
+    rhsX[pair.combIndex] += weight * offsetX;
+    rhsX[pair.neighborIndex] -= weight * offsetX;
+    rhsY[pair.combIndex] += weight * offsetY;
+    rhsY[pair.neighborIndex] -= weight * offsetY;
+  }
+
+  // A tile without any pair cannot be placed by the solver, so it keeps its starting position
+  for(size_t i = 1; i < numTiles; i++)
+  {
+    if(diagonal[i] <= 0.0)
+    {
+      diagonal[i] = 1.0;
+      rhsX[i] = xyCombOrigins[2 * i];
+      rhsY[i] = xyCombOrigins[2 * i + 1];
+    }
+  }
+
+  std::vector<double> x(numTiles, 0.0);
+  std::vector<double> y(numTiles, 0.0);
+  for(size_t i = 0; i < numTiles; i++)
+  {
+    x[i] = xyCombOrigins[2 * i] - xyCombOrigins[0];
+    y[i] = xyCombOrigins[2 * i + 1] - xyCombOrigins[1];
+  }
+
+  SolvePlacementSystem(adjacency, diagonal, rhsX, x);
+  SolvePlacementSystem(adjacency, diagonal, rhsY, y);
+
+  for(size_t i = 0; i < numTiles; i++)
+  {
+    xyCombOrigins[2 * i] = x[i];
+    xyCombOrigins[2 * i + 1] = y[i];
+  }
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-FloatArrayType::Pointer DetermineStitching::FindGlobalOriginsLegacy(size_t totalPoints,
-    QVector<size_t> udims,
-    float sampleOrigin[],
-    float voxelResolution[],
+void DetermineStitching::ApplyGlobalLeastSquares(const std::vector<TilePair>& pairs, const QVector<size_t>& combIndexList, FloatArrayType::Pointer xyStitchedGlobalListPtr,
+                                                 FloatArrayType::Pointer xyStitchedGlobalListPtr_orig)
+{
+  // Use the chained placement as the starting guess and let the solver distribute the error over the whole grid
+  std::vector<double> xyCombOrigins(2 * combIndexList.size(), 0.0);
+  for(size_t i = 0; i < xyCombOrigins.size(); i++)
+  {
+    xyCombOrigins[i] = xyStitchedGlobalListPtr->getValue(i);
+  }
+
+  SolveGlobalOrigins(pairs, combIndexList.size(), xyCombOrigins);
+
+  for(size_t i = 0; i < combIndexList.size(); i++)
+  {
+    xyStitchedGlobalListPtr->setValue(2 * i, static_cast<float>(xyCombOrigins[2 * i]));
+    xyStitchedGlobalListPtr->setValue(2 * i + 1, static_cast<float>(xyCombOrigins[2 * i + 1]));
+    xyStitchedGlobalListPtr_orig->setValue(2 * combIndexList[i], xyStitchedGlobalListPtr->getValue(2 * i));
+    xyStitchedGlobalListPtr_orig->setValue(2 * combIndexList[i] + 1, xyStitchedGlobalListPtr->getValue(2 * i + 1));
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FloatArrayType::Pointer DetermineStitching::FindGlobalOriginsLegacy(QVector<size_t> udims,
     QVector<ImageProcessingConstants::DefaultPixelType*> dataArrayList,
     QVector<float> xGlobCoordsList,
     QVector<float> yGlobCoordsList,
     QVector<qint32> xTileList,
     QVector<qint32> yTileList,
-    AbstractFilter* filter)
+    AbstractFilter* filter,
+    int placementMode,
+    int correlationSearch,
+    bool subPixelPeak,
+    FloatArrayType::Pointer peakToSidelobeRatios)
 {
+  const size_t downsampleFactor = SearchDownsampleFactor(correlationSearch);
 
   QVector<size_t> cDims(1, 2);  // a dimension for the xvalues and one for the y values
   QVector<size_t> tDims(1);
@@ -334,19 +631,29 @@ FloatArrayType::Pointer DetermineStitching::FindGlobalOriginsLegacy(size_t total
 
   QVector<size_t> combIndexList(xTileList.size());
 
+  // All the windows have the same size so the correlation pipeline is shared by every pair
+  CorrelationContext::Pointer context = CorrelationContext::New();
+  context->setSubPixelPeak(subPixelPeak);
+  if(nullptr != peakToSidelobeRatios.get())
+  {
+    peakToSidelobeRatios->initializeWithZeros();
+  }
+
   //return an index list that puts all the tiles in an order as though they were collected by row combing
   //this is how the stitching algorithm will stitch the tiles together
   combIndexList = ReturnIndexForCombOrder(xTileList, yTileList, numXtiles, numYtiles);
 
-  ImageProcessingConstants::UInt8ImageType* currentImage;
-  ImageProcessingConstants::UInt8ImageType* leftImage;
-  ImageProcessingConstants::UInt8ImageType* aboveImage;
-  ImageProcessingConstants::ImportUInt8FilterType::Pointer importFilter;
-  ImageProcessingConstants::ImportUInt8FilterType::Pointer importFilter2;
+  ConstTileView currentImage;
+  ConstTileView leftImage;
+  ConstTileView aboveImage;
   std::vector<float> cropSpecsIm1Im2(12, 0);
   std::vector<float> newXYOrigin(2, 0);
   std::vector<float> newXYOrigin2(2, 0);
 
+  // The shifts are also kept as pairs so they can be placed by the least squares solver afterwards
+  std::vector<TilePair> pairs;
+  pairs.reserve(2 * combIndexList.size());
+
   //set the stitched global coordinates of the first tile to the top left corner
   xyStitchedGlobalListPtr->setValue(0, 0);
   xyStitchedGlobalListPtr->setValue(1, 0);
@@ -378,12 +685,10 @@ FloatArrayType::Pointer DetermineStitching::FindGlobalOriginsLegacy(size_t total
     if (i < numXtiles) //if the image is in the top row of images, we need only the image to the left
     {
 
-      //get filter to convert m_RawImageData to itk::image
+      //view the tile pixels in place
 
-      importFilter = ITKUtilitiesType::Dream3DtoITKImportFilterDataArray<ImageProcessingConstants::DefaultPixelType>(totalPoints, udims, sampleOrigin, voxelResolution, dataArrayList[combIndexList[i]]);
-      currentImage = importFilter->GetOutput();
-      importFilter2 = ITKUtilitiesType::Dream3DtoITKImportFilterDataArray<ImageProcessingConstants::DefaultPixelType>(totalPoints, udims, sampleOrigin, voxelResolution, dataArrayList[combIndexList[i - 1]]);
-      leftImage = importFilter2->GetOutput();
+      currentImage = ConstTileView(dataArrayList[combIndexList[i]], udims[0], udims[1]);
+      leftImage = ConstTileView(dataArrayList[combIndexList[i - 1]], udims[0], udims[1]);
 
       // Determine the windows to be cross correlated depending on the rough overlap as found from the global coordinates
       cropSpecsIm1Im2[0] = xGlobCoordsList[combIndexList[i]] - xGlobCoordsList[combIndexList[i - 1]]; //xGlobCoordsList[combIndexList[i]] - xyStitchedGlobalListPtr->getValue(2*(i-1)) - xGlobCoordsList[0]; //left image X Origin
@@ -401,7 +706,12 @@ FloatArrayType::Pointer DetermineStitching::FindGlobalOriginsLegacy(size_t total
       cropSpecsIm1Im2[11] = 1; //current image Z Size
 
       //Cross correlate the image windows and return the local shifts between the two images
-      newXYOrigin = CropAndCrossCorrelate(cropSpecsIm1Im2, currentImage, leftImage);
+      newXYOrigin = CropAndCrossCorrelate(cropSpecsIm1Im2, currentImage, leftImage, context.get(), downsampleFactor);
+      if(nullptr != peakToSidelobeRatios.get())
+      {
+        peakToSidelobeRatios->setComponent(combIndexList[i], 0, newXYOrigin[3]);
+      }
+      pairs.push_back(MakeTilePair(i, i - 1, true, cropSpecsIm1Im2, newXYOrigin));
 
       previousXleft = xyStitchedGlobalListPtr->getValue(2 * (i - 1));
       previousYleft = xyStitchedGlobalListPtr->getValue(2 * (i - 1) + 1);
@@ -420,12 +730,10 @@ FloatArrayType::Pointer DetermineStitching::FindGlobalOriginsLegacy(size_t total
     else if (i % numXtiles == 0) //if the image is in the first (left most) column of images, we only need the top image
     {
 
-      //get filter to convert m_RawImageData to itk::image
+      //view the tile pixels in place
 
-      importFilter = ITKUtilitiesType::Dream3DtoITKImportFilterDataArray<ImageProcessingConstants::DefaultPixelType>(totalPoints, udims, sampleOrigin, voxelResolution, dataArrayList[combIndexList[i]]); //combIndexList[i]]
-      currentImage = importFilter->GetOutput();
-      importFilter2 = ITKUtilitiesType::Dream3DtoITKImportFilterDataArray<ImageProcessingConstants::DefaultPixelType>(totalPoints, udims, sampleOrigin, voxelResolution, dataArrayList[combIndexList[i - numXtiles]]);
-      aboveImage = importFilter2->GetOutput();
+      currentImage = ConstTileView(dataArrayList[combIndexList[i]], udims[0], udims[1]);
+      aboveImage = ConstTileView(dataArrayList[combIndexList[i - numXtiles]], udims[0], udims[1]);
 
       // Determine the windows to be cross correlated depending on the rough overlap as found from the global coordinates
 
@@ -445,7 +753,12 @@ FloatArrayType::Pointer DetermineStitching::FindGlobalOriginsLegacy(size_t total
 
 
       //Cross correlate the image windows and return the local shifts between the two images
-      newXYOrigin2 = CropAndCrossCorrelate(cropSpecsIm1Im2, currentImage, aboveImage);
+      newXYOrigin2 = CropAndCrossCorrelate(cropSpecsIm1Im2, currentImage, aboveImage, context.get(), downsampleFactor);
+      if(nullptr != peakToSidelobeRatios.get())
+      {
+        peakToSidelobeRatios->setComponent(combIndexList[i], 1, newXYOrigin2[3]);
+      }
+      pairs.push_back(MakeTilePair(i, i - numXtiles, false, cropSpecsIm1Im2, newXYOrigin2));
 
       previousXtop = xyStitchedGlobalListPtr->getValue(2 * (i - numXtiles));
       previousYtop = xyStitchedGlobalListPtr->getValue(2 * (i - numXtiles) + 1);
@@ -468,12 +781,10 @@ FloatArrayType::Pointer DetermineStitching::FindGlobalOriginsLegacy(size_t total
     else  //for all other images, we need to match to the top and the left
     {
 
-      //get filter to convert m_RawImageData to itk::image
+      //view the tile pixels in place
       ///TOP IMAGE FIRST
-      importFilter = ITKUtilitiesType::Dream3DtoITKImportFilterDataArray<ImageProcessingConstants::DefaultPixelType>(totalPoints, udims, sampleOrigin, voxelResolution, dataArrayList[combIndexList[i]]);
-      currentImage = importFilter->GetOutput();
-      importFilter2 = ITKUtilitiesType::Dream3DtoITKImportFilterDataArray<ImageProcessingConstants::DefaultPixelType>(totalPoints, udims, sampleOrigin, voxelResolution, dataArrayList[combIndexList[i - numXtiles]]);
-      aboveImage = importFilter2->GetOutput();
+      currentImage = ConstTileView(dataArrayList[combIndexList[i]], udims[0], udims[1]);
+      aboveImage = ConstTileView(dataArrayList[combIndexList[i - numXtiles]], udims[0], udims[1]);
 
 
       // Determine the windows to be cross correlated depending on the rough overlap as found from the global coordinates
@@ -493,7 +804,12 @@ FloatArrayType::Pointer DetermineStitching::FindGlobalOriginsLegacy(size_t total
       cropSpecsIm1Im2[11] = 1; //current image Z Size
 
       //Cross correlate the image windows and return the local shifts between the two images
-      newXYOrigin2 = CropAndCrossCorrelate(cropSpecsIm1Im2, currentImage, aboveImage);
+      newXYOrigin2 = CropAndCrossCorrelate(cropSpecsIm1Im2, currentImage, aboveImage, context.get(), downsampleFactor);
+      if(nullptr != peakToSidelobeRatios.get())
+      {
+        peakToSidelobeRatios->setComponent(combIndexList[i], 1, newXYOrigin2[3]);
+      }
+      pairs.push_back(MakeTilePair(i, i - numXtiles, false, cropSpecsIm1Im2, newXYOrigin2));
 
       previousXtop = xyStitchedGlobalListPtr->getValue(2 * (i - numXtiles));
       previousYtop = xyStitchedGlobalListPtr->getValue(2 * (i - numXtiles) + 1);
@@ -503,10 +819,8 @@ FloatArrayType::Pointer DetermineStitching::FindGlobalOriginsLegacy(size_t total
       newYfromtop = previousYtop + newXYOrigin2[1] + cropSpecsIm1Im2[1];
 
       //BOTTOM IMAGE NEXT
-      importFilter = ITKUtilitiesType::Dream3DtoITKImportFilterDataArray<ImageProcessingConstants::DefaultPixelType>(totalPoints, udims, sampleOrigin, voxelResolution, dataArrayList[combIndexList[i]]);
-      currentImage = importFilter->GetOutput();
-      importFilter2 = ITKUtilitiesType::Dream3DtoITKImportFilterDataArray<ImageProcessingConstants::DefaultPixelType>(totalPoints, udims, sampleOrigin, voxelResolution, dataArrayList[combIndexList[i - 1]]);
-      leftImage = importFilter2->GetOutput();
+      currentImage = ConstTileView(dataArrayList[combIndexList[i]], udims[0], udims[1]);
+      leftImage = ConstTileView(dataArrayList[combIndexList[i - 1]], udims[0], udims[1]);
 
       cropSpecsIm1Im2[0] = xGlobCoordsList[combIndexList[i]] - xGlobCoordsList[combIndexList[i - 1]]; //xGlobCoordsList[combIndexList[i]] - xyStitchedGlobalListPtr->getValue(2*(i-1)) - xGlobCoordsList[0]; //left image X Origin
       cropSpecsIm1Im2[1] = 0; //left image Y Origin
@@ -523,7 +837,12 @@ FloatArrayType::Pointer DetermineStitching::FindGlobalOriginsLegacy(size_t total
       cropSpecsIm1Im2[11] = 1; //current image Z Size
 
       //Cross correlate the image windows and return the local shifts between the two images
-      newXYOrigin = CropAndCrossCorrelate(cropSpecsIm1Im2, currentImage, leftImage);
+      newXYOrigin = CropAndCrossCorrelate(cropSpecsIm1Im2, currentImage, leftImage, context.get(), downsampleFactor);
+      if(nullptr != peakToSidelobeRatios.get())
+      {
+        peakToSidelobeRatios->setComponent(combIndexList[i], 0, newXYOrigin[3]);
+      }
+      pairs.push_back(MakeTilePair(i, i - 1, true, cropSpecsIm1Im2, newXYOrigin));
 
       previousXleft = xyStitchedGlobalListPtr->getValue(2 * (i - 1));
       previousYleft = xyStitchedGlobalListPtr->getValue(2 * (i - 1) + 1);
@@ -573,6 +892,10 @@ FloatArrayType::Pointer DetermineStitching::FindGlobalOriginsLegacy(size_t total
     xyStitchedGlobalListPtr_orig->setValue(2 * combIndexList[i] + 1, xyStitchedGlobalListPtr->getValue(2 * i + 1));
   }
 
+  if(placementMode == GlobalLeastSquares)
+  {
+    ApplyGlobalLeastSquares(pairs, combIndexList, xyStitchedGlobalListPtr, xyStitchedGlobalListPtr_orig);
+  }
 
   return xyStitchedGlobalListPtr_orig;
 
@@ -581,140 +904,59 @@ FloatArrayType::Pointer DetermineStitching::FindGlobalOriginsLegacy(size_t total
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-std::vector<float> DetermineStitching::CropAndCrossCorrelate(std::vector<float> cropSpecsIm1Im2,  ImageProcessingConstants::UInt8ImageType* currentImage,  ImageProcessingConstants::UInt8ImageType* fixedImage)
+std::vector<float> DetermineStitching::CropAndCrossCorrelate(std::vector<float> cropSpecsIm1Im2, const ConstTileView& currentTile, const ConstTileView& fixedTile, CorrelationContext* context,
+                                                             size_t downsampleFactor)
 {
-
-  std::vector<float> newXYOrigin(3, 0);
-
-
-
+  // IMPORTANT:
+  // The first 6 values in cropSpecsIm1Im2 are the crop origins of the fixed and current image and the last 6 values are the
+  // crop sizes. The values are truncated to whole pixels the same way an itk::ImageRegion would truncate them and the
+  // windows are clipped to the tiles. The tiles are 2D, so the Z origins and sizes are ignored.
+  CorrelationContext::Pointer localContext;
+  if(nullptr == context)
+  {
+    localContext = CorrelationContext::New();
+    context = localContext.get();
+  }
 
   //////FIRST IMAGE CROP
-  ImageProcessingConstants::UInt8ImageType::RegionType cropRegion;
-
-  cropRegion.SetIndex(0, cropSpecsIm1Im2[0]);
-  cropRegion.SetIndex(1, cropSpecsIm1Im2[1]);
-  cropRegion.SetIndex(2, cropSpecsIm1Im2[2]);
-
-  cropRegion.SetSize(0, cropSpecsIm1Im2[6]);
-  cropRegion.SetSize(1, cropSpecsIm1Im2[7]);
-  cropRegion.SetSize(2, cropSpecsIm1Im2[8]);
-
-  //Extract window from first image
-  typedef itk::RegionOfInterestImageFilter< ImageProcessingConstants::UInt8ImageType, ImageProcessingConstants::UInt8ImageType > exImFilterType;
-  exImFilterType::Pointer exImfilter = exImFilterType::New();
-  exImfilter->SetRegionOfInterest(cropRegion);
-  exImfilter->SetInput(fixedImage);
-  exImfilter->Update();
-  ImageProcessingConstants::UInt8ImageType* fixedImageWindow = exImfilter->GetOutput();
-
-
+  ConstTileView fixedWindow = fixedTile.window(static_cast<size_t>(cropSpecsIm1Im2[0]), static_cast<size_t>(cropSpecsIm1Im2[1]), static_cast<size_t>(cropSpecsIm1Im2[6]),
+                                               static_cast<size_t>(cropSpecsIm1Im2[7]));
 
   /////////////////////SECOND IMAGE CROP
-  ImageProcessingConstants::UInt8ImageType::RegionType cropRegion2;
-  cropRegion2.SetIndex(0, cropSpecsIm1Im2[3]);
-  cropRegion2.SetIndex(1, cropSpecsIm1Im2[4]);
-  cropRegion2.SetIndex(2, cropSpecsIm1Im2[5]);
-
-  cropRegion2.SetSize(0, cropSpecsIm1Im2[9]);
-  cropRegion2.SetSize(1, cropSpecsIm1Im2[10]);
-  cropRegion2.SetSize(2, cropSpecsIm1Im2[11]);
-
-  //Extract window from second image
-  exImFilterType::Pointer exImfilter2 = exImFilterType::New();
-  exImfilter2->SetRegionOfInterest(cropRegion2);
-  exImfilter2->SetInput(currentImage);
-  exImfilter2->Update();
-  ImageProcessingConstants::UInt8ImageType* currentImageWindow = exImfilter2->GetOutput();
-
-
-  ///CHANGE THE ORIGIN OF THE IMAGES SO THEY MATCH - the cross correlation filter will not work unless this is done
-  typedef itk::ChangeInformationImageFilter< ImageProcessingConstants::UInt8ImageType > ChangeInfoFilterType;
-  ImageProcessingConstants::UInt8ImageType::PointType origin = fixedImageWindow->GetOrigin();
-  origin[0] = 0;
-  origin[1] = 0;
-  origin[2] = 0;
-
-  //First the Fixed image
-  ChangeInfoFilterType::Pointer changeInfo = ChangeInfoFilterType::New();
-  changeInfo->SetInput(fixedImageWindow);
-  changeInfo->SetOutputOrigin( origin );
-  changeInfo->ChangeOriginOn();
-  changeInfo->UpdateOutputInformation();
-  ImageProcessingConstants::UInt8ImageType* fixedImageWindow2 = changeInfo->GetOutput();
-
-  //Next the Current Image
-  ChangeInfoFilterType::Pointer changeInfo2 = ChangeInfoFilterType::New();
-  changeInfo2->SetInput(currentImageWindow);
-  changeInfo2->SetOutputOrigin( origin );
-  changeInfo2->ChangeOriginOn();
-  changeInfo2->UpdateOutputInformation();
-  ImageProcessingConstants::UInt8ImageType* currentImageWindow2 = changeInfo2->GetOutput();
-
-
-  /////WRITING THE IMAGES FOR TESTING
-#if 0
-  typedef itk::ImageFileWriter< ImageProcessingConstants::UInt8ImageType > WriterType;
-
-  QString imagePath = QDir::homePath() + QDir::separator() + "Desktop" + QDir::separator() + "fixedImageWindow.tiff";
-  WriterType::Pointer writer = WriterType::New();
-  writer->SetFileName(imagePath.toLatin1().constData());
-  writer->SetInput( fixedImageWindow2);
-  writer->Update();
-
-  imagePath = QDir::homePath() + QDir::separator() + "Desktop" + QDir::separator() + "CurrentImageWindow.tiff";
-  WriterType::Pointer writer2 = WriterType::New();
-  writer2->SetFileName(imagePath.toLatin1().constData());
-  writer2->SetInput( currentImageWindow2 );
-  writer2->Update();
-#endif
-
-
-
+  ConstTileView currentWindow = currentTile.window(static_cast<size_t>(cropSpecsIm1Im2[3]), static_cast<size_t>(cropSpecsIm1Im2[4]), static_cast<size_t>(cropSpecsIm1Im2[9]),
+                                                   static_cast<size_t>(cropSpecsIm1Im2[10]));
 
   //CROSS CORRELATE THE 2 WINDOWS.
   //Note: It is much faster to cross correlate the extracted windows than to cross correlate the full windows with a mask applied
-  typedef itk::MaskedFFTNormalizedCorrelationImageFilter< ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::FloatImageType, ImageProcessingConstants::DefaultImageType > XCFilterType;
-  XCFilterType::Pointer xCorrFilter = XCFilterType::New();
-  xCorrFilter->SetFixedImage(fixedImageWindow2);
-  xCorrFilter->SetMovingImage(currentImageWindow2);
-  xCorrFilter->SetRequiredFractionOfOverlappingPixels(0.5); //currently require that the windows overlap at least 50percent. Might want to make this a user controlled variable
-  xCorrFilter->Update();
-  ImageProcessingConstants::FloatImageType* xcoutputImage = xCorrFilter->GetOutput();
-
-  // Create and initialize the calculator
-  typedef itk::MinimumMaximumImageCalculator<ImageProcessingConstants::FloatImageType>   MinMaxCalculatorType;
-  MinMaxCalculatorType::Pointer calculator = MinMaxCalculatorType::New();
-  calculator->SetImage( xcoutputImage );
-  calculator->Compute();
-
-  //    // Return minimum of intensity
-  //    float minimumResult = calculator->GetMinimum();
-  //    std::cout << "The Minimum intensity value is : " << minimumResult << std::endl;
-  //    std::cout << "Its index position is : " << calculator->GetIndexOfMinimum() << std::endl;
-
-  //    float maximumResult = calculator->GetMaximum();
-  //    std::cout << "The Maximum intensity value is : " << maximumResult << std::endl;
-  //    std::cout << "Its index position is : " << calculator->GetIndexOfMaximum() << std::endl;
-  //    std::cout << "Real Max" << xcoutputImage->GetPixel(calculator->GetIndexOfMaximum()) << std::endl;
-
-  newXYOrigin[0] = float(calculator->GetIndexOfMaximum()[0]) - float(fixedImageWindow2->GetLargestPossibleRegion().GetSize()[0]);
-  newXYOrigin[1] = float(calculator->GetIndexOfMaximum()[1]) - float(fixedImageWindow2->GetLargestPossibleRegion().GetSize()[1]);
-  newXYOrigin[2] = calculator->GetMaximum();  // add this for when more than one image pair has to be xcorrelated - want ot use this value to find best fit location
-
-  // xcoutputImage->SetPixel(calculator->GetIndexOfMaximum(), 0); //just testing to make the brightest pixel dark so I could see which one it is
-
-  //    typedef itk::ImageFileWriter< ImageProcessingConstants::FloatImageType > nWriterType;
-  //    nWriterType::Pointer writer3 = nWriterType::New();
-  //    writer3->SetFileName( "/Users/megnashah/Desktop/imageXC.tiff");
-  //    writer3->SetInput( xcoutputImage );
-  //    writer3->Update();
-
-  return newXYOrigin;
+  //currently require that the windows overlap at least 50percent. Might want to make this a user controlled variable
+  //The returned peak value is kept for when more than one image pair has to be xcorrelated - want ot use this value to find best fit location
+  if(downsampleFactor > 1)
+  {
+    return context->correlateCoarseToFine(fixedWindow.getPointer(), fixedWindow.getStride(), fixedWindow.getWidth(), fixedWindow.getHeight(), currentWindow.getPointer(),
+                                          currentWindow.getStride(), currentWindow.getWidth(), currentWindow.getHeight(), 0.5, downsampleFactor);
+  }
+  return context->correlate(fixedWindow.getPointer(), fixedWindow.getStride(), fixedWindow.getWidth(), fixedWindow.getHeight(), currentWindow.getPointer(), currentWindow.getStride(),
+                            currentWindow.getWidth(), currentWindow.getHeight(), 0.5);
 }
 
 
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t DetermineStitching::SearchDownsampleFactor(int correlationSearch)
+{
+  switch(correlationSearch)
+  {
+  case CoarseToFine4x:
+    return 4;
+  case CoarseToFine8x:
+    return 8;
+  default:
+    return 1;
+  }
+}
+
 //This helper function takes the tile list and creates a new vector that orders the tiles as though they are in comb order. So a tile set collected
 //in a comb fashion (along the rows first) will have the values in the new vector match the original index. This is a helper so that we can always stitch the
 //tiles the same way regardless of how they were collected.
@@ -41,6 +41,9 @@
 #include "SIMPLib/Filtering/AbstractFilter.h"
 #include "SIMPLib/SIMPLib.h"
 
+#include "CorrelationContext.h"
+#include "TileView.hpp"
+
 /**
  * @brief The DetermineStitching class
  */
@@ -50,38 +53,101 @@ class DetermineStitching
 
     virtual ~DetermineStitching();
 
+    /**
+     * @brief The TilePair struct describes a single registration between a tile and one of its
+     * neighbours (the tile to its left or the tile above it) in comb order. The cross correlation
+     * result (x and y shift, peak value and peak to sidelobe ratio) is stored in newXYOrigin once the pair has been computed.
+     */
+    struct TilePair
+    {
+      size_t combIndex = 0;     // Comb order index of the tile being placed
+      size_t neighborIndex = 0; // Comb order index of the neighbour it is matched against
+      bool fromLeft = true;     // true if the neighbour is to the left, false if it is above
+      std::vector<float> cropSpecsIm1Im2;
+      std::vector<float> newXYOrigin;
+    };
+
     /**
    * @brief FindGlobalOrigins
-   * @param totalPoints
    * @param udims
-   * @param sampleOrigin
-   * @param voxelResolution
    * @param dataArrayList
    * @param xGlobCoordsList
    * @param yGlobCoordsList
    * @param xTileList
    * @param yTileList
    * @param obs
+   * @param placementMode One of the PlacementMode values
+   * @param correlationSearch One of the CorrelationSearch values
+   * @param subPixelPeak Refine the correlation peaks to sub pixel positions
+   * @param peakToSidelobeRatios Optional array with 2 components per tile that receives the peak to sidelobe ratios of the
+   * pairs with the left and the top neighbour (0 where there is no such pair)
    * @return
    */
-    static FloatArrayType::Pointer FindGlobalOriginsLegacy(size_t totalPoints,
-                                                     QVector<size_t> udims,
-                                                     float sampleOrigin[],
-                                                     float voxelResolution[],
+    static FloatArrayType::Pointer FindGlobalOriginsLegacy(QVector<size_t> udims,
                                                      QVector<ImageProcessingConstants::DefaultPixelType *> dataArrayList,
                                                      QVector<float> xGlobCoordsList,
                                                      QVector<float> yGlobCoordsList,
                                                      QVector<qint32> xTileList,
                                                      QVector<qint32> yTileList,
-                                                     AbstractFilter *filter = nullptr);
+                                                     AbstractFilter *filter = nullptr,
+                                                     int placementMode = ChainedAverage,
+                                                     int correlationSearch = FullResolution,
+                                                     bool subPixelPeak = false,
+                                                     FloatArrayType::Pointer peakToSidelobeRatios = FloatArrayType::NullPointer());
+
+    /**
+     * @brief The PlacementMode enum selects how the pairwise shifts are turned into tile origins
+     */
+    enum PlacementMode
+    {
+      ChainedAverage = 0,     // Each tile is placed from its already placed top/left neighbours and the two estimates are averaged
+      GlobalLeastSquares = 1  // All tile origins are solved at once from every pairwise shift weighted by its correlation peak
+    };
+
+    /**
+     * @brief The CorrelationSearch enum selects how the peak of each pairwise cross correlation is searched
+     */
+    enum CorrelationSearch
+    {
+      FullResolution = 0, // The full resolution overlap windows are correlated
+      CoarseToFine4x = 1, // The windows are correlated downsampled by up to 4 and the peak is refined at full resolution
+      CoarseToFine8x = 2  // The windows are correlated downsampled by up to 8 and the peak is refined at full resolution
+    };
+
+    /**
+     * @brief SearchDownsampleFactor Returns the largest downsampling factor used by a CorrelationSearch value
+     */
+    static size_t SearchDownsampleFactor(int correlationSearch);
 
 	static FloatArrayType::Pointer FindGlobalOrigins(int xTileCount, int yTileCount,
 		int ImportMode,
 		float overlapPer,
 		QVector<ImageProcessingConstants::DefaultPixelType*> dataArrayList,
 		QVector<size_t> udims,
-		float sampleOrigin[],
-		float voxelResolution[]);
+		int placementMode = ChainedAverage,
+		int correlationSearch = FullResolution,
+		bool subPixelPeak = false,
+		FloatArrayType::Pointer peakToSidelobeRatios = FloatArrayType::NullPointer());
+
+    /**
+     * @brief SolveGlobalOrigins Solves the sparse weighted least squares system that places every tile so the
+     * pairwise shifts are best satisfied at the same time. The first tile in comb order is held at (0, 0).
+     * @param pairs The correlated tile pairs
+     * @param numTiles Number of tiles
+     * @param xyCombOrigins On input the starting guess, on output the solved origins (interleaved x/y, comb order)
+     */
+    static void SolveGlobalOrigins(const std::vector<TilePair>& pairs, size_t numTiles, std::vector<double>& xyCombOrigins);
+
+    /**
+     * @brief ApplyGlobalLeastSquares Replaces the chained placement of the tiles by the solution of SolveGlobalOrigins(),
+     * starting from the chained placement
+     * @param pairs The correlated tile pairs
+     * @param combIndexList
+     * @param xyStitchedGlobalListPtr Tile origins in comb order, updated in place
+     * @param xyStitchedGlobalListPtr_orig Tile origins in the original tile order, updated in place
+     */
+    static void ApplyGlobalLeastSquares(const std::vector<TilePair>& pairs, const QVector<size_t>& combIndexList, FloatArrayType::Pointer xyStitchedGlobalListPtr,
+                                        FloatArrayType::Pointer xyStitchedGlobalListPtr_orig);
 
     /**
    * @brief ReturnIndexForCombOrder
@@ -101,14 +167,48 @@ class DetermineStitching
 	*/
   static QVector<size_t> ReturnProperIndex(int InputMode, int xDims, int yDims);
 
+    /**
+     * @brief BuildTilePairs Creates the list of left and top neighbour pairs that have to be cross correlated
+     * to place every tile. The pairs are listed in the same order the serial comb walk would visit them.
+     * @param numTiles
+     * @param numXtiles
+     * @param udims
+     * @param overlapPer
+     * @return
+     */
+    static std::vector<TilePair> BuildTilePairs(size_t numTiles, size_t numXtiles, QVector<size_t> udims, float overlapPer);
+
+    /**
+     * @brief CrossCorrelateTilePairs Computes the local shift of every pair. The pairs do not depend on each other, so
+     * they are all distributed over the available cores at once when parallel algorithms are enabled. The overlap windows
+     * are read straight from the tile data.
+     * @param pairs
+     * @param combIndexList
+     * @param udims
+     * @param dataArrayList
+     * @param downsampleFactor Largest factor the windows are downsampled by for a coarse to fine search, see
+     * CorrelationContext::correlateCoarseToFine(). 1 correlates the full resolution windows.
+     * @param subPixelPeak Refine the correlation peaks to sub pixel positions
+     */
+    static void CrossCorrelateTilePairs(std::vector<TilePair>& pairs,
+                                        const QVector<size_t>& combIndexList,
+                                        QVector<size_t> udims,
+                                        QVector<ImageProcessingConstants::DefaultPixelType*> dataArrayList,
+                                        size_t downsampleFactor = 1,
+                                        bool subPixelPeak = false);
+
     /**
    * @brief CropAndCrossCorrelate
    * @param cropSpecsIm1Im2
-   * @param currentImage
-   * @param fixedImage
+   * @param currentTile View of the whole current tile
+   * @param fixedTile View of the whole fixed tile
+   * @param context Cached correlation pipelines to use, which also select sub pixel peaks. A temporary context without
+   * sub pixel peaks is created when this is nullptr
+   * @param downsampleFactor Largest factor the windows are downsampled by for a coarse to fine search, 1 correlates them at full resolution
    * @return
    */
-    static std::vector<float> CropAndCrossCorrelate(std::vector<float> cropSpecsIm1Im2, ImageProcessingConstants::UInt8ImageType* currentImage, ImageProcessingConstants::UInt8ImageType* fixedImage);
+    static std::vector<float> CropAndCrossCorrelate(std::vector<float> cropSpecsIm1Im2, const ConstTileView& currentTile, const ConstTileView& fixedTile, CorrelationContext* context = nullptr,
+                                                    size_t downsampleFactor = 1);
 
   protected:
     DetermineStitching();
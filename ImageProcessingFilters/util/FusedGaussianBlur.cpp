@@ -0,0 +1,365 @@
+/* ============================================================================
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the names of any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#include "FusedGaussianBlur.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QObject>
+
+#include "itkGaussianOperator.h"
+
+#include "ImageProcessing/ImageProcessingFilters/util/LinearRescale.hpp"
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_scheduler_init.h>
+#endif
+
+namespace
+{
+// Volumes with fewer slices than this are split into bands of rows, so every core gets work
+const size_t k_MinSlicesWithoutBands = 32;
+const size_t k_RowsPerBand = 64;
+
+/**
+ * @brief The FindRangeImpl class blurs bands of rows and merges their minimum and maximum into the range of the volume.
+ * Band b covers rows [(b % bandsPerSlice) * bandRows, ...) of slice b / bandsPerSlice.
+ */
+class FindRangeImpl
+{
+  public:
+    FindRangeImpl(const FusedGaussianBlur* blur, const uint8_t* input, const size_t* dims, size_t bandRows, float& minimum, float& maximum, QMutex& mutex)
+    : m_Blur(blur)
+    , m_Input(input)
+    , m_Dims(dims)
+    , m_BandRows(bandRows)
+    , m_Minimum(minimum)
+    , m_Maximum(maximum)
+    , m_Mutex(mutex)
+    {
+    }
+    virtual ~FindRangeImpl() = default;
+
+    void convert(size_t start, size_t end) const
+    {
+      const size_t bandsPerSlice = (m_Dims[1] + m_BandRows - 1) / m_BandRows;
+      std::vector<double> zPass;
+      std::vector<double> yPass;
+      std::vector<float> result;
+      float minimum = std::numeric_limits<float>::max();
+      float maximum = std::numeric_limits<float>::lowest();
+      for(size_t band = start; band < end; band++)
+      {
+        const size_t yStart = (band % bandsPerSlice) * m_BandRows;
+        const size_t yEnd = std::min(yStart + m_BandRows, m_Dims[1]);
+        m_Blur->blurRows(m_Input, m_Dims, band / bandsPerSlice, yStart, yEnd, zPass, yPass, result);
+        for(size_t i = 0; i < (yEnd - yStart) * m_Dims[0]; i++)
+        {
+          minimum = std::min(minimum, result[i]);
+          maximum = std::max(maximum, result[i]);
+        }
+      }
+
+      QMutexLocker lock(&m_Mutex);
+      m_Minimum = std::min(m_Minimum, minimum);
+      m_Maximum = std::max(m_Maximum, maximum);
+    }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    void operator()(const tbb::blocked_range<size_t>& r) const
+    {
+      convert(r.begin(), r.end());
+    }
+#endif
+
+  private:
+    const FusedGaussianBlur* m_Blur;
+    const uint8_t* m_Input;
+    const size_t* m_Dims;
+    size_t m_BandRows;
+    float& m_Minimum;
+    float& m_Maximum;
+    QMutex& m_Mutex;
+};
+
+/**
+ * @brief The BlurRescaleImpl class blurs the bands of FindRangeImpl again and writes them rescaled into the output
+ */
+class BlurRescaleImpl
+{
+  public:
+    BlurRescaleImpl(const FusedGaussianBlur* blur, const uint8_t* input, uint8_t* output, const size_t* dims, size_t bandRows, const LinearRescale<uint8_t>& rescale)
+    : m_Blur(blur)
+    , m_Input(input)
+    , m_Output(output)
+    , m_Dims(dims)
+    , m_BandRows(bandRows)
+    , m_Rescale(rescale)
+    {
+    }
+    virtual ~BlurRescaleImpl() = default;
+
+    void convert(size_t start, size_t end) const
+    {
+      const size_t bandsPerSlice = (m_Dims[1] + m_BandRows - 1) / m_BandRows;
+      std::vector<double> zPass;
+      std::vector<double> yPass;
+      std::vector<float> result;
+      for(size_t band = start; band < end; band++)
+      {
+        const size_t z = band / bandsPerSlice;
+        const size_t yStart = (band % bandsPerSlice) * m_BandRows;
+        const size_t yEnd = std::min(yStart + m_BandRows, m_Dims[1]);
+        m_Blur->blurRows(m_Input, m_Dims, z, yStart, yEnd, zPass, yPass, result);
+        uint8_t* rows = m_Output + (z * m_Dims[1] + yStart) * m_Dims[0];
+        for(size_t i = 0; i < (yEnd - yStart) * m_Dims[0]; i++)
+        {
+          rows[i] = m_Rescale(result[i]);
+        }
+      }
+    }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    void operator()(const tbb::blocked_range<size_t>& r) const
+    {
+      convert(r.begin(), r.end());
+    }
+#endif
+
+  private:
+    const FusedGaussianBlur* m_Blur;
+    const uint8_t* m_Input;
+    uint8_t* m_Output;
+    const size_t* m_Dims;
+    size_t m_BandRows;
+    LinearRescale<uint8_t> m_Rescale;
+};
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FusedGaussianBlur::FusedGaussianBlur() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FusedGaussianBlur::~FusedGaussianBlur() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int FusedGaussianBlur::setKernels(double variance, const float spacing[3], double maximumError, unsigned int maximumKernelWidth)
+{
+  for(size_t axis = 0; axis < 3; axis++)
+  {
+    if(spacing[axis] == 0.0f)
+    {
+      m_ErrorMessage = QObject::tr("The spacing along axis %1 is 0").arg(axis);
+      return -1;
+    }
+
+    itk::GaussianOperator<double, 3> gaussianOperator;
+    gaussianOperator.SetDirection(static_cast<unsigned int>(axis));
+    gaussianOperator.SetVariance(variance / (static_cast<double>(spacing[axis]) * static_cast<double>(spacing[axis])));
+    gaussianOperator.SetMaximumError(maximumError);
+    gaussianOperator.SetMaximumKernelWidth(maximumKernelWidth);
+    gaussianOperator.CreateDirectional();
+
+    m_Kernels[axis].resize(gaussianOperator.Size());
+    for(size_t i = 0; i < m_Kernels[axis].size(); i++)
+    {
+      m_Kernels[axis][i] = gaussianOperator[static_cast<unsigned int>(i)];
+    }
+  }
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const std::vector<double>& FusedGaussianBlur::getKernel(size_t axis) const
+{
+  return m_Kernels[axis];
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString FusedGaussianBlur::getErrorMessage() const
+{
+  return m_ErrorMessage;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void FusedGaussianBlur::blurRows(const uint8_t* input, const size_t dims[3], size_t z, size_t yStart, size_t yEnd, std::vector<double>& zPass, std::vector<double>& yPass,
+                                 std::vector<float>& result) const
+{
+  const int64_t width = static_cast<int64_t>(dims[0]);
+  const int64_t height = static_cast<int64_t>(dims[1]);
+  const int64_t depth = static_cast<int64_t>(dims[2]);
+  const size_t planeSize = dims[0] * dims[1];
+
+  // The y convolution of the band reads the z convolution of yRadius extra rows on either side
+  const std::vector<double>& yKernel = m_Kernels[1];
+  const int64_t yRadius = static_cast<int64_t>(yKernel.size() / 2);
+  const int64_t zRowStart = std::max(static_cast<int64_t>(yStart) - yRadius, int64_t(0));
+  const int64_t zRowEnd = std::min(static_cast<int64_t>(yEnd) + yRadius, height);
+  const int64_t bandHeight = static_cast<int64_t>(yEnd - yStart);
+  zPass.resize(static_cast<size_t>((zRowEnd - zRowStart) * width));
+  yPass.resize(static_cast<size_t>(bandHeight * width));
+  result.resize(yPass.size());
+
+  // Voxels outside of the volume repeat the nearest boundary voxel, like itk::ZeroFluxNeumannBoundaryCondition
+  const std::vector<double>& zKernel = m_Kernels[2];
+  const int64_t zRadius = static_cast<int64_t>(zKernel.size() / 2);
+  std::fill(zPass.begin(), zPass.end(), 0.0);
+  for(int64_t k = 0; k < static_cast<int64_t>(zKernel.size()); k++)
+  {
+    const int64_t sourceZ = std::min(std::max(static_cast<int64_t>(z) + k - zRadius, int64_t(0)), depth - 1);
+    const uint8_t* source = input + static_cast<size_t>(sourceZ) * planeSize + static_cast<size_t>(zRowStart * width);
+    const double weight = zKernel[k];
+    for(size_t i = 0; i < zPass.size(); i++)
+    {
+      zPass[i] += weight * static_cast<double>(source[i]);
+    }
+  }
+
+  for(int64_t y = 0; y < bandHeight; y++)
+  {
+    double* row = &yPass[static_cast<size_t>(y * width)];
+    std::fill(row, row + width, 0.0);
+    for(int64_t k = 0; k < static_cast<int64_t>(yKernel.size()); k++)
+    {
+      const int64_t sourceY = std::min(std::max(static_cast<int64_t>(yStart) + y + k - yRadius, int64_t(0)), height - 1);
+      const double* source = &zPass[static_cast<size_t>((sourceY - zRowStart) * width)];
+      const double weight = yKernel[k];
+      for(int64_t x = 0; x < width; x++)
+      {
+        row[x] += weight * source[x];
+      }
+    }
+  }
+
+  // Only the columns within xRadius of either edge need their taps clamped
+  const std::vector<double>& xKernel = m_Kernels[0];
+  const int64_t xSize = static_cast<int64_t>(xKernel.size());
+  const int64_t xRadius = xSize / 2;
+  const int64_t interiorEnd = width - (xSize - 1 - xRadius);
+  for(int64_t y = 0; y < bandHeight; y++)
+  {
+    const double* row = &yPass[static_cast<size_t>(y * width)];
+    float* destination = &result[static_cast<size_t>(y * width)];
+    for(int64_t x = 0; x < width; x++)
+    {
+      double sum = 0.0;
+      if(x >= xRadius && x < interiorEnd)
+      {
+        const double* source = row + (x - xRadius);
+        for(int64_t k = 0; k < xSize; k++)
+        {
+          sum += xKernel[k] * source[k];
+        }
+      }
+      else
+      {
+        for(int64_t k = 0; k < xSize; k++)
+        {
+          const int64_t sourceX = std::min(std::max(x + k - xRadius, int64_t(0)), width - 1);
+          sum += xKernel[k] * row[sourceX];
+        }
+      }
+      destination[x] = static_cast<float>(sum);
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int FusedGaussianBlur::execute(const uint8_t* input, uint8_t* output, const size_t dims[3])
+{
+  if(m_Kernels[0].empty() || m_Kernels[1].empty() || m_Kernels[2].empty())
+  {
+    m_ErrorMessage = QObject::tr("The blur kernels have not been set");
+    return -2;
+  }
+  if(dims[0] == 0 || dims[1] == 0 || dims[2] == 0)
+  {
+    return 0;
+  }
+
+  const size_t bandRows = (dims[2] < k_MinSlicesWithoutBands) ? k_RowsPerBand : dims[1];
+  const size_t numBands = dims[2] * ((dims[1] + bandRows - 1) / bandRows);
+
+  float minimum = std::numeric_limits<float>::max();
+  float maximum = std::numeric_limits<float>::lowest();
+  QMutex rangeMutex;
+  FindRangeImpl findRange(this, input, dims, bandRows, minimum, maximum, rangeMutex);
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  tbb::task_scheduler_init init;
+  bool doParallel = true;
+#endif
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  if(doParallel)
+  {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, numBands), findRange, tbb::auto_partitioner());
+  }
+  else
+#endif
+  {
+    findRange.convert(0, numBands);
+  }
+
+  LinearRescale<uint8_t> rescale(minimum, maximum, 0, 255);
+  BlurRescaleImpl blurRescale(this, input, output, dims, bandRows, rescale);
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  if(doParallel)
+  {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, numBands), blurRescale, tbb::auto_partitioner());
+  }
+  else
+#endif
+  {
+    blurRescale.convert(0, numBands);
+  }
+  return 0;
+}
@@ -0,0 +1,105 @@
+/* ============================================================================
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the names of any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <QtCore/QString>
+
+#include "SIMPLib/Common/SIMPLibSetGetMacros.h"
+#include "SIMPLib/SIMPLib.h"
+
+/**
+ * @brief The FusedGaussianBlur class blurs an 8 bit volume with the separable kernels of
+ * itk::DiscreteGaussianImageFilter and rescales the blurred intensities onto [0, 255] like a following
+ * itk::RescaleIntensityImageFilter, without the whole volume float and double images of that pipeline.
+ *
+ * Every z slice is convolved along z, y and x (the order of the ITK filter) through scratch buffers of at most a plane.
+ * Volumes with few slices are split into bands of rows, so thin stacks still use every core. A first parallel sweep only
+ * tracks the minimum and maximum of the blurred volume, a second sweep blurs again and writes the rescaled values
+ * straight into the output.
+ */
+class FusedGaussianBlur
+{
+  public:
+    SIMPL_SHARED_POINTERS(FusedGaussianBlur)
+    SIMPL_STATIC_NEW_MACRO(FusedGaussianBlur)
+
+    virtual ~FusedGaussianBlur();
+
+    /**
+     * @brief setKernels Builds the kernel of every axis with itk::GaussianOperator
+     * @param variance Variance in physical units
+     * @param spacing Voxel spacing, the variance of an axis is divided by the square of its spacing
+     * @param maximumError Kernel truncation error, as in itk::DiscreteGaussianImageFilter
+     * @param maximumKernelWidth Largest kernel width, as in itk::DiscreteGaussianImageFilter
+     * @return 0 on success, a negative value otherwise. See getErrorMessage()
+     */
+    int setKernels(double variance, const float spacing[3], double maximumError = 0.01, unsigned int maximumKernelWidth = 32);
+
+    /**
+     * @brief execute Blurs input into output
+     * @param input Row major volume of dims[0] x dims[1] x dims[2] voxels
+     * @param output Buffer of the same size as input
+     * @param dims Volume dimensions
+     * @return 0 on success, a negative value otherwise. See getErrorMessage()
+     */
+    int execute(const uint8_t* input, uint8_t* output, const size_t dims[3]);
+
+    /**
+     * @brief getKernel Returns the kernel of axis 0, 1 or 2
+     */
+    const std::vector<double>& getKernel(size_t axis) const;
+
+    QString getErrorMessage() const;
+
+    /**
+     * @brief blurRows Convolves rows [yStart, yEnd) of z slice of input into result
+     * @param zPass Scratch buffer for the z convolution
+     * @param yPass Scratch buffer for the y convolution
+     * @param result Resized to (yEnd - yStart) rows
+     */
+    void blurRows(const uint8_t* input, const size_t dims[3], size_t z, size_t yStart, size_t yEnd, std::vector<double>& zPass, std::vector<double>& yPass, std::vector<float>& result) const;
+
+  protected:
+    FusedGaussianBlur();
+
+  private:
+    std::vector<double> m_Kernels[3];
+    QString m_ErrorMessage;
+
+  public:
+    FusedGaussianBlur(const FusedGaussianBlur&) = delete; // Copy Constructor Not Implemented
+    FusedGaussianBlur(FusedGaussianBlur&&) = delete;      // Move Constructor Not Implemented
+    FusedGaussianBlur& operator=(const FusedGaussianBlur&) = delete; // Copy Assignment Not Implemented
+    FusedGaussianBlur& operator=(FusedGaussianBlur&&) = delete;      // Move Assignment Not Implemented
+};
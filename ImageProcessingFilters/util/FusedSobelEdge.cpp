@@ -0,0 +1,384 @@
+/* ============================================================================
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the names of any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#include "FusedSobelEdge.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QObject>
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_scheduler_init.h>
+#endif
+
+#include "ImageProcessing/ImageProcessingFilters/util/LinearRescale.hpp"
+
+namespace
+{
+/**
+ * @brief ClampIndex Maps an index outside of [0, size) onto the nearest boundary voxel
+ */
+inline size_t ClampIndex(int64_t index, size_t size)
+{
+  return static_cast<size_t>(std::min(std::max(index, int64_t(0)), static_cast<int64_t>(size) - 1));
+}
+
+/**
+ * @brief Magnitude Returns the length of a gradient, summed and rooted in the precision of
+ * itk::SobelEdgeDetectionImageFilter
+ */
+inline float Magnitude(int32_t gx, int32_t gy, int32_t gz)
+{
+  float sum = static_cast<float>(gx) * static_cast<float>(gx);
+  sum += static_cast<float>(gy) * static_cast<float>(gy);
+  sum += static_cast<float>(gz) * static_cast<float>(gz);
+  return static_cast<float>(std::sqrt(static_cast<double>(sum)));
+}
+
+/**
+ * @brief The SobelRows class holds the 3 x 3 input rows around an output row, rows[b][c] being the row at y + b - 1 and
+ * z + c - 1
+ */
+struct SobelRows
+{
+  const uint8_t* rows[3][3];
+
+  SobelRows(const uint8_t* input, const size_t* dims, size_t y, size_t z, bool volume)
+  {
+    for(int64_t c = -1; c <= 1; c++)
+    {
+      const size_t zIndex = volume ? ClampIndex(static_cast<int64_t>(z) + c, dims[2]) : z;
+      for(int64_t b = -1; b <= 1; b++)
+      {
+        rows[b + 1][c + 1] = input + (zIndex * dims[1] + ClampIndex(static_cast<int64_t>(y) + b, dims[1])) * dims[0];
+      }
+    }
+  }
+
+  /**
+   * @brief magnitude3D Returns the gradient magnitude at x with the 3D itk::SobelOperator, which weights the 3 x 3
+   * differences across an axis by 6 at the center, 3 at the edges and 1 at the corners. The neighbours xm and xp are
+   * clamped by the caller, which only happens in the first and last column
+   */
+  inline float magnitude3D(size_t xm, size_t x, size_t xp) const
+  {
+    const size_t xs[3] = {xm, x, xp};
+    int32_t gx = 0;
+    int32_t gy = 0;
+    int32_t gz = 0;
+    for(int i = 0; i < 3; i++)
+    {
+      for(int j = 0; j < 3; j++)
+      {
+        const int32_t weight = k_Weights[i][j];
+        gx += weight * (rows[i][j][xp] - rows[i][j][xm]);
+        gy += weight * (rows[2][j][xs[i]] - rows[0][j][xs[i]]);
+        gz += weight * (rows[j][2][xs[i]] - rows[j][0][xs[i]]);
+      }
+    }
+    return Magnitude(gx, gy, gz);
+  }
+
+  /**
+   * @brief interiorMagnitude3D Returns magnitude3D(x - 1, x, x + 1) for a column with both neighbours inside of the
+   * row, reading the taps at fixed offsets from x
+   */
+  inline float interiorMagnitude3D(size_t x) const
+  {
+    int32_t gx = 0;
+    int32_t gy = 0;
+    int32_t gz = 0;
+    for(int i = 0; i < 3; i++)
+    {
+      for(int j = 0; j < 3; j++)
+      {
+        const int32_t weight = k_Weights[i][j];
+        const size_t xi = x + i - 1;
+        gx += weight * (rows[i][j][x + 1] - rows[i][j][x - 1]);
+        gy += weight * (rows[2][j][xi] - rows[0][j][xi]);
+        gz += weight * (rows[j][2][xi] - rows[j][0][xi]);
+      }
+    }
+    return Magnitude(gx, gy, gz);
+  }
+
+  /**
+   * @brief magnitude2D Returns the gradient magnitude at x with the 2D itk::SobelOperator in the slice of the center
+   * rows
+   */
+  inline float magnitude2D(size_t xm, size_t x, size_t xp) const
+  {
+    const uint8_t* above = rows[0][1];
+    const uint8_t* center = rows[1][1];
+    const uint8_t* below = rows[2][1];
+    const int32_t gx = (above[xp] - above[xm]) + 2 * (center[xp] - center[xm]) + (below[xp] - below[xm]);
+    const int32_t gy = (below[xm] - above[xm]) + 2 * (below[x] - above[x]) + (below[xp] - above[xp]);
+    return Magnitude(gx, gy, 0);
+  }
+
+  static const int32_t k_Weights[3][3];
+};
+
+const int32_t SobelRows::k_Weights[3][3] = {{1, 3, 1}, {3, 6, 3}, {1, 3, 1}};
+
+/**
+ * @brief SobelRow Writes the gradient magnitudes of row y of z slice into magnitudes, in 3D for a volume and in 2D
+ * otherwise. Only the first and last column clamp their neighbours
+ */
+void SobelRow(const uint8_t* input, const size_t* dims, size_t y, size_t z, bool volume, float* magnitudes)
+{
+  const SobelRows rows(input, dims, y, z, volume);
+  const size_t last = dims[0] - 1;
+  if(volume)
+  {
+    magnitudes[0] = rows.magnitude3D(0, 0, std::min<size_t>(1, last));
+    for(size_t x = 1; x < last; x++)
+    {
+      magnitudes[x] = rows.interiorMagnitude3D(x);
+    }
+    if(last > 0)
+    {
+      magnitudes[last] = rows.magnitude3D(last - 1, last, last);
+    }
+  }
+  else
+  {
+    magnitudes[0] = rows.magnitude2D(0, 0, std::min<size_t>(1, last));
+    for(size_t x = 1; x < last; x++)
+    {
+      magnitudes[x] = rows.magnitude2D(x - 1, x, x + 1);
+    }
+    if(last > 0)
+    {
+      magnitudes[last] = rows.magnitude2D(last - 1, last, last);
+    }
+  }
+}
+
+/**
+ * @brief The FindRangeImpl class finds the smallest and largest gradient magnitude of a range of rows, row r being
+ * row r % dims[1] of slice r / dims[1]
+ */
+class FindRangeImpl
+{
+  public:
+    FindRangeImpl(const uint8_t* input, const size_t* dims, float& minimum, float& maximum, QMutex& mutex)
+    : m_Input(input)
+    , m_Dims(dims)
+    , m_Minimum(minimum)
+    , m_Maximum(maximum)
+    , m_Mutex(mutex)
+    {
+    }
+
+    void convert(size_t start, size_t end) const
+    {
+      std::vector<float> magnitudes(m_Dims[0]);
+      float minimum = std::numeric_limits<float>::max();
+      float maximum = std::numeric_limits<float>::lowest();
+      for(size_t row = start; row < end; row++)
+      {
+        SobelRow(m_Input, m_Dims, row % m_Dims[1], row / m_Dims[1], true, magnitudes.data());
+        for(const float value : magnitudes)
+        {
+          minimum = std::min(minimum, value);
+          maximum = std::max(maximum, value);
+        }
+      }
+
+      QMutexLocker lock(&m_Mutex);
+      m_Minimum = std::min(m_Minimum, minimum);
+      m_Maximum = std::max(m_Maximum, maximum);
+    }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    void operator()(const tbb::blocked_range<size_t>& r) const
+    {
+      convert(r.begin(), r.end());
+    }
+#endif
+
+  private:
+    const uint8_t* m_Input;
+    const size_t* m_Dims;
+    float& m_Minimum;
+    float& m_Maximum;
+    QMutex& m_Mutex;
+};
+
+/**
+ * @brief The EdgeRescaleImpl class computes the gradient magnitudes of a range of rows again and writes them rescaled
+ * into the output
+ */
+class EdgeRescaleImpl
+{
+  public:
+    EdgeRescaleImpl(const uint8_t* input, uint8_t* output, const size_t* dims, const LinearRescale<uint8_t>& rescale)
+    : m_Input(input)
+    , m_Output(output)
+    , m_Dims(dims)
+    , m_Rescale(rescale)
+    {
+    }
+
+    void convert(size_t start, size_t end) const
+    {
+      std::vector<float> magnitudes(m_Dims[0]);
+      for(size_t row = start; row < end; row++)
+      {
+        SobelRow(m_Input, m_Dims, row % m_Dims[1], row / m_Dims[1], true, magnitudes.data());
+        uint8_t* output = m_Output + row * m_Dims[0];
+        for(size_t x = 0; x < m_Dims[0]; x++)
+        {
+          output[x] = m_Rescale(magnitudes[x]);
+        }
+      }
+    }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    void operator()(const tbb::blocked_range<size_t>& r) const
+    {
+      convert(r.begin(), r.end());
+    }
+#endif
+
+  private:
+    const uint8_t* m_Input;
+    uint8_t* m_Output;
+    const size_t* m_Dims;
+    const LinearRescale<uint8_t>& m_Rescale;
+};
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FusedSobelEdge::FusedSobelEdge() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FusedSobelEdge::~FusedSobelEdge() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString FusedSobelEdge::getErrorMessage() const
+{
+  return m_ErrorMessage;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void FusedSobelEdge::executeSlice(const uint8_t* input, uint8_t* output, const size_t dims[3], size_t z) const
+{
+  if(dims[0] == 0 || dims[1] == 0)
+  {
+    return;
+  }
+
+  const size_t planeSize = dims[0] * dims[1];
+  std::vector<float> magnitudes(planeSize);
+  for(size_t y = 0; y < dims[1]; y++)
+  {
+    SobelRow(input, dims, y, z, false, magnitudes.data() + y * dims[0]);
+  }
+  const auto range = std::minmax_element(magnitudes.begin(), magnitudes.end());
+
+  const LinearRescale<uint8_t> rescale(*range.first, *range.second, 0, 255);
+  uint8_t* slice = output + z * planeSize;
+  for(size_t i = 0; i < planeSize; i++)
+  {
+    slice[i] = rescale(magnitudes[i]);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int FusedSobelEdge::execute(const uint8_t* input, uint8_t* output, const size_t dims[3])
+{
+  if(nullptr == input || nullptr == output || input == output)
+  {
+    m_ErrorMessage = QObject::tr("The edge filter needs separate input and output buffers");
+    return -1;
+  }
+  if(dims[0] == 0 || dims[1] == 0 || dims[2] == 0)
+  {
+    return 0;
+  }
+
+  //rows rather than slices are the work items so thin volumes still keep every thread busy
+  const size_t numRows = dims[1] * dims[2];
+  float minimum = std::numeric_limits<float>::max();
+  float maximum = std::numeric_limits<float>::lowest();
+  QMutex rangeMutex;
+  FindRangeImpl findRange(input, dims, minimum, maximum, rangeMutex);
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  tbb::task_scheduler_init init;
+  bool doParallel = true;
+#endif
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  if(doParallel)
+  {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, numRows), findRange, tbb::auto_partitioner());
+  }
+  else
+#endif
+  {
+    findRange.convert(0, numRows);
+  }
+
+  LinearRescale<uint8_t> rescale(minimum, maximum, 0, 255);
+  EdgeRescaleImpl edgeRescale(input, output, dims, rescale);
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  if(doParallel)
+  {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, numRows), edgeRescale, tbb::auto_partitioner());
+  }
+  else
+#endif
+  {
+    edgeRescale.convert(0, numRows);
+  }
+  return 0;
+}
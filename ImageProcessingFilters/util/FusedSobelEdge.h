@@ -0,0 +1,86 @@
+/* ============================================================================
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the names of any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#pragma once
+
+#include <cstdint>
+
+#include <QtCore/QString>
+
+#include "SIMPLib/Common/SIMPLibSetGetMacros.h"
+#include "SIMPLib/SIMPLib.h"
+
+/**
+ * @brief The FusedSobelEdge class computes the Sobel gradient magnitude of an 8 bit volume with the operator weights of
+ * itk::SobelEdgeDetectionImageFilter and rescales it onto [0, 255] like a following itk::RescaleIntensityImageFilter,
+ * without the float image of that pipeline. Voxels outside of the volume repeat the nearest boundary voxel.
+ *
+ * The magnitudes are computed one row at a time. For a whole volume a first parallel sweep over the rows only tracks
+ * their minimum and maximum and a second sweep computes them again and writes the rescaled values straight into the
+ * output. A single slice is filtered in 2D through a slice sized scratch buffer and rescaled on its own range.
+ */
+class FusedSobelEdge
+{
+  public:
+    SIMPL_SHARED_POINTERS(FusedSobelEdge)
+    SIMPL_STATIC_NEW_MACRO(FusedSobelEdge)
+
+    virtual ~FusedSobelEdge();
+
+    /**
+     * @brief execute Writes the rescaled 3D gradient magnitude of input into output
+     * @param input Row major volume of dims[0] x dims[1] x dims[2] voxels
+     * @param output Buffer of the same size as input, must not overlap it
+     * @param dims Volume dimensions
+     * @return 0 on success, a negative value otherwise. See getErrorMessage()
+     */
+    int execute(const uint8_t* input, uint8_t* output, const size_t dims[3]);
+
+    /**
+     * @brief executeSlice Writes the rescaled 2D gradient magnitude of z slice of input into the same slice of output.
+     * Different slices may be filtered concurrently. Input and output must be separate buffers of dims[0] x dims[1] x
+     * dims[2] voxels
+     */
+    void executeSlice(const uint8_t* input, uint8_t* output, const size_t dims[3], size_t z) const;
+
+    QString getErrorMessage() const;
+
+  protected:
+    FusedSobelEdge();
+
+  private:
+    QString m_ErrorMessage;
+
+  public:
+    FusedSobelEdge(const FusedSobelEdge&) = delete; // Copy Constructor Not Implemented
+    FusedSobelEdge(FusedSobelEdge&&) = delete;      // Move Constructor Not Implemented
+    FusedSobelEdge& operator=(const FusedSobelEdge&) = delete; // Copy Assignment Not Implemented
+    FusedSobelEdge& operator=(FusedSobelEdge&&) = delete;      // Move Assignment Not Implemented
+};
@@ -0,0 +1,257 @@
+/* ============================================================================
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the names of any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#include "HistogramCache.h"
+
+#include <algorithm>
+
+#include <QtCore/QMutexLocker>
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_scheduler_init.h>
+#endif
+
+namespace
+{
+/**
+ * @brief The CountSlicesImpl class counts the values of a range of z slices, every slice into its own histogram
+ */
+class CountSlicesImpl
+{
+  public:
+    CountSlicesImpl(const uint8_t* input, size_t planeSize, uint64_t* slices)
+    : m_Input(input)
+    , m_PlaneSize(planeSize)
+    , m_Slices(slices)
+    {
+    }
+
+    void convert(size_t start, size_t end) const
+    {
+      const size_t numBins = ImageHistogram::NumBins;
+      for(size_t z = start; z < end; z++)
+      {
+        // runs of equal values would serialize on a single counter, so 4 interleaved counters are summed at the end
+        std::vector<uint64_t> counts(4 * numBins, 0);
+        const uint8_t* values = m_Input + z * m_PlaneSize;
+        size_t i = 0;
+        for(; i + 4 <= m_PlaneSize; i += 4)
+        {
+          counts[values[i]]++;
+          counts[numBins + values[i + 1]]++;
+          counts[2 * numBins + values[i + 2]]++;
+          counts[3 * numBins + values[i + 3]]++;
+        }
+        for(; i < m_PlaneSize; i++)
+        {
+          counts[values[i]]++;
+        }
+
+        uint64_t* histogram = m_Slices + z * numBins;
+        for(size_t bin = 0; bin < numBins; bin++)
+        {
+          histogram[bin] = counts[bin] + counts[numBins + bin] + counts[2 * numBins + bin] + counts[3 * numBins + bin];
+        }
+      }
+    }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    void operator()(const tbb::blocked_range<size_t>& r) const
+    {
+      convert(r.begin(), r.end());
+    }
+#endif
+
+  private:
+    const uint8_t* m_Input;
+    size_t m_PlaneSize;
+    uint64_t* m_Slices;
+};
+
+/**
+ * @brief ForEachSlice Runs a slice filter over all z slices
+ */
+template <typename SliceFilter>
+void ForEachSlice(const SliceFilter& sliceFilter, size_t numSlices)
+{
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  tbb::task_scheduler_init init;
+  bool doParallel = true;
+#endif
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  if(doParallel)
+  {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, numSlices), sliceFilter, tbb::auto_partitioner());
+  }
+  else
+#endif
+  {
+    sliceFilter.convert(0, numSlices);
+  }
+}
+
+/**
+ * @brief ComputeHistogram Counts the values of every z slice in parallel and sums the slices into the whole image
+ * histogram
+ */
+std::shared_ptr<ImageHistogram> ComputeHistogram(const uint8_t* data, size_t numValues, size_t planeSize)
+{
+  std::shared_ptr<ImageHistogram> histogram = std::make_shared<ImageHistogram>();
+  histogram->numSlices = numValues / planeSize;
+  histogram->volume.assign(ImageHistogram::NumBins, 0);
+  histogram->slices.assign(histogram->numSlices * ImageHistogram::NumBins, 0);
+  ForEachSlice(CountSlicesImpl(data, planeSize, histogram->slices.data()), histogram->numSlices);
+
+  for(size_t z = 0; z < histogram->numSlices; z++)
+  {
+    const uint64_t* slice = histogram->slice(z);
+    for(size_t bin = 0; bin < ImageHistogram::NumBins; bin++)
+    {
+      histogram->volume[bin] += slice[bin];
+    }
+  }
+  return histogram;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+HistogramCache::HistogramCache() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+HistogramCache::~HistogramCache() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+HistogramCache* HistogramCache::Instance()
+{
+  static HistogramCache self;
+  return &self;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+std::shared_ptr<const ImageHistogram> HistogramCache::getHistogram(AbstractFilter* reader, const DataArray<uint8_t>::Pointer& array, size_t planeSize)
+{
+  if(nullptr == array.get())
+  {
+    return nullptr;
+  }
+  const size_t numValues = array->getSize();
+  if(numValues == 0)
+  {
+    std::shared_ptr<ImageHistogram> histogram = std::make_shared<ImageHistogram>();
+    histogram->volume.assign(ImageHistogram::NumBins, 0);
+    return histogram;
+  }
+  // an array that does not split into whole slices is treated as a single slice
+  if(planeSize == 0 || numValues % planeSize != 0)
+  {
+    planeSize = numValues;
+  }
+  const uint8_t* data = array->getPointer(0);
+  // an entry stamped by the filter right before reader was not written since, no other filter ran in between and the
+  // stamping filter only read the array
+  const AbstractFilter* previousFilter = nullptr != reader ? reader->getPreviousFilter().lock().get() : nullptr;
+
+  {
+    QMutexLocker locker(&m_Mutex);
+    QHash<const IDataArray*, Entry>::iterator iter = m_Entries.find(array.get());
+    if(iter != m_Entries.end() && nullptr != previousFilter && iter->lastReader == previousFilter && iter->array.lock() == array && iter->data == data &&
+       iter->numValues == numValues && iter->planeSize == planeSize)
+    {
+      iter->lastReader = reader;
+      return iter->histogram;
+    }
+  }
+
+  // The values are counted without holding the lock so other threads can use the cache in the mean time
+  Entry entry;
+  entry.array = array;
+  entry.data = data;
+  entry.numValues = numValues;
+  entry.planeSize = planeSize;
+  entry.lastReader = reader;
+  entry.histogram = ComputeHistogram(data, numValues, planeSize);
+
+  QMutexLocker locker(&m_Mutex);
+  // drop the entries of deleted arrays
+  QHash<const IDataArray*, Entry>::iterator iter = m_Entries.begin();
+  while(iter != m_Entries.end())
+  {
+    if(iter->array.expired())
+    {
+      iter = m_Entries.erase(iter);
+    }
+    else
+    {
+      ++iter;
+    }
+  }
+  m_Entries.insert(array.get(), entry);
+  return entry.histogram;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+HistogramCache::ItkHistogramType::Pointer HistogramCache::CreateItkHistogram(const uint64_t* counts, unsigned int numBins, double lowerBound, double upperBound)
+{
+  ItkHistogramType::Pointer histogram = ItkHistogramType::New();
+  histogram->SetMeasurementVectorSize(1);
+  ItkHistogramType::SizeType size(1);
+  size[0] = numBins;
+  ItkHistogramType::MeasurementVectorType lower(1);
+  ItkHistogramType::MeasurementVectorType upper(1);
+  lower[0] = lowerBound;
+  upper[0] = upperBound;
+  histogram->Initialize(size, lower, upper);
+
+  ItkHistogramType::MeasurementVectorType measurement(1);
+  ItkHistogramType::IndexType index(1);
+  for(size_t value = 0; value < ImageHistogram::NumBins; value++)
+  {
+    measurement[0] = static_cast<double>(value);
+    if(counts[value] > 0 && histogram->GetIndex(measurement, index))
+    {
+      histogram->IncreaseFrequencyOfIndex(index, static_cast<ItkHistogramType::AbsoluteFrequencyType>(counts[value]));
+    }
+  }
+  return histogram;
+}
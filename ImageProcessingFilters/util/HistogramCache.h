@@ -0,0 +1,125 @@
+/* ============================================================================
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the names of any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/Filtering/AbstractFilter.h"
+
+#include "itkHistogram.h"
+
+/**
+ * @brief The ImageHistogram struct holds the 256 bin histogram of every z slice of an 8 bit image and of the whole
+ * image, so slice at a time and whole volume filters are served by the same scan
+ */
+struct ImageHistogram
+{
+  static const size_t NumBins = 256;
+
+  size_t numSlices = 0;
+  std::vector<uint64_t> volume;
+  // numSlices consecutive histograms
+  std::vector<uint64_t> slices;
+
+  const uint64_t* slice(size_t z) const
+  {
+    return slices.data() + z * NumBins;
+  }
+};
+
+/**
+ * @brief The HistogramCache class is a process wide cache of the histograms of 8 bit arrays, so trying several
+ * threshold methods on the same array one after another scans it once. A histogram is computed in one parallel pass
+ * over the z slices.
+ *
+ * Entries are keyed by the identity, buffer and size of the array. SIMPL arrays have no modification counter, so an
+ * entry is stamped with the filter that last read it instead, and a filter only reuses an entry whose stamp is the
+ * filter right before it in the pipeline. No other filter can have written the array in between, so a hit reads none
+ * of the values. Any other filter in between, or a new execution of the pipeline, costs a new scan. An entry is dropped
+ * once its array is deleted. All methods may be called from several threads at once.
+ */
+class HistogramCache
+{
+  public:
+    using ItkHistogramType = itk::Statistics::Histogram<double>;
+
+    /**
+     * @brief Instance Returns the cache shared by all filters
+     */
+    static HistogramCache* Instance();
+
+    virtual ~HistogramCache();
+
+    /**
+     * @brief getHistogram Returns the histograms of an array, reusing the cached ones only if they were last read by
+     * the filter right before reader in the pipeline
+     * @param reader Filter that reads the histograms, the new stamp of the entry
+     * @param array Array of numSlices x planeSize values
+     * @param planeSize Number of values of a z slice
+     */
+    std::shared_ptr<const ImageHistogram> getHistogram(AbstractFilter* reader, const DataArray<uint8_t>::Pointer& array, size_t planeSize);
+
+    /**
+     * @brief CreateItkHistogram Fills an itk histogram of numBins bins over [lowerBound, upperBound) with 256 value counts,
+     * each value counted in the bin itk::Statistics::ImageToHistogramFilter would put it in
+     */
+    static ItkHistogramType::Pointer CreateItkHistogram(const uint64_t* counts, unsigned int numBins, double lowerBound, double upperBound);
+
+  protected:
+    HistogramCache();
+
+  private:
+    struct Entry
+    {
+      std::weak_ptr<IDataArray> array;
+      const void* data = nullptr;
+      size_t numValues = 0;
+      size_t planeSize = 0;
+      // only compared, never dereferenced
+      const AbstractFilter* lastReader = nullptr;
+      std::shared_ptr<const ImageHistogram> histogram;
+    };
+
+    QMutex m_Mutex;
+    QHash<const IDataArray*, Entry> m_Entries;
+
+  public:
+    HistogramCache(const HistogramCache&) = delete; // Copy Constructor Not Implemented
+    HistogramCache(HistogramCache&&) = delete;      // Move Constructor Not Implemented
+    HistogramCache& operator=(const HistogramCache&) = delete; // Copy Assignment Not Implemented
+    HistogramCache& operator=(HistogramCache&&) = delete;      // Move Assignment Not Implemented
+};
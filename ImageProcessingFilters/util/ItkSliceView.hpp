@@ -0,0 +1,139 @@
+/* ============================================================================
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the names of any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+#include "itkImage.h"
+
+#include "SIMPLib/ITK/itkSupportConstants.h"
+
+/**
+ * @brief The ItkSliceView class wraps a z plane of a volume as a 2D itk::Image without copying it. The volume is
+ * one of the ITK wrappers of a DataArray created by ItkBridge, so the plane is a contiguous run of the DataArray
+ * buffer and the view imports a pointer into it with an offset. It replaces ExtractSlice and SetSlice, which copy
+ * every slice out of and back into the volume and update the requested region of the shared volume image.
+ *
+ * Views only read the geometry of the volume, so several threads can view different planes at the same time.
+ */
+template <typename ComponentType>
+class ItkSliceView
+{
+  public:
+    typedef itk::Image<ComponentType, 3> ScalarImageType;
+    typedef itk::Image<ComponentType, 2> ScalarSliceImageType;
+
+    /**
+     * @brief WrapSlice Returns an image that views z plane slice of volume. The image can be used as the input of a
+     * filter and, since it views the volume buffer, writing its pixels writes the volume.
+     */
+    static typename ScalarSliceImageType::Pointer WrapSlice(const ScalarImageType* volume, size_t slice)
+    {
+      typename ScalarSliceImageType::Pointer view = ScalarSliceImageType::New();
+      view->SetRegions(SliceRegion(volume));
+      view->SetOrigin(SliceOrigin(volume));
+      view->SetSpacing(SliceSpacing(volume));
+      view->GetPixelContainer()->SetImportPointer(SlicePointer(volume, slice), SliceSize(volume), false);
+      return view;
+    }
+
+    /**
+     * @brief SetSliceAsOutput Makes a filter write its output straight into z plane slice of volume
+     */
+    static void SetSliceAsOutput(ScalarSliceImageType* output, const ScalarImageType* volume, size_t slice)
+    {
+      output->GetPixelContainer()->SetImportPointer(SlicePointer(volume, slice), SliceSize(volume), false);
+    }
+
+    /**
+     * @brief CommitSlice Finishes a slice written through SetSliceAsOutput. Filters that graft a buffer of their own
+     * onto their output leave the result outside of the volume, in which case it is copied into the plane.
+     */
+    static void CommitSlice(const ScalarSliceImageType* result, const ScalarImageType* volume, size_t slice)
+    {
+      ComponentType* plane = SlicePointer(volume, slice);
+      const ComponentType* pixels = result->GetBufferPointer();
+      if(pixels != plane)
+      {
+        std::copy(pixels, pixels + SliceSize(volume), plane);
+      }
+    }
+
+  protected:
+    static size_t SliceSize(const ScalarImageType* volume)
+    {
+      const typename ScalarImageType::SizeType& size = volume->GetLargestPossibleRegion().GetSize();
+      return static_cast<size_t>(size[0]) * static_cast<size_t>(size[1]);
+    }
+
+    static ComponentType* SlicePointer(const ScalarImageType* volume, size_t slice)
+    {
+      return const_cast<ComponentType*>(volume->GetBufferPointer()) + slice * SliceSize(volume);
+    }
+
+    static typename ScalarSliceImageType::RegionType SliceRegion(const ScalarImageType* volume)
+    {
+      const typename ScalarImageType::RegionType& region = volume->GetLargestPossibleRegion();
+      typename ScalarSliceImageType::RegionType sliceRegion;
+      for(unsigned int i = 0; i < 2; i++)
+      {
+        sliceRegion.SetIndex(i, region.GetIndex(i));
+        sliceRegion.SetSize(i, region.GetSize(i));
+      }
+      return sliceRegion;
+    }
+
+    static typename ScalarSliceImageType::PointType SliceOrigin(const ScalarImageType* volume)
+    {
+      typename ScalarSliceImageType::PointType origin;
+      origin[0] = volume->GetOrigin()[0];
+      origin[1] = volume->GetOrigin()[1];
+      return origin;
+    }
+
+    static typename ScalarSliceImageType::SpacingType SliceSpacing(const ScalarImageType* volume)
+    {
+      typename ScalarSliceImageType::SpacingType spacing;
+      spacing[0] = volume->GetSpacing()[0];
+      spacing[1] = volume->GetSpacing()[1];
+      return spacing;
+    }
+
+  public:
+    ItkSliceView() = delete;
+    ItkSliceView(const ItkSliceView&) = delete;            // Copy Constructor Not Implemented
+    ItkSliceView(ItkSliceView&&) = delete;                 // Move Constructor Not Implemented
+    ItkSliceView& operator=(const ItkSliceView&) = delete; // Copy Assignment Not Implemented
+    ItkSliceView& operator=(ItkSliceView&&) = delete;      // Move Assignment Not Implemented
+};
+
+using DefaultSliceView = ItkSliceView<ImageProcessingConstants::DefaultPixelType>;
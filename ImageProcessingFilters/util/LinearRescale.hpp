@@ -0,0 +1,78 @@
+/* ============================================================================
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the names of any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#pragma once
+
+#include <limits>
+
+/**
+ * @brief The LinearRescale class maps the intensity range [inputMinimum, inputMaximum] linearly onto
+ * [outputMinimum, outputMaximum] with the same scale and shift as itk::RescaleIntensityImageFilter, so engines that
+ * find the range of their result themselves produce the same output as a RescaleIntensityImageFilter pass.
+ */
+template <typename OutputType>
+class LinearRescale
+{
+  public:
+    LinearRescale(double inputMinimum, double inputMaximum, OutputType outputMinimum = std::numeric_limits<OutputType>::min(), OutputType outputMaximum = std::numeric_limits<OutputType>::max())
+    : m_OutputMinimum(outputMinimum)
+    , m_OutputMaximum(outputMaximum)
+    {
+      if(inputMinimum != inputMaximum)
+      {
+        m_Scale = (static_cast<double>(outputMaximum) - static_cast<double>(outputMinimum)) / (inputMaximum - inputMinimum);
+      }
+      else if(inputMaximum != 0.0)
+      {
+        m_Scale = (static_cast<double>(outputMaximum) - static_cast<double>(outputMinimum)) / inputMaximum;
+      }
+      m_Shift = static_cast<double>(outputMinimum) - inputMinimum * m_Scale;
+    }
+
+    OutputType operator()(double value) const
+    {
+      value = value * m_Scale + m_Shift;
+      if(value >= static_cast<double>(m_OutputMaximum))
+      {
+        return m_OutputMaximum;
+      }
+      if(value <= static_cast<double>(m_OutputMinimum))
+      {
+        return m_OutputMinimum;
+      }
+      return static_cast<OutputType>(value);
+    }
+
+  private:
+    OutputType m_OutputMinimum;
+    OutputType m_OutputMaximum;
+    double m_Scale = 0.0;
+    double m_Shift = 0.0;
+};
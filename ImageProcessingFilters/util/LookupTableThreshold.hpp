@@ -0,0 +1,154 @@
+/* ============================================================================
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the names of any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "SIMPLib/SIMPLib.h"
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_scheduler_init.h>
+#endif
+
+/**
+ * @brief IsLookupTableType is true for the types LookupTableThreshold supports, 8 and 16 bit integers
+ */
+template <typename PixelType>
+struct IsLookupTableType : std::integral_constant<bool, std::is_integral<PixelType>::value && !std::is_same<PixelType, bool>::value && sizeof(PixelType) <= 2>
+{
+};
+
+/**
+ * @brief The LookupTableThreshold class thresholds 8 and 16 bit integer arrays through a table with an entry for every
+ * possible value, so every voxel costs a single load. The table maps a closed range onto an inside value like
+ * itk::BinaryThresholdImageFilter. Wider and floating point types are not supported, see IsLookupTableType.
+ */
+template <typename PixelType>
+class LookupTableThreshold
+{
+  public:
+    static_assert(IsLookupTableType<PixelType>::value, "LookupTableThreshold needs an 8 or 16 bit integer type");
+
+    using IndexType = typename std::make_unsigned<PixelType>::type;
+
+    LookupTableThreshold()
+    : m_Table(static_cast<size_t>(std::numeric_limits<IndexType>::max()) + 1, 0)
+    {
+    }
+
+    /**
+     * @brief setBinary Maps the values of [lower, upper] onto inside and all other values onto outside
+     */
+    void setBinary(PixelType lower, PixelType upper, PixelType inside, PixelType outside)
+    {
+      for(size_t i = 0; i < m_Table.size(); i++)
+      {
+        const PixelType value = ToValue(i);
+        m_Table[i] = (value >= lower && value <= upper) ? inside : outside;
+      }
+    }
+
+    /**
+     * @brief apply Writes the mapped values of input into output, which may be the same buffer
+     */
+    void apply(const PixelType* input, PixelType* output, size_t numValues) const
+    {
+      ApplyImpl impl(m_Table.data(), input, output);
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+      tbb::task_scheduler_init init;
+      bool doParallel = true;
+#endif
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+      if(doParallel)
+      {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, numValues, 1 << 16), impl, tbb::auto_partitioner());
+      }
+      else
+#endif
+      {
+        impl.convert(0, numValues);
+      }
+    }
+
+  private:
+    std::vector<PixelType> m_Table;
+
+    /**
+     * @brief ToValue Returns the value of a table entry, whose index is the value's unsigned bit pattern
+     */
+    static PixelType ToValue(size_t index)
+    {
+      return static_cast<PixelType>(static_cast<IndexType>(index));
+    }
+
+    /**
+     * @brief The ApplyImpl class maps a range of values through the table
+     */
+    class ApplyImpl
+    {
+      public:
+        ApplyImpl(const PixelType* table, const PixelType* input, PixelType* output)
+        : m_Table(table)
+        , m_Input(input)
+        , m_Output(output)
+        {
+        }
+
+        void convert(size_t start, size_t end) const
+        {
+          for(size_t i = start; i < end; i++)
+          {
+            m_Output[i] = m_Table[static_cast<IndexType>(m_Input[i])];
+          }
+        }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+        void operator()(const tbb::blocked_range<size_t>& r) const
+        {
+          convert(r.begin(), r.end());
+        }
+#endif
+
+      private:
+        const PixelType* m_Table;
+        const PixelType* m_Input;
+        PixelType* m_Output;
+    };
+};
@@ -0,0 +1,651 @@
+/* ============================================================================
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the names of any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#include "MosaicCompositor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+// Number of levels of the multi-band pyramid. Each level halves the resolution, so the coarsest level blends
+// intensity differences over roughly 2^5 pixels on either side of a seam
+const size_t k_MaxPyramidLevels = 5;
+// Weights below this are treated as no coverage when the pyramid levels are normalized
+const float k_MinimumWeight = 1.0e-6f;
+// The blended levels reach this many pixels past the mosaic on every side. The seam masks of the tiles at the mosaic
+// border spread into the margin, so the collapse sees the same neighborhood as the tile pyramids and the mosaic border
+// is not darkened by clamping.
+const int64_t k_LevelMargin = 2;
+// Each band builds the tile pyramids over its rows plus this many coarsest level rows above and below. The edge
+// replication at the window border changes at most a few rows of every level, which stay inside this pad.
+const int64_t k_WindowPad = 2;
+// 5 tap binomial kernel of the Burt and Adelson pyramid
+const float k_Kernel[5] = {1.0f / 16.0f, 4.0f / 16.0f, 6.0f / 16.0f, 4.0f / 16.0f, 1.0f / 16.0f};
+
+int64_t FloorDiv(int64_t a, int64_t b)
+{
+  return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+int64_t CeilDiv(int64_t a, int64_t b)
+{
+  return -FloorDiv(-a, b);
+}
+
+int64_t Clamp(int64_t value, int64_t low, int64_t high)
+{
+  return std::max(low, std::min(value, high));
+}
+
+/**
+ * @brief Reduce Blurs an image with the pyramid kernel and drops every other row and column. Edges are replicated.
+ * The width and height have to be even.
+ */
+void Reduce(const std::vector<float>& input, size_t width, size_t height, std::vector<float>& output)
+{
+  const size_t outWidth = width / 2;
+  const size_t outHeight = height / 2;
+  std::vector<float> rows(height * outWidth);
+  std::vector<float> padded(width + 4);
+  for(size_t y = 0; y < height; y++)
+  {
+    // Replicate the edges into a padded copy of the row so the kernel loop does not need to clamp
+    const float* in = &input[y * width];
+    std::copy(in, in + width, padded.begin() + 2);
+    padded[0] = padded[1] = in[0];
+    padded[width + 2] = padded[width + 3] = in[width - 1];
+    float* out = &rows[y * outWidth];
+    for(size_t x = 0; x < outWidth; x++)
+    {
+      const float* p = &padded[2 * x];
+      out[x] = k_Kernel[0] * p[0] + k_Kernel[1] * p[1] + k_Kernel[2] * p[2] + k_Kernel[3] * p[3] + k_Kernel[4] * p[4];
+    }
+  }
+
+  output.assign(outWidth * outHeight, 0.0f);
+  for(size_t y = 0; y < outHeight; y++)
+  {
+    float* out = &output[y * outWidth];
+    for(int64_t m = 0; m < 5; m++)
+    {
+      const float* in = &rows[Clamp(static_cast<int64_t>(2 * y) + m - 2, 0, static_cast<int64_t>(height) - 1) * outWidth];
+      const float weight = k_Kernel[m];
+      for(size_t x = 0; x < outWidth; x++)
+      {
+        out[x] += weight * in[x];
+      }
+    }
+  }
+}
+
+/**
+ * @brief ExpandRow Upsamples a row by 2 with the pyramid kernel. Both rows start at index -margin, which has to be even,
+ * so fine pixel i is interpolated from the coarse pixels around i / 2. Coarse indices are clamped to the coarse row.
+ */
+void ExpandRow(const float* coarse, size_t coarseLength, float* fine, size_t fineLength, int64_t margin)
+{
+  const int64_t last = static_cast<int64_t>(coarseLength) - 1;
+  for(size_t f = 0; f < fineLength; f += 2)
+  {
+    // Fine pixels 2j and 2j + 1 both come from the coarse pixels j - 1, j and j + 1
+    const int64_t j = FloorDiv(static_cast<int64_t>(f) - margin, 2) + margin;
+    const float left = coarse[Clamp(j - 1, 0, last)];
+    const float center = coarse[Clamp(j, 0, last)];
+    const float right = coarse[Clamp(j + 1, 0, last)];
+    fine[f] = 0.125f * left + 0.75f * center + 0.125f * right;
+    if(f + 1 < fineLength)
+    {
+      fine[f + 1] = 0.5f * (center + right);
+    }
+  }
+}
+
+/**
+ * @brief AddExpandedRows Upsamples a block of rows by 2 and adds it to output. The coarse block holds the rows
+ * [coarseTop, coarseTop + coarseRows) of a level that spans the rows [-margin, levelHeight + margin), already expanded
+ * to the fine width. The fine rows [fineTop, fineTop + fineRows) are written, with coarse rows clamped to the level.
+ */
+void AddExpandedRows(const std::vector<float>& coarse, int64_t coarseTop, int64_t levelHeight, int64_t margin, size_t width, std::vector<float>& output, int64_t fineTop, size_t fineRows)
+{
+  auto coarseRow = [&](int64_t j) { return &coarse[static_cast<size_t>(Clamp(j, -margin, levelHeight + margin - 1) - coarseTop) * width]; };
+  for(size_t r = 0; r < fineRows; r++)
+  {
+    const int64_t i = fineTop + static_cast<int64_t>(r);
+    const int64_t j = FloorDiv(i, 2);
+    float* out = &output[r * width];
+    if(i % 2 == 0)
+    {
+      const float* above = coarseRow(j - 1);
+      const float* center = coarseRow(j);
+      const float* below = coarseRow(j + 1);
+      for(size_t x = 0; x < width; x++)
+      {
+        out[x] += 0.125f * above[x] + 0.75f * center[x] + 0.125f * below[x];
+      }
+    }
+    else
+    {
+      const float* above = coarseRow(j);
+      const float* below = coarseRow(j + 1);
+      for(size_t x = 0; x < width; x++)
+      {
+        out[x] += 0.5f * (above[x] + below[x]);
+      }
+    }
+  }
+}
+
+ImageProcessingConstants::DefaultPixelType ToPixel(float value)
+{
+  return static_cast<ImageProcessingConstants::DefaultPixelType>(std::min(std::max(value + 0.5f, 0.0f), 255.0f));
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+MosaicCompositor::MosaicCompositor() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+MosaicCompositor::~MosaicCompositor() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void MosaicCompositor::setTileDimensions(size_t width, size_t height)
+{
+  m_TileWidth = width;
+  m_TileHeight = height;
+
+  // Linear ramps that are largest in the middle of the tile and fall off to 1 at the borders
+  m_FeatherX.resize(width);
+  for(size_t x = 0; x < width; x++)
+  {
+    m_FeatherX[x] = static_cast<float>(std::min(x + 1, width - x));
+  }
+  m_FeatherY.resize(height);
+  for(size_t y = 0; y < height; y++)
+  {
+    m_FeatherY[y] = static_cast<float>(std::min(y + 1, height - y));
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void MosaicCompositor::setMosaicDimensions(size_t width, size_t height)
+{
+  m_MosaicWidth = width;
+  m_MosaicHeight = height;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t MosaicCompositor::getMosaicWidth() const
+{
+  return m_MosaicWidth;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t MosaicCompositor::getMosaicHeight() const
+{
+  return m_MosaicHeight;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void MosaicCompositor::addTile(const ImageProcessingConstants::DefaultPixelType* data, int64_t x, int64_t y)
+{
+  Tile tile;
+  tile.view = ConstTileView(data, m_TileWidth, m_TileHeight);
+  tile.x = x;
+  tile.y = y;
+  m_Tiles.push_back(tile);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void MosaicCompositor::setBlendMode(int blendMode)
+{
+  m_BlendMode = blendMode;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int MosaicCompositor::getBlendMode() const
+{
+  return m_BlendMode;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void MosaicCompositor::compositeBand(size_t rowStart, size_t rowEnd, ImageProcessingConstants::DefaultPixelType* band) const
+{
+  rowEnd = std::min(rowEnd, m_MosaicHeight);
+  if(rowStart >= rowEnd)
+  {
+    return;
+  }
+
+  switch(m_BlendMode)
+  {
+  case Feather:
+    compositeFeather(rowStart, rowEnd, band);
+    break;
+  case MultiBand:
+    compositeMultiBand(rowStart, rowEnd, band);
+    break;
+  default:
+    compositeOverwrite(rowStart, rowEnd, band);
+    break;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void MosaicCompositor::compositeOverwrite(size_t rowStart, size_t rowEnd, ImageProcessingConstants::DefaultPixelType* band) const
+{
+  std::memset(band, 0, (rowEnd - rowStart) * m_MosaicWidth * sizeof(ImageProcessingConstants::DefaultPixelType));
+
+  for(const Tile& tile : m_Tiles)
+  {
+    // Clip the tile against the band and the mosaic; tiles that miss the band are never read
+    int64_t x0 = 0;
+    int64_t y0 = 0;
+    const ConstTileView window = clipTile(tile, static_cast<int64_t>(rowStart), static_cast<int64_t>(rowEnd), x0, y0);
+    if(window.isEmpty())
+    {
+      continue;
+    }
+
+    for(size_t y = 0; y < window.getHeight(); y++)
+    {
+      ImageProcessingConstants::DefaultPixelType* destination = band + (static_cast<size_t>(y0) - rowStart + y) * m_MosaicWidth + static_cast<size_t>(x0);
+      std::memcpy(destination, window.row(y), window.getWidth() * sizeof(ImageProcessingConstants::DefaultPixelType));
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void MosaicCompositor::compositeFeather(size_t rowStart, size_t rowEnd, ImageProcessingConstants::DefaultPixelType* band) const
+{
+  const size_t numPixels = (rowEnd - rowStart) * m_MosaicWidth;
+  std::vector<float> values(numPixels, 0.0f);
+  std::vector<float> weights(numPixels, 0.0f);
+
+  for(const Tile& tile : m_Tiles)
+  {
+    int64_t x0 = 0;
+    int64_t y0 = 0;
+    const ConstTileView window = clipTile(tile, static_cast<int64_t>(rowStart), static_cast<int64_t>(rowEnd), x0, y0);
+    if(window.isEmpty())
+    {
+      continue;
+    }
+
+    // The weight of a pixel is the product of the horizontal and vertical ramps, so every row only needs one scale
+    // of the horizontal ramp and the inner loop is free of branches and vectorizes
+    const size_t rowLength = window.getWidth();
+    const float* rampX = &m_FeatherX[static_cast<size_t>(x0 - tile.x)];
+    for(size_t y = 0; y < window.getHeight(); y++)
+    {
+      const float rampY = m_FeatherY[static_cast<size_t>(y0 - tile.y) + y];
+      const ImageProcessingConstants::DefaultPixelType* source = window.row(y);
+      const size_t offset = (static_cast<size_t>(y0) - rowStart + y) * m_MosaicWidth + static_cast<size_t>(x0);
+      float* valueRow = &values[offset];
+      float* weightRow = &weights[offset];
+      for(size_t x = 0; x < rowLength; x++)
+      {
+        const float weight = rampY * rampX[x];
+        valueRow[x] += weight * static_cast<float>(source[x]);
+        weightRow[x] += weight;
+      }
+    }
+  }
+
+  // Uncovered pixels have a value of 0, so clamping the weight keeps this loop free of branches as well
+  for(size_t i = 0; i < numPixels; i++)
+  {
+    band[i] = ToPixel(values[i] / std::max(weights[i], k_MinimumWeight));
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ConstTileView MosaicCompositor::clipTile(const Tile& tile, int64_t rowStart, int64_t rowEnd, int64_t& x, int64_t& y) const
+{
+  x = std::max<int64_t>(tile.x, 0);
+  y = std::max(tile.y, rowStart);
+  const int64_t x1 = std::min(tile.x + static_cast<int64_t>(m_TileWidth), static_cast<int64_t>(m_MosaicWidth));
+  const int64_t y1 = std::min(tile.y + static_cast<int64_t>(m_TileHeight), rowEnd);
+  if(x >= x1 || y >= y1)
+  {
+    return ConstTileView();
+  }
+  return tile.view.window(static_cast<size_t>(x - tile.x), static_cast<size_t>(y - tile.y), static_cast<size_t>(x1 - x), static_cast<size_t>(y1 - y));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t MosaicCompositor::getNumberOfLevels() const
+{
+  // Levels coarser than a quarter of the tile only blur the whole tile into its neighbors
+  size_t numLevels = k_MaxPyramidLevels;
+  while(numLevels > 1 && (static_cast<size_t>(1) << (numLevels - 1)) * 4 > std::min(m_TileWidth, m_TileHeight))
+  {
+    numLevels--;
+  }
+  return numLevels;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+float MosaicCompositor::featherWeight(int64_t x, int64_t y) const
+{
+  return m_FeatherX[static_cast<size_t>(x)] * m_FeatherY[static_cast<size_t>(y)];
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+std::vector<int64_t> MosaicCompositor::getPyramidRegion(const Tile& tile) const
+{
+  const int64_t align = static_cast<int64_t>(1) << (getNumberOfLevels() - 1);
+  const int64_t pad = 2 * align;
+  std::vector<int64_t> region(4);
+  region[0] = FloorDiv(tile.x - pad, align) * align;
+  region[1] = FloorDiv(tile.y - pad, align) * align;
+  region[2] = CeilDiv(tile.x + static_cast<int64_t>(m_TileWidth) + pad, align) * align;
+  region[3] = CeilDiv(tile.y + static_cast<int64_t>(m_TileHeight) + pad, align) * align;
+  return region;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void MosaicCompositor::buildPyramid(size_t tileIndex, int64_t windowTop, int64_t windowBottom, std::vector<PyramidLevel>& levels) const
+{
+  const Tile& tile = m_Tiles[tileIndex];
+  const int64_t tileWidth = static_cast<int64_t>(m_TileWidth);
+  const int64_t tileHeight = static_cast<int64_t>(m_TileHeight);
+  const size_t numLevels = getNumberOfLevels();
+  std::vector<int64_t> region = getPyramidRegion(tile);
+  region[1] = std::max(region[1], windowTop);
+  region[3] = std::min(region[3], windowBottom);
+  size_t width = static_cast<size_t>(region[2] - region[0]);
+  size_t height = static_cast<size_t>(region[3] - region[1]);
+
+  // The image is extended past the tile by replicating its edges so the Laplacian levels have no artificial edges
+  std::vector<float> gaussian(width * height);
+  for(size_t ry = 0; ry < height; ry++)
+  {
+    const int64_t ty = Clamp(region[1] + static_cast<int64_t>(ry) - tile.y, 0, tileHeight - 1);
+    const ImageProcessingConstants::DefaultPixelType* source = tile.view.row(static_cast<size_t>(ty));
+    float* destination = &gaussian[ry * width];
+    for(size_t rx = 0; rx < width; rx++)
+    {
+      destination[rx] = static_cast<float>(source[Clamp(region[0] + static_cast<int64_t>(rx) - tile.x, 0, tileWidth - 1)]);
+    }
+  }
+
+  // The seam mask is 1 where this tile has the largest feather weight of all the tiles covering a pixel (the last
+  // tile wins ties) and 0 everywhere else, so only the overlaps with other tiles have to be checked
+  std::vector<float> mask(width * height, 0.0f);
+  const size_t tileLeft = static_cast<size_t>(tile.x - region[0]);
+  for(int64_t y = std::max(tile.y, region[1]); y < std::min(tile.y + tileHeight, region[3]); y++)
+  {
+    std::fill_n(&mask[static_cast<size_t>(y - region[1]) * width + tileLeft], m_TileWidth, 1.0f);
+  }
+  for(size_t i = 0; i < m_Tiles.size(); i++)
+  {
+    const Tile& other = m_Tiles[i];
+    const int64_t x0 = std::max(tile.x, other.x);
+    const int64_t x1 = std::min(tile.x, other.x) + tileWidth;
+    const int64_t y0 = std::max(std::max(tile.y, other.y), region[1]);
+    const int64_t y1 = std::min(std::min(tile.y, other.y) + tileHeight, region[3]);
+    if(i == tileIndex || x0 >= x1 || y0 >= y1)
+    {
+      continue;
+    }
+    for(int64_t y = y0; y < y1; y++)
+    {
+      float* maskRow = &mask[static_cast<size_t>(y - region[1]) * width];
+      for(int64_t x = x0; x < x1; x++)
+      {
+        const float weight = featherWeight(x - tile.x, y - tile.y);
+        const float otherWeight = featherWeight(x - other.x, y - other.y);
+        if(otherWeight > weight || (otherWeight == weight && i > tileIndex))
+        {
+          maskRow[x - region[0]] = 0.0f;
+        }
+      }
+    }
+  }
+
+  levels.clear();
+  levels.resize(numLevels);
+  levels[0].mask.swap(mask);
+
+  std::vector<float> coarse;
+  std::vector<float> expandedRows;
+  for(size_t level = 0; level < numLevels; level++)
+  {
+    PyramidLevel& current = levels[level];
+    current.x = region[0] / (static_cast<int64_t>(1) << level);
+    current.y = region[1] / (static_cast<int64_t>(1) << level);
+    current.width = width;
+    current.height = height;
+    if(level + 1 == numLevels)
+    {
+      current.laplacian.swap(gaussian);
+      break;
+    }
+
+    // Laplacian = Gaussian - Expand(Reduce(Gaussian))
+    Reduce(gaussian, width, height, coarse);
+    Reduce(current.mask, width, height, levels[level + 1].mask);
+    const size_t coarseWidth = width / 2;
+    const size_t coarseHeight = height / 2;
+    expandedRows.resize(coarseHeight * width);
+    for(size_t y = 0; y < coarseHeight; y++)
+    {
+      ExpandRow(&coarse[y * coarseWidth], coarseWidth, &expandedRows[y * width], width, 0);
+    }
+    current.laplacian.assign(width * height, 0.0f);
+    AddExpandedRows(expandedRows, 0, static_cast<int64_t>(coarseHeight), 0, width, current.laplacian, 0, height);
+    for(size_t i = 0; i < width * height; i++)
+    {
+      current.laplacian[i] = gaussian[i] - current.laplacian[i];
+    }
+
+    gaussian.swap(coarse);
+    width = coarseWidth;
+    height = coarseHeight;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void MosaicCompositor::compositeMultiBand(size_t rowStart, size_t rowEnd, ImageProcessingConstants::DefaultPixelType* band) const
+{
+  const size_t numLevels = getNumberOfLevels();
+  const int64_t margin = k_LevelMargin;
+
+  // Rows [top[level], bottom[level]) of every level are needed to collapse the band. Each level needs a few rows
+  // above and below the band for the upsampling of the next coarser level. All levels are stored with the column
+  // margin on both sides.
+  std::vector<int64_t> top(numLevels);
+  std::vector<int64_t> bottom(numLevels);
+  std::vector<int64_t> levelWidth(numLevels);
+  std::vector<int64_t> levelHeight(numLevels);
+  for(size_t level = 0; level < numLevels; level++)
+  {
+    levelWidth[level] = CeilDiv(static_cast<int64_t>(m_MosaicWidth), static_cast<int64_t>(1) << level);
+    levelHeight[level] = CeilDiv(static_cast<int64_t>(m_MosaicHeight), static_cast<int64_t>(1) << level);
+  }
+  auto levelRows = [&](int64_t firstRow, int64_t lastRow) {
+    top[0] = firstRow;
+    bottom[0] = lastRow;
+    int64_t mosaicTop = firstRow;
+    for(size_t level = 1; level < numLevels; level++)
+    {
+      top[level] = std::max(-margin, FloorDiv(top[level - 1] - 2, 2));
+      bottom[level] = std::min(levelHeight[level] + margin, FloorDiv(bottom[level - 1] + 1, 2) + 1);
+      mosaicTop = std::min(mosaicTop, top[level] * (static_cast<int64_t>(1) << level));
+    }
+    return mosaicTop;
+  };
+  const int64_t mosaicTop = levelRows(static_cast<int64_t>(rowStart), static_cast<int64_t>(rowEnd));
+  int64_t mosaicBottom = bottom[0];
+  for(size_t level = 1; level < numLevels; level++)
+  {
+    mosaicBottom = std::max(mosaicBottom, bottom[level] * (static_cast<int64_t>(1) << level));
+  }
+
+  // The tile pyramids are only built over a window of rows around the band. The levels are aligned to the coarsest
+  // level like the whole tile pyramids, and the window reaches far enough past the rows of every level the collapse
+  // reads that the replicated window edges do not reach them, so the band is the same as with whole tile pyramids.
+  const int64_t align = static_cast<int64_t>(1) << (numLevels - 1);
+  const int64_t windowTop = FloorDiv(mosaicTop - k_WindowPad * align, align) * align;
+  const int64_t windowBottom = CeilDiv(mosaicBottom + k_WindowPad * align, align) * align;
+
+  std::vector<std::vector<float>> blended(numLevels);
+  std::vector<std::vector<float>> weights(numLevels);
+  for(size_t level = 0; level < numLevels; level++)
+  {
+    const size_t numPixels = static_cast<size_t>(bottom[level] - top[level]) * static_cast<size_t>(levelWidth[level] + 2 * margin);
+    blended[level].assign(numPixels, 0.0f);
+    weights[level].assign(numPixels, 0.0f);
+  }
+
+  // Add the mask weighted levels of every tile that reaches into the band at any level, one tile pyramid at a time
+  std::vector<PyramidLevel> levels;
+  for(size_t i = 0; i < m_Tiles.size(); i++)
+  {
+    const std::vector<int64_t> region = getPyramidRegion(m_Tiles[i]);
+    if(region[1] >= mosaicBottom || region[3] <= mosaicTop)
+    {
+      continue;
+    }
+    buildPyramid(i, windowTop, windowBottom, levels);
+
+    for(size_t level = 0; level < numLevels; level++)
+    {
+      const PyramidLevel& tileLevel = levels[level];
+      const int64_t y0 = std::max(tileLevel.y, top[level]);
+      const int64_t y1 = std::min(tileLevel.y + static_cast<int64_t>(tileLevel.height), bottom[level]);
+      const int64_t x0 = std::max(tileLevel.x, -margin);
+      const int64_t x1 = std::min(tileLevel.x + static_cast<int64_t>(tileLevel.width), levelWidth[level] + margin);
+      if(y0 >= y1 || x0 >= x1)
+      {
+        continue;
+      }
+
+      const size_t width = static_cast<size_t>(levelWidth[level] + 2 * margin);
+      const size_t rowLength = static_cast<size_t>(x1 - x0);
+      for(int64_t y = y0; y < y1; y++)
+      {
+        const size_t source = static_cast<size_t>(y - tileLevel.y) * tileLevel.width + static_cast<size_t>(x0 - tileLevel.x);
+        const float* laplacian = &tileLevel.laplacian[source];
+        const float* mask = &tileLevel.mask[source];
+        const size_t offset = static_cast<size_t>(y - top[level]) * width + static_cast<size_t>(x0 + margin);
+        float* valueRow = &blended[level][offset];
+        float* weightRow = &weights[level][offset];
+        for(size_t x = 0; x < rowLength; x++)
+        {
+          valueRow[x] += mask[x] * laplacian[x];
+          weightRow[x] += mask[x];
+        }
+      }
+    }
+  }
+
+  // Every level is the mask weighted average of the tile levels
+  for(size_t level = 0; level < numLevels; level++)
+  {
+    std::vector<float>& values = blended[level];
+    for(size_t i = 0; i < values.size(); i++)
+    {
+      values[i] = (weights[level][i] > k_MinimumWeight) ? values[i] / weights[level][i] : 0.0f;
+    }
+    if(level > 0)
+    {
+      weights[level].clear();
+    }
+  }
+  // The level 0 seam masks add up to exactly 1 wherever a tile covers the mosaic
+  const std::vector<float>& coverage = weights[0];
+
+  // Collapse the pyramid from the coarsest level down
+  std::vector<float> expandedRows;
+  for(size_t level = numLevels - 1; level > 0; level--)
+  {
+    const size_t coarseWidth = static_cast<size_t>(levelWidth[level] + 2 * margin);
+    const size_t fineWidth = static_cast<size_t>(levelWidth[level - 1] + 2 * margin);
+    const size_t coarseRows = static_cast<size_t>(bottom[level] - top[level]);
+    expandedRows.resize(coarseRows * fineWidth);
+    for(size_t y = 0; y < coarseRows; y++)
+    {
+      ExpandRow(&blended[level][y * coarseWidth], coarseWidth, &expandedRows[y * fineWidth], fineWidth, margin);
+    }
+    AddExpandedRows(expandedRows, top[level], levelHeight[level], margin, fineWidth, blended[level - 1], top[level - 1], static_cast<size_t>(bottom[level - 1] - top[level - 1]));
+    blended[level].clear();
+  }
+
+  const std::vector<float>& result = blended[0];
+  const size_t resultWidth = m_MosaicWidth + static_cast<size_t>(2 * margin);
+  for(size_t y = 0; y < rowEnd - rowStart; y++)
+  {
+    const size_t offset = y * resultWidth + static_cast<size_t>(margin);
+    ImageProcessingConstants::DefaultPixelType* destination = band + y * m_MosaicWidth;
+    for(size_t x = 0; x < m_MosaicWidth; x++)
+    {
+      destination[x] = (coverage[offset + x] > 0.5f) ? ToPixel(result[offset + x]) : 0;
+    }
+  }
+}
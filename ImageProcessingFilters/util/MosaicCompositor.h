@@ -0,0 +1,189 @@
+/* ============================================================================
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the names of any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "SIMPLib/ITK/itkSupportConstants.h"
+#include "SIMPLib/Common/SIMPLibSetGetMacros.h"
+#include "SIMPLib/SIMPLib.h"
+
+#include "TileView.hpp"
+
+/**
+ * @brief The MosaicCompositor class assembles a mosaic out of equally sized 2D tiles one band of rows at a time.
+ * Only the tiles that intersect a band are touched while that band is composited, so a mosaic of any size can be
+ * produced with a single band of memory. Pixels that no tile covers are 0 and tile pixels that fall outside of the
+ * mosaic are dropped. Where tiles overlap the result depends on the blend mode:
+ *
+ * Overwrite: Tiles are pasted in the order they were added, so the last tile wins.
+ * Feather: Every tile is weighted by a linear ramp that falls off towards its borders and the weighted values are averaged.
+ * MultiBand: Each overlap is split along the seam where the feather weights cross and every band of a Laplacian pyramid
+ * is blended across that seam with the matching level of a Gaussian pyramid of the seam mask (Burt and Adelson), so
+ * coarse intensity differences are spread over a wide area while fine detail is only blended over a few pixels.
+ * The tile pyramids are built over a window of rows around each band and dropped again, so bands keep no state and may
+ * be composited concurrently. The window reaches 64 rows above and below the band for 5 levels. A band needs about
+ * 8 bytes per mosaic pixel of its window and 16 bytes per window pixel of the one tile pyramid it builds at a time.
+ * Rebuilding the pyramids for every band makes this mode about 25 times as expensive as Overwrite, so it is only meant
+ * to be chosen explicitly where seams matter more than time.
+ */
+class MosaicCompositor
+{
+  public:
+    SIMPL_SHARED_POINTERS(MosaicCompositor)
+    SIMPL_STATIC_NEW_MACRO(MosaicCompositor)
+
+    virtual ~MosaicCompositor();
+
+    /**
+     * @brief The BlendMode enum selects how overlapping tiles are combined
+     */
+    enum BlendMode
+    {
+      Overwrite = 0,
+      Feather = 1,
+      MultiBand = 2
+    };
+
+    /**
+     * @brief The Tile struct is one tile and the mosaic position of its top left pixel
+     */
+    struct Tile
+    {
+      ConstTileView view;
+      int64_t x = 0;
+      int64_t y = 0;
+    };
+
+    /**
+     * @brief setTileDimensions Sets the width and height shared by all tiles
+     */
+    void setTileDimensions(size_t width, size_t height);
+
+    /**
+     * @brief setMosaicDimensions Sets the width and height of the mosaic
+     */
+    void setMosaicDimensions(size_t width, size_t height);
+
+    size_t getMosaicWidth() const;
+    size_t getMosaicHeight() const;
+
+    /**
+     * @brief setBlendMode Selects one of the BlendMode values
+     */
+    void setBlendMode(int blendMode);
+    int getBlendMode() const;
+
+    /**
+     * @brief addTile Adds a tile whose top left pixel goes to (x, y) in the mosaic. The tile pixels are read in place,
+     * so they have to stay valid while the mosaic is composited.
+     * @param data Row major tile pixels with the size given to setTileDimensions()
+     * @param x
+     * @param y
+     */
+    void addTile(const ImageProcessingConstants::DefaultPixelType* data, int64_t x, int64_t y);
+
+    /**
+     * @brief compositeBand Fills the mosaic rows [rowStart, rowEnd) into band, which holds (rowEnd - rowStart) rows of
+     * mosaic width pixels
+     * @param rowStart
+     * @param rowEnd
+     * @param band
+     */
+    void compositeBand(size_t rowStart, size_t rowEnd, ImageProcessingConstants::DefaultPixelType* band) const;
+
+  protected:
+    MosaicCompositor();
+
+  private:
+    /**
+     * @brief The PyramidLevel struct is one level of a tile pyramid. The level covers a region that is aligned to the
+     * coarsest level, so the pixels of all tiles line up at every level.
+     */
+    struct PyramidLevel
+    {
+      int64_t x = 0; // Region origin in level coordinates
+      int64_t y = 0;
+      size_t width = 0;
+      size_t height = 0;
+      std::vector<float> laplacian;
+      std::vector<float> mask;
+    };
+
+    size_t m_TileWidth = 0;
+    size_t m_TileHeight = 0;
+    size_t m_MosaicWidth = 0;
+    size_t m_MosaicHeight = 0;
+    int m_BlendMode = Overwrite;
+    std::vector<Tile> m_Tiles;
+    std::vector<float> m_FeatherX;
+    std::vector<float> m_FeatherY;
+
+    void compositeOverwrite(size_t rowStart, size_t rowEnd, ImageProcessingConstants::DefaultPixelType* band) const;
+    void compositeFeather(size_t rowStart, size_t rowEnd, ImageProcessingConstants::DefaultPixelType* band) const;
+    void compositeMultiBand(size_t rowStart, size_t rowEnd, ImageProcessingConstants::DefaultPixelType* band) const;
+
+    /**
+     * @brief clipTile Returns the part of a tile that falls into the mosaic rows [rowStart, rowEnd) and sets (x, y) to the
+     * mosaic position of its top left pixel. The view is empty if the tile misses those rows.
+     */
+    ConstTileView clipTile(const Tile& tile, int64_t rowStart, int64_t rowEnd, int64_t& x, int64_t& y) const;
+
+    /**
+     * @brief getNumberOfLevels Returns the number of pyramid levels used for the tile size
+     */
+    size_t getNumberOfLevels() const;
+
+    /**
+     * @brief featherWeight Returns the feather weight of tile pixel (x, y)
+     */
+    float featherWeight(int64_t x, int64_t y) const;
+
+    /**
+     * @brief getPyramidRegion Returns the level 0 region covered by the pyramid of a tile as {x0, y0, x1, y1}. The region
+     * reaches past the tile far enough for the blurred seam mask and is aligned to the coarsest level.
+     */
+    std::vector<int64_t> getPyramidRegion(const Tile& tile) const;
+
+    /**
+     * @brief buildPyramid Builds the Laplacian and seam mask pyramids of the part of a tile's pyramid region that lies in
+     * the mosaic rows [windowTop, windowBottom), which are aligned to the coarsest level
+     */
+    void buildPyramid(size_t tileIndex, int64_t windowTop, int64_t windowBottom, std::vector<PyramidLevel>& levels) const;
+
+  public:
+    MosaicCompositor(const MosaicCompositor&) = delete; // Copy Constructor Not Implemented
+    MosaicCompositor(MosaicCompositor&&) = delete;      // Move Constructor Not Implemented
+    MosaicCompositor& operator=(const MosaicCompositor&) = delete; // Copy Assignment Not Implemented
+    MosaicCompositor& operator=(MosaicCompositor&&) = delete;      // Move Assignment Not Implemented
+};
+
@@ -0,0 +1,193 @@
+/* ============================================================================
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the names of any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+
+#include "itkConfigure.h"
+
+#include "SIMPLib/Filtering/AbstractFilter.h"
+#include "SIMPLib/SIMPLib.h"
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_scheduler_init.h>
+#endif
+
+/**
+ * @brief The SliceExecutor class runs the per slice work of the "Slice at a Time" filters. The z slices of a volume
+ * are independent, so they are handed to TBB in batches of a few slices per thread. Status and error messages are
+ * only sent from the calling thread, between batches, which is also where a cancel request is honored.
+ *
+ * The slice function is called as int function(size_t slice, QString& errorMessage) and returns 0 or a negative
+ * error code after filling in errorMessage. Calls run concurrently, so every call builds its own ITK filters.
+ */
+class SliceExecutor
+{
+  public:
+    /**
+     * @brief Execute Calls function for slices [0, numSlices). Once a slice fails no further batches are started
+     * and the error of the lowest failing slice is set on the filter.
+     * @param filter Filter that receives the status and error messages
+     * @param numSlices Number of z slices
+     * @param statusMessage Progress message, shown followed by the number of finished slices
+     * @param function Slice function
+     * @return 0 or the error code of the failed slice
+     */
+    template <typename SliceFunction>
+    static int Execute(AbstractFilter* filter, size_t numSlices, const QString& statusMessage, SliceFunction function)
+    {
+      SliceResult result;
+      SliceExecutorImpl<SliceFunction> executor(function, result);
+
+      size_t batchSize = 1;
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+      tbb::task_scheduler_init init;
+      bool doParallel = true;
+      batchSize = 4 * static_cast<size_t>(tbb::task_scheduler_init::default_num_threads());
+#endif
+
+      for(size_t start = 0; start < numSlices; start += batchSize)
+      {
+        if(filter->getCancel())
+        {
+          return 0;
+        }
+        const size_t end = std::min(start + batchSize, numSlices);
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+        if(doParallel)
+        {
+          tbb::parallel_for(tbb::blocked_range<size_t>(start, end), executor, tbb::auto_partitioner());
+        }
+        else
+#endif
+        {
+          executor.convert(start, end);
+        }
+
+        if(result.errorCode < 0)
+        {
+          filter->setErrorCondition(result.errorCode);
+          filter->notifyErrorMessage(filter->getHumanLabel(), result.errorMessage, result.errorCode);
+          return result.errorCode;
+        }
+
+        QString ss = QObject::tr("%1: %2 of %3").arg(statusMessage).arg(end).arg(numSlices);
+        filter->notifyStatusMessage(filter->getMessagePrefix(), filter->getHumanLabel(), ss);
+      }
+      return 0;
+    }
+
+    /**
+     * @brief SetSingleThreaded Keeps an ITK filter that runs inside a slice function from starting its own threads
+     * on top of the slice workers
+     */
+    template <typename FilterType>
+    static void SetSingleThreaded(FilterType* itkFilter)
+    {
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#if ITK_VERSION_MAJOR < 5
+      itkFilter->SetNumberOfThreads(1);
+#else
+      itkFilter->SetNumberOfWorkUnits(1);
+#endif
+#else
+      (void)itkFilter;
+#endif
+    }
+
+  private:
+    struct SliceResult
+    {
+      QMutex mutex;
+      int errorCode = 0;
+      size_t errorSlice = 0;
+      QString errorMessage;
+    };
+
+    template <typename SliceFunction>
+    class SliceExecutorImpl
+    {
+      public:
+        SliceExecutorImpl(SliceFunction& function, SliceResult& result)
+        : m_Function(function)
+        , m_Result(result)
+        {
+        }
+        virtual ~SliceExecutorImpl() = default;
+
+        void convert(size_t start, size_t end) const
+        {
+          for(size_t z = start; z < end; z++)
+          {
+            QString errorMessage;
+            int err = m_Function(z, errorMessage);
+            if(err < 0)
+            {
+              QMutexLocker lock(&m_Result.mutex);
+              if(m_Result.errorCode == 0 || z < m_Result.errorSlice)
+              {
+                m_Result.errorCode = err;
+                m_Result.errorSlice = z;
+                m_Result.errorMessage = errorMessage;
+              }
+            }
+          }
+        }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+        void operator()(const tbb::blocked_range<size_t>& r) const
+        {
+          convert(r.begin(), r.end());
+        }
+#endif
+
+      private:
+        SliceFunction& m_Function;
+        SliceResult& m_Result;
+    };
+
+  public:
+    SliceExecutor() = delete;
+    SliceExecutor(const SliceExecutor&) = delete;            // Copy Constructor Not Implemented
+    SliceExecutor(SliceExecutor&&) = delete;                 // Move Constructor Not Implemented
+    SliceExecutor& operator=(const SliceExecutor&) = delete; // Copy Assignment Not Implemented
+    SliceExecutor& operator=(SliceExecutor&&) = delete;      // Move Assignment Not Implemented
+};
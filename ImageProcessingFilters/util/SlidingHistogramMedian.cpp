@@ -0,0 +1,524 @@
+/* ============================================================================
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the names of any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#include "SlidingHistogramMedian.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <QtCore/QObject>
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_scheduler_init.h>
+#endif
+
+namespace
+{
+// Volumes with fewer slices than this are split into bands of rows, so every core gets work
+const size_t k_MinSlicesWithoutBands = 32;
+const size_t k_RowsPerBand = 64;
+
+/**
+ * @brief ClampIndex Maps an index outside of [0, size) onto the nearest boundary voxel
+ */
+inline size_t ClampIndex(int64_t index, size_t size)
+{
+  return static_cast<size_t>(std::min(std::max(index, int64_t(0)), static_cast<int64_t>(size) - 1));
+}
+
+/**
+ * @brief FindMedian Returns the value of the given rank (0 based) of a histogram with coarse bins of bucketSize fine bins
+ */
+inline size_t FindMedian(const uint32_t* coarse, const uint32_t* fine, size_t bucketSize, uint64_t rank)
+{
+  uint64_t count = 0;
+  size_t c = 0;
+  while(count + coarse[c] <= rank)
+  {
+    count += coarse[c];
+    c++;
+  }
+  size_t value = c * bucketSize;
+  while(count + fine[value] <= rank)
+  {
+    count += fine[value];
+    value++;
+  }
+  return value;
+}
+
+/**
+ * @brief The ColumnMedianImpl class filters an 8 bit volume with column histograms. Work item i covers rows
+ * [(i / depth) * bandRows, ...) of slice i % depth, so a range of work items is a run of consecutive slices of one band.
+ */
+class ColumnMedianImpl
+{
+  public:
+    ColumnMedianImpl(const uint8_t* input, uint8_t* output, const size_t* dims, const size_t* radius, size_t bandRows)
+    : m_Input(input)
+    , m_Output(output)
+    , m_Dims(dims)
+    , m_Radius(radius)
+    , m_BandRows(bandRows)
+    {
+    }
+    virtual ~ColumnMedianImpl() = default;
+
+    void convert(size_t start, size_t end) const
+    {
+      const size_t width = m_Dims[0];
+      const size_t height = m_Dims[1];
+      const size_t depth = m_Dims[2];
+      const int64_t rz = static_cast<int64_t>(m_Radius[2]);
+
+      std::vector<uint32_t> columns(width * k_Bins);
+      std::vector<uint32_t> columnsCoarse(width * k_CoarseBins);
+      std::vector<const uint8_t*> planes(static_cast<size_t>(2 * rz + 1));
+
+      // The column histograms snake through a run of slices: down the rows of one slice, one step along z, up the rows
+      // of the next slice, so they are only built from scratch at the start of a run
+      size_t y = 0;
+      bool downwards = true;
+      for(size_t i = start; i < end; i++)
+      {
+        const size_t z = i % depth;
+        const size_t yStart = (i / depth) * m_BandRows;
+        const size_t yEnd = std::min(yStart + m_BandRows, height);
+
+        const size_t oldPlane = ClampIndex(static_cast<int64_t>(z) - 1 - rz, depth);
+        for(int64_t dz = -rz; dz <= rz; dz++)
+        {
+          planes[static_cast<size_t>(dz + rz)] = m_Input + ClampIndex(static_cast<int64_t>(z) + dz, depth) * width * height;
+        }
+
+        if(i == start || z == 0)
+        {
+          y = yStart;
+          downwards = true;
+          std::fill(columns.begin(), columns.end(), 0);
+          std::fill(columnsCoarse.begin(), columnsCoarse.end(), 0);
+          for(const uint8_t* plane : planes)
+          {
+            addRows(plane, y, columns, columnsCoarse, 1);
+          }
+        }
+        else
+        {
+          downwards = !downwards;
+          const uint8_t* newPlane = planes.back();
+          if(newPlane != m_Input + oldPlane * width * height)
+          {
+            addRows(m_Input + oldPlane * width * height, y, columns, columnsCoarse, -1);
+            addRows(newPlane, y, columns, columnsCoarse, 1);
+          }
+        }
+
+        for(size_t row = 0; row < yEnd - yStart; row++)
+        {
+          if(row > 0)
+          {
+            const size_t nextY = downwards ? y + 1 : y - 1;
+            moveRow(planes, y, nextY, columns, columnsCoarse);
+            y = nextY;
+          }
+          filterRow(columns, columnsCoarse, m_Output + (z * height + y) * width);
+        }
+      }
+    }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    void operator()(const tbb::blocked_range<size_t>& r) const
+    {
+      convert(r.begin(), r.end());
+    }
+#endif
+
+  private:
+    static const size_t k_Bins = 256;
+    static const size_t k_CoarseBins = 16;
+    static const size_t k_BucketSize = k_Bins / k_CoarseBins;
+
+    const uint8_t* m_Input;
+    uint8_t* m_Output;
+    const size_t* m_Dims;
+    const size_t* m_Radius;
+    size_t m_BandRows;
+
+    /**
+     * @brief addRows Adds (sign 1) or subtracts (sign -1) the rows of plane that the kernel around row y covers
+     */
+    void addRows(const uint8_t* plane, size_t y, std::vector<uint32_t>& columns, std::vector<uint32_t>& columnsCoarse, int sign) const
+    {
+      const int64_t ry = static_cast<int64_t>(m_Radius[1]);
+      for(int64_t dy = -ry; dy <= ry; dy++)
+      {
+        const uint8_t* row = plane + ClampIndex(static_cast<int64_t>(y) + dy, m_Dims[1]) * m_Dims[0];
+        const uint32_t delta = static_cast<uint32_t>(sign);
+        for(size_t x = 0; x < m_Dims[0]; x++)
+        {
+          columns[x * k_Bins + row[x]] += delta;
+          columnsCoarse[x * k_CoarseBins + (row[x] >> 4)] += delta;
+        }
+      }
+    }
+
+    /**
+     * @brief moveRow Moves the column histograms from the kernel around row y to the kernel around the neighbouring row nextY
+     */
+    void moveRow(const std::vector<const uint8_t*>& planes, size_t y, size_t nextY, std::vector<uint32_t>& columns, std::vector<uint32_t>& columnsCoarse) const
+    {
+      const int64_t ry = static_cast<int64_t>(m_Radius[1]);
+      const int64_t side = (nextY > y) ? -ry : ry;
+      const size_t oldY = ClampIndex(static_cast<int64_t>(y) + side, m_Dims[1]);
+      const size_t newY = ClampIndex(static_cast<int64_t>(nextY) - side, m_Dims[1]);
+      if(oldY == newY)
+      {
+        return;
+      }
+      const size_t width = m_Dims[0];
+      for(const uint8_t* plane : planes)
+      {
+        const uint8_t* oldRow = plane + oldY * width;
+        const uint8_t* newRow = plane + newY * width;
+        for(size_t x = 0; x < width; x++)
+        {
+          columns[x * k_Bins + oldRow[x]]--;
+          columnsCoarse[x * k_CoarseBins + (oldRow[x] >> 4)]--;
+          columns[x * k_Bins + newRow[x]]++;
+          columnsCoarse[x * k_CoarseBins + (newRow[x] >> 4)]++;
+        }
+      }
+    }
+
+    /**
+     * @brief filterRow Slides the kernel histogram along a row. Only the coarse kernel histogram follows every step, a
+     * bucket of fine bins is brought up to date when the median search enters it (Perreault and Hebert)
+     */
+    void filterRow(const std::vector<uint32_t>& columns, const std::vector<uint32_t>& columnsCoarse, uint8_t* outputRow) const
+    {
+      const size_t width = m_Dims[0];
+      const int64_t rx = static_cast<int64_t>(m_Radius[0]);
+      const uint64_t rank = static_cast<uint64_t>(2 * rx + 1) * static_cast<uint64_t>(2 * m_Radius[1] + 1) * static_cast<uint64_t>(2 * m_Radius[2] + 1) / 2;
+
+      uint32_t kernel[k_Bins];
+      uint32_t kernelCoarse[k_CoarseBins] = { 0 };
+      int64_t updatedAt[k_CoarseBins];
+      std::fill(updatedAt, updatedAt + k_CoarseBins, int64_t(-1));
+      for(int64_t dx = -rx; dx <= rx; dx++)
+      {
+        addBins(&columnsCoarse[ClampIndex(dx, width) * k_CoarseBins], kernelCoarse, k_CoarseBins);
+      }
+
+      for(int64_t x = 0; x < static_cast<int64_t>(width); x++)
+      {
+        if(x > 0)
+        {
+          const size_t addX = ClampIndex(x + rx, width);
+          const size_t removeX = ClampIndex(x - 1 - rx, width);
+          if(addX != removeX)
+          {
+            addBins(&columnsCoarse[addX * k_CoarseBins], kernelCoarse, k_CoarseBins);
+            subtractBins(&columnsCoarse[removeX * k_CoarseBins], kernelCoarse, k_CoarseBins);
+          }
+        }
+
+        uint64_t count = 0;
+        size_t c = 0;
+        while(count + kernelCoarse[c] <= rank)
+        {
+          count += kernelCoarse[c];
+          c++;
+        }
+
+        // Catching up costs two bucket updates per step, rebuilding one per kernel column
+        uint32_t* bucket = kernel + c * k_BucketSize;
+        const size_t bucketOffset = c * k_BucketSize;
+        if(updatedAt[c] < 0 || 2 * (x - updatedAt[c]) > 2 * rx + 1)
+        {
+          std::fill(bucket, bucket + k_BucketSize, 0);
+          for(int64_t dx = -rx; dx <= rx; dx++)
+          {
+            addBins(&columns[ClampIndex(x + dx, width) * k_Bins + bucketOffset], bucket, k_BucketSize);
+          }
+        }
+        else
+        {
+          for(int64_t stepX = updatedAt[c] + 1; stepX <= x; stepX++)
+          {
+            const size_t addX = ClampIndex(stepX + rx, width);
+            const size_t removeX = ClampIndex(stepX - 1 - rx, width);
+            if(addX != removeX)
+            {
+              addBins(&columns[addX * k_Bins + bucketOffset], bucket, k_BucketSize);
+              subtractBins(&columns[removeX * k_Bins + bucketOffset], bucket, k_BucketSize);
+            }
+          }
+        }
+        updatedAt[c] = x;
+
+        size_t value = 0;
+        while(count + bucket[value] <= rank)
+        {
+          count += bucket[value];
+          value++;
+        }
+        outputRow[x] = static_cast<uint8_t>(bucketOffset + value);
+      }
+    }
+
+    static void addBins(const uint32_t* source, uint32_t* destination, size_t count)
+    {
+      for(size_t i = 0; i < count; i++)
+      {
+        destination[i] += source[i];
+      }
+    }
+
+    static void subtractBins(const uint32_t* source, uint32_t* destination, size_t count)
+    {
+      for(size_t i = 0; i < count; i++)
+      {
+        destination[i] -= source[i];
+      }
+    }
+};
+
+/**
+ * @brief The SlidingMedianImpl class filters a 16 bit volume by sliding the kernel histogram one voxel column at a
+ * time. Work items are split like those of ColumnMedianImpl
+ */
+class SlidingMedianImpl
+{
+  public:
+    SlidingMedianImpl(const uint16_t* input, uint16_t* output, const size_t* dims, const size_t* radius, size_t bandRows)
+    : m_Input(input)
+    , m_Output(output)
+    , m_Dims(dims)
+    , m_Radius(radius)
+    , m_BandRows(bandRows)
+    {
+    }
+    virtual ~SlidingMedianImpl() = default;
+
+    void convert(size_t start, size_t end) const
+    {
+      const size_t width = m_Dims[0];
+      const size_t height = m_Dims[1];
+      const size_t depth = m_Dims[2];
+      const int64_t rx = static_cast<int64_t>(m_Radius[0]);
+      const int64_t ry = static_cast<int64_t>(m_Radius[1]);
+      const int64_t rz = static_cast<int64_t>(m_Radius[2]);
+      const uint64_t rank = static_cast<uint64_t>(2 * rx + 1) * static_cast<uint64_t>(2 * ry + 1) * static_cast<uint64_t>(2 * rz + 1) / 2;
+
+      std::vector<uint32_t> kernel(k_Bins, 0);
+      std::vector<uint32_t> kernelCoarse(k_CoarseBins, 0);
+      std::vector<const uint16_t*> rows(static_cast<size_t>((2 * ry + 1) * (2 * rz + 1)));
+
+      for(size_t i = start; i < end; i++)
+      {
+        const size_t z = i % depth;
+        const size_t yStart = (i / depth) * m_BandRows;
+        const size_t yEnd = std::min(yStart + m_BandRows, height);
+        for(size_t y = yStart; y < yEnd; y++)
+        {
+          uint16_t* outputRow = m_Output + (z * height + y) * width;
+
+          // The rows of every plane that the kernel covers
+          size_t r = 0;
+          for(int64_t dz = -rz; dz <= rz; dz++)
+          {
+            const uint16_t* plane = m_Input + ClampIndex(static_cast<int64_t>(z) + dz, depth) * width * height;
+            for(int64_t dy = -ry; dy <= ry; dy++)
+            {
+              rows[r++] = plane + ClampIndex(static_cast<int64_t>(y) + dy, height) * width;
+            }
+          }
+
+          for(int64_t dx = -rx; dx <= rx; dx++)
+          {
+            addColumn(rows, ClampIndex(dx, width), kernel, kernelCoarse, 1);
+          }
+          outputRow[0] = static_cast<uint16_t>(FindMedian(kernelCoarse.data(), kernel.data(), k_Bins / k_CoarseBins, rank));
+          for(size_t x = 1; x < width; x++)
+          {
+            const size_t addX = ClampIndex(static_cast<int64_t>(x) + rx, width);
+            const size_t removeX = ClampIndex(static_cast<int64_t>(x) - 1 - rx, width);
+            if(addX != removeX)
+            {
+              addColumn(rows, addX, kernel, kernelCoarse, 1);
+              addColumn(rows, removeX, kernel, kernelCoarse, -1);
+            }
+            outputRow[x] = static_cast<uint16_t>(FindMedian(kernelCoarse.data(), kernel.data(), k_Bins / k_CoarseBins, rank));
+          }
+
+          // Empty the kernel histogram for the next row by removing the kernel of the last voxel
+          for(int64_t dx = -rx; dx <= rx; dx++)
+          {
+            addColumn(rows, ClampIndex(static_cast<int64_t>(width) - 1 + dx, width), kernel, kernelCoarse, -1);
+          }
+        }
+      }
+    }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    void operator()(const tbb::blocked_range<size_t>& r) const
+    {
+      convert(r.begin(), r.end());
+    }
+#endif
+
+  private:
+    static const size_t k_Bins = 65536;
+    static const size_t k_CoarseBins = 256;
+
+    const uint16_t* m_Input;
+    uint16_t* m_Output;
+    const size_t* m_Dims;
+    const size_t* m_Radius;
+    size_t m_BandRows;
+
+    /**
+     * @brief addColumn Adds (sign 1) or subtracts (sign -1) the voxels of column x of the kernel rows
+     */
+    static void addColumn(const std::vector<const uint16_t*>& rows, size_t x, std::vector<uint32_t>& kernel, std::vector<uint32_t>& kernelCoarse, int sign)
+    {
+      const uint32_t delta = static_cast<uint32_t>(sign);
+      for(const uint16_t* row : rows)
+      {
+        const uint16_t value = row[x];
+        kernel[value] += delta;
+        kernelCoarse[value >> 8] += delta;
+      }
+    }
+};
+
+/**
+ * @brief BandRows Returns the number of rows per work item, volumes with few slices are split into bands of rows
+ */
+size_t BandRows(const size_t dims[3])
+{
+  return (dims[2] < k_MinSlicesWithoutBands) ? k_RowsPerBand : dims[1];
+}
+
+/**
+ * @brief FilterBands Runs a band filter over all work items, bands of bandRows rows of every z slice
+ */
+template <typename BandFilter>
+void FilterBands(const BandFilter& bandFilter, const size_t dims[3], size_t bandRows)
+{
+  const size_t numItems = dims[2] * ((dims[1] + bandRows - 1) / bandRows);
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  tbb::task_scheduler_init init;
+  bool doParallel = true;
+#endif
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  if(doParallel)
+  {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, numItems), bandFilter, tbb::auto_partitioner());
+  }
+  else
+#endif
+  {
+    bandFilter.convert(0, numItems);
+  }
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+SlidingHistogramMedian::SlidingHistogramMedian() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+SlidingHistogramMedian::~SlidingHistogramMedian() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString SlidingHistogramMedian::getErrorMessage() const
+{
+  return m_ErrorMessage;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int SlidingHistogramMedian::checkArguments(const void* input, const void* output, const size_t dims[3], const size_t radius[3])
+{
+  if(nullptr == input || nullptr == output || input == output)
+  {
+    m_ErrorMessage = QObject::tr("The median filter needs separate input and output buffers");
+    return -1;
+  }
+  const uint64_t kernelSize = static_cast<uint64_t>(2 * radius[0] + 1) * static_cast<uint64_t>(2 * radius[1] + 1) * static_cast<uint64_t>(2 * radius[2] + 1);
+  if(kernelSize > 0xFFFFFFFFULL)
+  {
+    m_ErrorMessage = QObject::tr("The median kernel of radius %1 x %2 x %3 is too large").arg(radius[0]).arg(radius[1]).arg(radius[2]);
+    return -2;
+  }
+  return (dims[0] == 0 || dims[1] == 0 || dims[2] == 0) ? 1 : 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int SlidingHistogramMedian::execute(const uint8_t* input, uint8_t* output, const size_t dims[3], const size_t radius[3])
+{
+  int err = checkArguments(input, output, dims, radius);
+  if(err != 0)
+  {
+    return std::min(err, 0);
+  }
+  const size_t bandRows = BandRows(dims);
+  FilterBands(ColumnMedianImpl(input, output, dims, radius, bandRows), dims, bandRows);
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int SlidingHistogramMedian::execute(const uint16_t* input, uint16_t* output, const size_t dims[3], const size_t radius[3])
+{
+  int err = checkArguments(input, output, dims, radius);
+  if(err != 0)
+  {
+    return std::min(err, 0);
+  }
+  const size_t bandRows = BandRows(dims);
+  FilterBands(SlidingMedianImpl(input, output, dims, radius, bandRows), dims, bandRows);
+  return 0;
+}
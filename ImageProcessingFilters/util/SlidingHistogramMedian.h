@@ -0,0 +1,97 @@
+/* ============================================================================
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the names of any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#pragma once
+
+#include <cstdint>
+
+#include <QtCore/QString>
+
+#include "SIMPLib/Common/SIMPLibSetGetMacros.h"
+#include "SIMPLib/SIMPLib.h"
+
+/**
+ * @brief The SlidingHistogramMedian class is a box median filter for 8 and 16 bit volumes that keeps a histogram of
+ * the kernel instead of sorting it at every voxel. Voxels outside of the volume repeat the nearest boundary voxel and
+ * the median of the (2 radius + 1)^3 box is the one itk::MedianImageFilter selects, so both give the same result.
+ *
+ * 8 bit volumes use per column histograms (Perreault and Hebert): every column histogram covers the y and z extent of
+ * the kernel at one x, and the kernel histogram slides along a row by adding one column histogram and removing
+ * another. Only the coarse kernel histogram is updated at every step, a bucket of fine bins is brought up to date when
+ * the median search enters it. The column histograms move down the rows of a slice, one step along z and back up the
+ * rows of the next slice, so they are built once per run of slices and moving them costs 2 (2 rz + 1) voxel updates
+ * per row step. 16 bit volumes slide the kernel histogram voxel by voxel (Huang) at a cost of
+ * 2 (2 ry + 1)(2 rz + 1) updates per voxel. Both search the median through a coarse histogram first.
+ *
+ * The volume is split into z slices that are filtered in parallel. Volumes with few slices are also split into bands
+ * of rows, so thin stacks still use every core.
+ */
+class SlidingHistogramMedian
+{
+  public:
+    SIMPL_SHARED_POINTERS(SlidingHistogramMedian)
+    SIMPL_STATIC_NEW_MACRO(SlidingHistogramMedian)
+
+    virtual ~SlidingHistogramMedian();
+
+    /**
+     * @brief execute Writes the median of the box around every voxel of input into output
+     * @param input Row major volume of dims[0] x dims[1] x dims[2] voxels
+     * @param output Buffer of the same size as input, must not overlap it
+     * @param dims Volume dimensions
+     * @param radius Kernel radius along x, y and z
+     * @return 0 on success, a negative value otherwise. See getErrorMessage()
+     */
+    int execute(const uint8_t* input, uint8_t* output, const size_t dims[3], const size_t radius[3]);
+
+    /**
+     * @brief execute Writes the median of the box around every voxel of input into output
+     */
+    int execute(const uint16_t* input, uint16_t* output, const size_t dims[3], const size_t radius[3]);
+
+    QString getErrorMessage() const;
+
+  protected:
+    SlidingHistogramMedian();
+
+  private:
+    QString m_ErrorMessage;
+
+    /**
+     * @brief checkArguments Validates the arguments of execute()
+     */
+    int checkArguments(const void* input, const void* output, const size_t dims[3], const size_t radius[3]);
+
+  public:
+    SlidingHistogramMedian(const SlidingHistogramMedian&) = delete; // Copy Constructor Not Implemented
+    SlidingHistogramMedian(SlidingHistogramMedian&&) = delete;      // Move Constructor Not Implemented
+    SlidingHistogramMedian& operator=(const SlidingHistogramMedian&) = delete; // Copy Assignment Not Implemented
+    SlidingHistogramMedian& operator=(SlidingHistogramMedian&&) = delete;      // Move Assignment Not Implemented
+};
@@ -0,0 +1,145 @@
+/* ============================================================================
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the names of any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+
+#include "SIMPLib/ITK/itkSupportConstants.h"
+
+/**
+ * @brief The TileView class is a non owning view of a 2D window of a row major pixel buffer. A view of a whole tile
+ * wraps the DataArray pointer of the tile, and windows of the view share that buffer and only differ in their
+ * origin and size, so reading an overlap window never copies pixels or builds an ITK pipeline.
+ */
+template <typename T>
+class TileView
+{
+  public:
+    using PixelType = T;
+
+    TileView() = default;
+
+    /**
+     * @brief TileView Views a whole tile that is stored without padding between rows
+     */
+    TileView(T* data, size_t width, size_t height)
+    : m_Data(data)
+    , m_Width(width)
+    , m_Height(height)
+    , m_Stride(width)
+    {
+    }
+
+    /**
+     * @brief TileView Views width x height pixels whose rows are stride pixels apart
+     */
+    TileView(T* data, size_t width, size_t height, size_t stride)
+    : m_Data(data)
+    , m_Width(width)
+    , m_Height(height)
+    , m_Stride(stride)
+    {
+    }
+
+    /**
+     * @brief TileView Converts a view of mutable pixels into a view of const pixels
+     */
+    template <typename U, typename = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+    TileView(const TileView<U>& other)
+    : m_Data(other.getPointer())
+    , m_Width(other.getWidth())
+    , m_Height(other.getHeight())
+    , m_Stride(other.getStride())
+    {
+    }
+
+    T* getPointer() const
+    {
+      return m_Data;
+    }
+
+    size_t getWidth() const
+    {
+      return m_Width;
+    }
+
+    size_t getHeight() const
+    {
+      return m_Height;
+    }
+
+    /**
+     * @brief getStride Returns the distance between two rows in pixels
+     */
+    size_t getStride() const
+    {
+      return m_Stride;
+    }
+
+    bool isEmpty() const
+    {
+      return nullptr == m_Data || m_Width == 0 || m_Height == 0;
+    }
+
+    /**
+     * @brief row Returns the first pixel of row y
+     */
+    T* row(size_t y) const
+    {
+      return m_Data + y * m_Stride;
+    }
+
+    T& operator()(size_t x, size_t y) const
+    {
+      return m_Data[y * m_Stride + x];
+    }
+
+    /**
+     * @brief window Returns the window with its top left pixel at (x, y). The window is clipped to the view, so an
+     * origin past the view gives an empty window.
+     */
+    TileView window(size_t x, size_t y, size_t width, size_t height) const
+    {
+      x = std::min(x, m_Width);
+      y = std::min(y, m_Height);
+      return TileView(m_Data + y * m_Stride + x, std::min(width, m_Width - x), std::min(height, m_Height - y), m_Stride);
+    }
+
+  private:
+    T* m_Data = nullptr;
+    size_t m_Width = 0;
+    size_t m_Height = 0;
+    size_t m_Stride = 0;
+};
+
+using ConstTileView = TileView<const ImageProcessingConstants::DefaultPixelType>;
@@ -0,0 +1,425 @@
+/* ============================================================================
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the names of any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#include "TiledTiffWriter.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include <QtCore/QFile>
+#include <QtCore/QObject>
+
+#include "itk_tiff.h"
+
+namespace
+{
+// Stay well below the 4 GB offset limit of a classic TIFF to leave room for the tile tables and tags
+const uint64_t k_ClassicTiffLimit = 0xF0000000ULL;
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+TiledTiffWriter::TiledTiffWriter() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+TiledTiffWriter::~TiledTiffWriter()
+{
+  // A file that is still open here was never completed
+  abort();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool TiledTiffWriter::NeedsBigTiff(size_t width, size_t height, size_t tileSize, bool withPyramid)
+{
+  // Edge tiles are padded to full size, so the stored size is the number of tiles times the tile size
+  uint64_t storedBytes = 0;
+  while(true)
+  {
+    const uint64_t tilesAcross = (width + tileSize - 1) / tileSize;
+    const uint64_t tilesDown = (height + tileSize - 1) / tileSize;
+    storedBytes += tilesAcross * tilesDown * tileSize * tileSize * sizeof(ImageProcessingConstants::DefaultPixelType);
+    if(!withPyramid || (width <= tileSize && height <= tileSize))
+    {
+      break;
+    }
+    width = (width + 1) / 2;
+    height = (height + 1) / 2;
+  }
+  return storedBytes >= k_ClassicTiffLimit;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void TiledTiffWriter::ReduceRows(const ImageProcessingConstants::DefaultPixelType* row0, const ImageProcessingConstants::DefaultPixelType* row1, size_t width,
+                                 ImageProcessingConstants::DefaultPixelType* reduced)
+{
+  typedef ImageProcessingConstants::DefaultPixelType PixelType;
+  // A plain loop over adjacent pairs that the compiler turns into vector instructions
+  const size_t pairs = width / 2;
+  for(size_t x = 0; x < pairs; x++)
+  {
+    const uint32_t sum = static_cast<uint32_t>(row0[2 * x]) + row0[2 * x + 1] + row1[2 * x] + row1[2 * x + 1];
+    reduced[x] = static_cast<PixelType>((sum + 2) / 4);
+  }
+  if(width % 2 != 0)
+  {
+    const uint32_t sum = 2 * (static_cast<uint32_t>(row0[width - 1]) + row1[width - 1]);
+    reduced[pairs] = static_cast<PixelType>((sum + 2) / 4);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void TiledTiffWriter::setWritePyramid(bool writePyramid)
+{
+  m_WritePyramid = writePyramid;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool TiledTiffWriter::getWritePyramid() const
+{
+  return m_WritePyramid;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t TiledTiffWriter::getNumberOfPyramidLevels() const
+{
+  return m_Levels.size();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void TiledTiffWriter::setImageTags(size_t width, size_t height)
+{
+  TIFF* tiff = static_cast<TIFF*>(m_Tiff);
+  TIFFSetField(tiff, TIFFTAG_IMAGEWIDTH, static_cast<uint32_t>(width));
+  TIFFSetField(tiff, TIFFTAG_IMAGELENGTH, static_cast<uint32_t>(height));
+  TIFFSetField(tiff, TIFFTAG_BITSPERSAMPLE, 8);
+  TIFFSetField(tiff, TIFFTAG_SAMPLESPERPIXEL, 1);
+  TIFFSetField(tiff, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_MINISBLACK);
+  TIFFSetField(tiff, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+  TIFFSetField(tiff, TIFFTAG_COMPRESSION, COMPRESSION_NONE);
+  TIFFSetField(tiff, TIFFTAG_TILEWIDTH, static_cast<uint32_t>(m_TileSize));
+  TIFFSetField(tiff, TIFFTAG_TILELENGTH, static_cast<uint32_t>(m_TileSize));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int TiledTiffWriter::open(const QString& filePath, size_t width, size_t height, size_t tileSize)
+{
+  abort();
+  m_ErrorMessage.clear();
+
+  if(width == 0 || height == 0 || tileSize == 0 || tileSize % 16 != 0)
+  {
+    m_ErrorMessage = QObject::tr("Invalid tiled TIFF dimensions %1 x %2 with a tile size of %3").arg(width).arg(height).arg(tileSize);
+    return -1;
+  }
+
+  const char* mode = NeedsBigTiff(width, height, tileSize, m_WritePyramid) ? "w8" : "w";
+  TIFF* tiff = TIFFOpen(filePath.toLocal8Bit().constData(), mode);
+  if(nullptr == tiff)
+  {
+    m_ErrorMessage = QObject::tr("Could not open '%1' for writing").arg(filePath);
+    return -2;
+  }
+
+  m_Tiff = tiff;
+  m_FilePath = filePath;
+  m_Width = width;
+  m_Height = height;
+  m_TileSize = tileSize;
+  m_NextRow = 0;
+  m_TileBuffer.resize(tileSize * tileSize);
+  setImageTags(width, height);
+
+  // Halve the image until it fits into one tile. Each level is spooled to a temporary file until close().
+  size_t levelWidth = width;
+  size_t levelHeight = height;
+  while(m_WritePyramid && (levelWidth > tileSize || levelHeight > tileSize))
+  {
+    PyramidLevel level;
+    level.pendingRow.resize(levelWidth);
+    levelWidth = (levelWidth + 1) / 2;
+    levelHeight = (levelHeight + 1) / 2;
+    level.width = levelWidth;
+    level.height = levelHeight;
+    level.reducedRow.resize(levelWidth);
+    level.file.reset(new QTemporaryFile());
+    if(!level.file->open())
+    {
+      m_ErrorMessage = QObject::tr("Could not create a temporary file for pyramid level %1").arg(m_Levels.size() + 1);
+      abort();
+      return -7;
+    }
+    m_Levels.push_back(std::move(level));
+  }
+  if(!m_Levels.empty())
+  {
+    // The directories written right after this one become its SubIFDs, libtiff fills in the offsets
+    std::vector<toff_t> subIfdOffsets(m_Levels.size(), 0);
+    TIFFSetField(tiff, TIFFTAG_SUBIFD, static_cast<uint16_t>(m_Levels.size()), subIfdOffsets.data());
+  }
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int TiledTiffWriter::writeTiles(const ImageProcessingConstants::DefaultPixelType* band, size_t numRows, size_t width, size_t rowStart)
+{
+  TIFF* tiff = static_cast<TIFF*>(m_Tiff);
+  for(size_t x = 0; x < width; x += m_TileSize)
+  {
+    // Edge tiles are padded with 0 out to the full tile size
+    const size_t tileWidth = std::min(m_TileSize, width - x);
+    if(tileWidth < m_TileSize || numRows < m_TileSize)
+    {
+      std::fill(m_TileBuffer.begin(), m_TileBuffer.end(), 0);
+    }
+    for(size_t y = 0; y < numRows; y++)
+    {
+      std::memcpy(&m_TileBuffer[y * m_TileSize], band + y * width + x, tileWidth * sizeof(ImageProcessingConstants::DefaultPixelType));
+    }
+
+    if(TIFFWriteTile(tiff, m_TileBuffer.data(), static_cast<uint32_t>(x), static_cast<uint32_t>(rowStart), 0, 0) < 0)
+    {
+      m_ErrorMessage = QObject::tr("Error writing the tile at (%1, %2)").arg(x).arg(rowStart);
+      return -5;
+    }
+  }
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int TiledTiffWriter::writeBand(const ImageProcessingConstants::DefaultPixelType* band, size_t numRows)
+{
+  if(nullptr == m_Tiff)
+  {
+    m_ErrorMessage = QObject::tr("The tiled TIFF file is not open");
+    return -3;
+  }
+  if(numRows == 0 || numRows > m_TileSize || m_NextRow + numRows > m_Height || (numRows < m_TileSize && m_NextRow + numRows != m_Height))
+  {
+    m_ErrorMessage = QObject::tr("Band of %1 rows at row %2 does not match the tile size of %3").arg(numRows).arg(m_NextRow).arg(m_TileSize);
+    return -4;
+  }
+
+  int err = writeTiles(band, numRows, m_Width, m_NextRow);
+  for(size_t y = 0; y < numRows && err >= 0 && !m_Levels.empty(); y++)
+  {
+    err = addPyramidRow(0, band + y * m_Width);
+  }
+  if(err < 0)
+  {
+    return err;
+  }
+
+  m_NextRow += numRows;
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int TiledTiffWriter::addPyramidRow(size_t level, const ImageProcessingConstants::DefaultPixelType* row)
+{
+  PyramidLevel& pyramidLevel = m_Levels[level];
+  if(!pyramidLevel.hasPendingRow)
+  {
+    std::copy(row, row + pyramidLevel.pendingRow.size(), pyramidLevel.pendingRow.begin());
+    pyramidLevel.hasPendingRow = true;
+    return 0;
+  }
+
+  ReduceRows(pyramidLevel.pendingRow.data(), row, pyramidLevel.pendingRow.size(), pyramidLevel.reducedRow.data());
+  pyramidLevel.hasPendingRow = false;
+
+  const qint64 rowBytes = static_cast<qint64>(pyramidLevel.width * sizeof(ImageProcessingConstants::DefaultPixelType));
+  if(pyramidLevel.file->write(reinterpret_cast<const char*>(pyramidLevel.reducedRow.data()), rowBytes) != rowBytes)
+  {
+    m_ErrorMessage = QObject::tr("Error writing pyramid level %1 to its temporary file").arg(level + 1);
+    return -8;
+  }
+  if(level + 1 < m_Levels.size())
+  {
+    return addPyramidRow(level + 1, pyramidLevel.reducedRow.data());
+  }
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int TiledTiffWriter::writePyramid()
+{
+  // An odd last row of a level is averaged with itself. Levels are flushed from the top so every row reaches the next level.
+  for(size_t level = 0; level < m_Levels.size(); level++)
+  {
+    if(m_Levels[level].hasPendingRow)
+    {
+      int err = addPyramidRow(level, m_Levels[level].pendingRow.data());
+      if(err < 0)
+      {
+        return err;
+      }
+    }
+  }
+
+  TIFF* tiff = static_cast<TIFF*>(m_Tiff);
+  if(TIFFWriteDirectory(tiff) == 0)
+  {
+    m_ErrorMessage = QObject::tr("Error writing the image directory");
+    return -9;
+  }
+
+  std::vector<ImageProcessingConstants::DefaultPixelType> band;
+  for(size_t level = 0; level < m_Levels.size(); level++)
+  {
+    PyramidLevel& pyramidLevel = m_Levels[level];
+    setImageTags(pyramidLevel.width, pyramidLevel.height);
+    TIFFSetField(tiff, TIFFTAG_SUBFILETYPE, FILETYPE_REDUCEDIMAGE);
+
+    pyramidLevel.file->seek(0);
+    band.resize(m_TileSize * pyramidLevel.width);
+    for(size_t rowStart = 0; rowStart < pyramidLevel.height; rowStart += m_TileSize)
+    {
+      const size_t numRows = std::min(m_TileSize, pyramidLevel.height - rowStart);
+      const qint64 bandBytes = static_cast<qint64>(numRows * pyramidLevel.width * sizeof(ImageProcessingConstants::DefaultPixelType));
+      if(pyramidLevel.file->read(reinterpret_cast<char*>(band.data()), bandBytes) != bandBytes)
+      {
+        m_ErrorMessage = QObject::tr("Error reading pyramid level %1 back from its temporary file").arg(level + 1);
+        return -10;
+      }
+      int err = writeTiles(band.data(), numRows, pyramidLevel.width, rowStart);
+      if(err < 0)
+      {
+        return err;
+      }
+    }
+    if(TIFFWriteDirectory(tiff) == 0)
+    {
+      m_ErrorMessage = QObject::tr("Error writing the directory of pyramid level %1").arg(level + 1);
+      return -9;
+    }
+    pyramidLevel.file.reset();
+  }
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int TiledTiffWriter::close()
+{
+  if(nullptr == m_Tiff)
+  {
+    return 0;
+  }
+
+  int err = 0;
+  if(m_NextRow != m_Height)
+  {
+    m_ErrorMessage = QObject::tr("Only %1 of %2 rows were written").arg(m_NextRow).arg(m_Height);
+    err = -6;
+  }
+  else if(!m_Levels.empty())
+  {
+    err = writePyramid();
+  }
+
+  closeHandle();
+  if(err < 0)
+  {
+    // A truncated file would still open as a TIFF, so it is not left behind
+    QFile::remove(m_FilePath);
+  }
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void TiledTiffWriter::abort()
+{
+  if(nullptr == m_Tiff)
+  {
+    return;
+  }
+
+  closeHandle();
+  QFile::remove(m_FilePath);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void TiledTiffWriter::closeHandle()
+{
+  TIFFClose(static_cast<TIFF*>(m_Tiff));
+  m_Tiff = nullptr;
+
+  // The pyramid spools are temporary files that are deleted with their levels
+  m_Levels.clear();
+  m_TileBuffer.clear();
+  m_TileBuffer.shrink_to_fit();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t TiledTiffWriter::getTileSize() const
+{
+  return m_TileSize;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString TiledTiffWriter::getErrorMessage() const
+{
+  return m_ErrorMessage;
+}
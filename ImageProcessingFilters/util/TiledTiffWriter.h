@@ -0,0 +1,182 @@
+/* ============================================================================
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the names of any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <QtCore/QString>
+#include <QtCore/QTemporaryFile>
+
+#include "SIMPLib/ITK/itkSupportConstants.h"
+#include "SIMPLib/Common/SIMPLibSetGetMacros.h"
+#include "SIMPLib/SIMPLib.h"
+
+/**
+ * @brief The TiledTiffWriter class writes an 8 bit grayscale image to a tiled TIFF file one band of tile rows at a
+ * time, so the full image never has to be held in memory. Files whose pixel data would not fit in a classic TIFF are
+ * written as BigTIFF.
+ *
+ * The writer can also add a pyramid of power of two downsampled levels as SubIFDs of the image, which lets viewers
+ * open very large images quickly. Every level is reduced from the level above with a 2x2 box filter while the rows
+ * arrive, and is kept in a temporary file until it is written when the file is closed. Levels are added until the
+ * smallest one fits into a single tile.
+ *
+ * Usage: setWritePyramid() if wanted, open(), then writeBand() for every band of getTileSize() rows from top to bottom
+ * (the last band may be shorter), then close(). A file that is not completed, because abort() is called, close() fails
+ * or the writer is destroyed while the file is still open, is removed together with its pyramid spools.
+ */
+class TiledTiffWriter
+{
+  public:
+    SIMPL_SHARED_POINTERS(TiledTiffWriter)
+    SIMPL_STATIC_NEW_MACRO(TiledTiffWriter)
+
+    virtual ~TiledTiffWriter();
+
+    /**
+     * @brief open Creates the file and writes the image header
+     * @param filePath
+     * @param width Image width in pixels
+     * @param height Image height in pixels
+     * @param tileSize Width and height of the TIFF tiles, must be a multiple of 16
+     * @return 0 on success, a negative value otherwise. See getErrorMessage()
+     */
+    int open(const QString& filePath, size_t width, size_t height, size_t tileSize = 256);
+
+    /**
+     * @brief writeBand Writes the next band of rows
+     * @param band Row major pixels, getTileSize() rows (fewer for the last band) of image width pixels
+     * @param numRows Number of rows in band
+     * @return 0 on success, a negative value otherwise. See getErrorMessage()
+     */
+    int writeBand(const ImageProcessingConstants::DefaultPixelType* band, size_t numRows);
+
+    /**
+     * @brief close Flushes and closes the file. The file is removed if it could not be completed.
+     * @return 0 on success, a negative value otherwise. See getErrorMessage()
+     */
+    int close();
+
+    /**
+     * @brief abort Closes the file without completing it and removes it
+     */
+    void abort();
+
+    size_t getTileSize() const;
+
+    /**
+     * @brief setWritePyramid Selects if a pyramid of downsampled levels is written. Has to be set before open().
+     */
+    void setWritePyramid(bool writePyramid);
+    bool getWritePyramid() const;
+
+    /**
+     * @brief getNumberOfPyramidLevels Returns the number of downsampled levels written for the open file
+     */
+    size_t getNumberOfPyramidLevels() const;
+
+    QString getErrorMessage() const;
+
+    /**
+     * @brief NeedsBigTiff Returns true if an image of the given size, and its pyramid levels if withPyramid is set, can
+     * not be stored as a classic TIFF
+     */
+    static bool NeedsBigTiff(size_t width, size_t height, size_t tileSize, bool withPyramid = false);
+
+    /**
+     * @brief ReduceRows Averages 2x2 blocks of two rows of width pixels into one row of (width + 1) / 2 pixels. An odd
+     * last column is averaged with itself.
+     */
+    static void ReduceRows(const ImageProcessingConstants::DefaultPixelType* row0, const ImageProcessingConstants::DefaultPixelType* row1, size_t width,
+                           ImageProcessingConstants::DefaultPixelType* reduced);
+
+  protected:
+    TiledTiffWriter();
+
+  private:
+    /**
+     * @brief The PyramidLevel struct is one downsampled level while it is being built
+     */
+    struct PyramidLevel
+    {
+      size_t width = 0;
+      size_t height = 0;
+      std::vector<ImageProcessingConstants::DefaultPixelType> pendingRow; // Row of the level above that waits for its partner
+      bool hasPendingRow = false;
+      std::vector<ImageProcessingConstants::DefaultPixelType> reducedRow;
+      std::unique_ptr<QTemporaryFile> file;
+    };
+
+    void* m_Tiff = nullptr;
+    QString m_FilePath;
+    size_t m_Width = 0;
+    size_t m_Height = 0;
+    size_t m_TileSize = 0;
+    size_t m_NextRow = 0;
+    bool m_WritePyramid = false;
+    std::vector<PyramidLevel> m_Levels;
+    std::vector<ImageProcessingConstants::DefaultPixelType> m_TileBuffer;
+    QString m_ErrorMessage;
+
+    /**
+     * @brief setImageTags Sets the tags of the directory that is written next
+     */
+    void setImageTags(size_t width, size_t height);
+
+    /**
+     * @brief writeTiles Writes a band of numRows rows of an image that is width pixels wide, starting at row rowStart
+     */
+    int writeTiles(const ImageProcessingConstants::DefaultPixelType* band, size_t numRows, size_t width, size_t rowStart);
+
+    /**
+     * @brief addPyramidRow Hands a row of the level above to the pyramid level, which reduces every second row with the
+     * one before and passes the result on to the next level
+     */
+    int addPyramidRow(size_t level, const ImageProcessingConstants::DefaultPixelType* row);
+
+    /**
+     * @brief writePyramid Flushes the unpaired rows and writes every level as a SubIFD
+     */
+    int writePyramid();
+
+    /**
+     * @brief closeHandle Closes the libtiff handle and frees the pyramid spools and the tile buffer
+     */
+    void closeHandle();
+
+  public:
+    TiledTiffWriter(const TiledTiffWriter&) = delete; // Copy Constructor Not Implemented
+    TiledTiffWriter(TiledTiffWriter&&) = delete;      // Move Constructor Not Implemented
+    TiledTiffWriter& operator=(const TiledTiffWriter&) = delete; // Copy Assignment Not Implemented
+    TiledTiffWriter& operator=(TiledTiffWriter&&) = delete;      // Move Assignment Not Implemented
+};
+
@@ -0,0 +1,515 @@
+/* ============================================================================
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the names of any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  This code was partially written under United States Air Force Contract number
+ *                              FA8650-10-D-5210
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <QtCore/QVector>
+
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/SIMPLib.h"
+#include "UnitTestSupport.hpp"
+
+#include "itkImage.h"
+#include "itkMaskedFFTNormalizedCorrelationImageFilter.h"
+#include "itkMinimumMaximumImageCalculator.h"
+
+#include "ImageProcessing/ImageProcessingConstants.h"
+#include "ImageProcessing/ImageProcessingFilters/util/DetermineStitching.h"
+
+/**
+ * @brief The DetermineStitchingTest class stitches a mosaic of tiles cut from one noise image at known, jittered
+ * positions. It checks every pairwise correlation against itk::MaskedFFTNormalizedCorrelationImageFilter and checks that
+ * FindGlobalOrigins places the tiles exactly like the serial walk that correlated one pair at a time. The global least
+ * squares placement is checked on the mosaic and on hand made pairs with a known weighted solution.
+ */
+class DetermineStitchingTest
+{
+  public:
+    DetermineStitchingTest() = default;
+    virtual ~DetermineStitchingTest() = default;
+
+    typedef ImageProcessingConstants::DefaultPixelType PixelType;
+    typedef ImageProcessingConstants::DefaultImageType ImageType;
+    typedef itk::MaskedFFTNormalizedCorrelationImageFilter<ImageType, ImageProcessingConstants::FloatImageType, ImageType> XCFilterType;
+    typedef itk::MinimumMaximumImageCalculator<ImageProcessingConstants::FloatImageType> MinMaxCalculatorType;
+
+    static const size_t k_XTiles = 4;
+    static const size_t k_YTiles = 3;
+    static const size_t k_TileWidth = 128;
+    static const size_t k_TileHeight = 96;
+    static const size_t k_Border = 8;
+    static const int k_MaxJitter = 2;
+
+    /**
+     * @brief The Mosaic struct holds the tiles in comb order and the position each tile was cut at
+     */
+    struct Mosaic
+    {
+      std::vector<std::vector<PixelType>> tiles;
+      std::vector<int> xOrigins;
+      std::vector<int> yOrigins;
+    };
+
+    // -----------------------------------------------------------------------------
+    // Cuts the tiles from one noise image. Neighbouring tiles overlap by overlapPer percent give or take k_MaxJitter pixels.
+    // -----------------------------------------------------------------------------
+    Mosaic CreateMosaic(float overlapPer)
+    {
+      const size_t xStep = k_TileWidth - static_cast<size_t>(k_TileWidth * (overlapPer / 100));
+      const size_t yStep = k_TileHeight - static_cast<size_t>(k_TileHeight * (overlapPer / 100));
+      const size_t width = 2 * k_Border + (k_XTiles - 1) * xStep + k_TileWidth;
+      const size_t height = 2 * k_Border + (k_YTiles - 1) * yStep + k_TileHeight;
+
+      std::vector<PixelType> image(width * height);
+      uint32_t state = 20171;
+      for(size_t i = 0; i < image.size(); i++)
+      {
+        state = state * 1664525u + 1013904223u;
+        image[i] = static_cast<PixelType>(state >> 24);
+      }
+
+      Mosaic mosaic;
+      for(size_t y = 0; y < k_YTiles; y++)
+      {
+        for(size_t x = 0; x < k_XTiles; x++)
+        {
+          state = state * 1664525u + 1013904223u;
+          const int jitterX = static_cast<int>((state >> 16) % (2 * k_MaxJitter + 1)) - k_MaxJitter;
+          state = state * 1664525u + 1013904223u;
+          const int jitterY = static_cast<int>((state >> 16) % (2 * k_MaxJitter + 1)) - k_MaxJitter;
+          const int xOrigin = static_cast<int>(k_Border + x * xStep) + jitterX;
+          const int yOrigin = static_cast<int>(k_Border + y * yStep) + jitterY;
+
+          std::vector<PixelType> tile(k_TileWidth * k_TileHeight);
+          for(size_t ty = 0; ty < k_TileHeight; ty++)
+          {
+            const PixelType* row = image.data() + (yOrigin + ty) * width + xOrigin;
+            std::copy(row, row + k_TileWidth, tile.begin() + ty * k_TileWidth);
+          }
+          mosaic.tiles.push_back(tile);
+          mosaic.xOrigins.push_back(xOrigin);
+          mosaic.yOrigins.push_back(yOrigin);
+        }
+      }
+      return mosaic;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Lists the tiles the way a filter hands them in for an import mode: the comb tile i is at combIndexList[i]
+    // -----------------------------------------------------------------------------
+    QVector<PixelType*> CreateTileList(Mosaic& mosaic, int importMode)
+    {
+      QVector<size_t> combIndexList = DetermineStitching::ReturnProperIndex(importMode, k_XTiles, k_YTiles);
+      QVector<PixelType*> dataArrayList(combIndexList.size(), nullptr);
+      for(int i = 0; i < combIndexList.size(); i++)
+      {
+        dataArrayList[combIndexList[i]] = mosaic.tiles[i].data();
+      }
+      return dataArrayList;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    ImageType::Pointer CreateWindowImage(const PixelType* tile, size_t x0, size_t y0, size_t width, size_t height)
+    {
+      ImageType::RegionType region;
+      region.SetIndex(0, 0);
+      region.SetIndex(1, 0);
+      region.SetIndex(2, 0);
+      region.SetSize(0, width);
+      region.SetSize(1, height);
+      region.SetSize(2, 1);
+
+      ImageType::Pointer window = ImageType::New();
+      window->SetRegions(region);
+      window->Allocate();
+      for(size_t y = 0; y < height; y++)
+      {
+        const PixelType* row = tile + (y0 + y) * k_TileWidth + x0;
+        std::copy(row, row + width, window->GetBufferPointer() + y * width);
+      }
+      return window;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Crops the two windows, correlates them with a new itk::MaskedFFTNormalizedCorrelationImageFilter and returns the
+    // shift and the peak value the way CropAndCrossCorrelate computed them before the pairs were correlated in parallel
+    // -----------------------------------------------------------------------------
+    std::vector<float> ItkCropAndCrossCorrelate(const std::vector<float>& cropSpecsIm1Im2, const PixelType* currentTile, const PixelType* fixedTile)
+    {
+      ImageType::Pointer fixedWindow = CreateWindowImage(fixedTile, static_cast<size_t>(cropSpecsIm1Im2[0]), static_cast<size_t>(cropSpecsIm1Im2[1]), static_cast<size_t>(cropSpecsIm1Im2[6]),
+                                                    static_cast<size_t>(cropSpecsIm1Im2[7]));
+      ImageType::Pointer currentWindow = CreateWindowImage(currentTile, static_cast<size_t>(cropSpecsIm1Im2[3]), static_cast<size_t>(cropSpecsIm1Im2[4]), static_cast<size_t>(cropSpecsIm1Im2[9]),
+                                                      static_cast<size_t>(cropSpecsIm1Im2[10]));
+
+      XCFilterType::Pointer xCorrFilter = XCFilterType::New();
+      xCorrFilter->SetFixedImage(fixedWindow);
+      xCorrFilter->SetMovingImage(currentWindow);
+      xCorrFilter->SetRequiredFractionOfOverlappingPixels(0.5);
+      xCorrFilter->Update();
+
+      MinMaxCalculatorType::Pointer calculator = MinMaxCalculatorType::New();
+      calculator->SetImage(xCorrFilter->GetOutput());
+      calculator->Compute();
+
+      std::vector<float> newXYOrigin(3, 0);
+      newXYOrigin[0] = float(calculator->GetIndexOfMaximum()[0]) - float(fixedWindow->GetLargestPossibleRegion().GetSize()[0]);
+      newXYOrigin[1] = float(calculator->GetIndexOfMaximum()[1]) - float(fixedWindow->GetLargestPossibleRegion().GetSize()[1]);
+      newXYOrigin[2] = calculator->GetMaximum();
+      return newXYOrigin;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Places the tiles with the serial comb walk that correlated each tile with its left and top neighbour right before
+    // placing it
+    // -----------------------------------------------------------------------------
+    std::vector<float> SerialGlobalOrigins(int importMode, float overlapPer, const QVector<PixelType*>& dataArrayList, const QVector<size_t>& udims)
+    {
+      const size_t numXtiles = k_XTiles;
+      QVector<size_t> combIndexList = DetermineStitching::ReturnProperIndex(importMode, k_XTiles, k_YTiles);
+      std::vector<float> xyStitched(2 * combIndexList.size(), 0.0f);
+      std::vector<float> xyStitchedOrig(2 * combIndexList.size(), 0.0f);
+
+      std::vector<float> leftCropSpecs(12, 0);
+      leftCropSpecs[0] = udims[0] - (udims[0] * (overlapPer / 100));
+      leftCropSpecs[6] = udims[0] * (overlapPer / 100);
+      leftCropSpecs[7] = udims[1];
+      leftCropSpecs[8] = 1;
+      leftCropSpecs[9] = udims[0] * (overlapPer / 100);
+      leftCropSpecs[10] = udims[1];
+      leftCropSpecs[11] = 1;
+
+      std::vector<float> topCropSpecs(12, 0);
+      topCropSpecs[1] = udims[1] - (udims[1] * (overlapPer / 100));
+      topCropSpecs[6] = udims[0];
+      topCropSpecs[7] = udims[1] * (overlapPer / 100);
+      topCropSpecs[8] = 1;
+      topCropSpecs[9] = udims[0];
+      topCropSpecs[10] = udims[1] * (overlapPer / 100);
+      topCropSpecs[11] = 1;
+
+      for(size_t i = 1; i < static_cast<size_t>(combIndexList.size()); i++)
+      {
+        const PixelType* currentTile = dataArrayList[combIndexList[i]];
+        float newXfromleft = 0;
+        float newYfromleft = 0;
+        float newXfromtop = 0;
+        float newYfromtop = 0;
+
+        if(i % numXtiles != 0)
+        {
+          std::vector<float> newXYOrigin = ItkCropAndCrossCorrelate(leftCropSpecs, currentTile, dataArrayList[combIndexList[i - 1]]);
+          newXfromleft = xyStitched[2 * (i - 1)] + leftCropSpecs[0] + newXYOrigin[0];
+          newYfromleft = xyStitched[2 * (i - 1) + 1] + newXYOrigin[1];
+        }
+        if(i >= numXtiles)
+        {
+          std::vector<float> newXYOrigin = ItkCropAndCrossCorrelate(topCropSpecs, currentTile, dataArrayList[combIndexList[i - numXtiles]]);
+          newXfromtop = xyStitched[2 * (i - numXtiles)] + newXYOrigin[0];
+          newYfromtop = xyStitched[2 * (i - numXtiles) + 1] + newXYOrigin[1] + topCropSpecs[1];
+        }
+
+        if(i < numXtiles)
+        {
+          xyStitched[2 * i] = newXfromleft;
+          xyStitched[2 * i + 1] = newYfromleft;
+        }
+        else if(i % numXtiles == 0)
+        {
+          xyStitched[2 * i] = newXfromtop;
+          xyStitched[2 * i + 1] = newYfromtop;
+        }
+        else
+        {
+          xyStitched[2 * i] = (newXfromtop + newXfromleft) / 2.0;
+          xyStitched[2 * i + 1] = (newYfromtop + newYfromleft) / 2.0;
+        }
+
+        xyStitchedOrig[2 * combIndexList[i]] = xyStitched[2 * i];
+        xyStitchedOrig[2 * combIndexList[i] + 1] = xyStitched[2 * i + 1];
+      }
+      return xyStitchedOrig;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    int TestPairsMatchItk()
+    {
+      const float overlapPer = 25.0f;
+      Mosaic mosaic = CreateMosaic(overlapPer);
+      QVector<PixelType*> dataArrayList = CreateTileList(mosaic, 0);
+      QVector<size_t> udims = { k_TileWidth, k_TileHeight, 1 };
+      QVector<size_t> combIndexList = DetermineStitching::ReturnProperIndex(0, k_XTiles, k_YTiles);
+
+      std::vector<DetermineStitching::TilePair> pairs = DetermineStitching::BuildTilePairs(combIndexList.size(), k_XTiles, udims, overlapPer);
+      DREAM3D_REQUIRE_EQUAL(pairs.size(), 2 * k_XTiles * k_YTiles - k_XTiles - k_YTiles)
+      DetermineStitching::CrossCorrelateTilePairs(pairs, combIndexList, udims, dataArrayList);
+
+      for(const DetermineStitching::TilePair& pair : pairs)
+      {
+        std::vector<float> expected = ItkCropAndCrossCorrelate(pair.cropSpecsIm1Im2, dataArrayList[combIndexList[pair.combIndex]], dataArrayList[combIndexList[pair.neighborIndex]]);
+        DREAM3D_REQUIRE_EQUAL(pair.newXYOrigin[0], expected[0])
+        DREAM3D_REQUIRE_EQUAL(pair.newXYOrigin[1], expected[1])
+        DREAM3D_REQUIRED(std::fabs(pair.newXYOrigin[2] - expected[2]), <=, 1.0E-5f)
+      }
+      return EXIT_SUCCESS;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    int TestMatchesSerialWalk()
+    {
+      const float overlapPer = 25.0f;
+      Mosaic mosaic = CreateMosaic(overlapPer);
+      QVector<size_t> udims = { k_TileWidth, k_TileHeight, 1 };
+
+      // Comb, column comb, snake and column snake order
+      for(int importMode = 0; importMode < 4; importMode++)
+      {
+        QVector<PixelType*> dataArrayList = CreateTileList(mosaic, importMode);
+        std::vector<float> expected = SerialGlobalOrigins(importMode, overlapPer, dataArrayList, udims);
+        FloatArrayType::Pointer origins = DetermineStitching::FindGlobalOrigins(k_XTiles, k_YTiles, importMode, overlapPer, dataArrayList, udims);
+
+        DREAM3D_REQUIRE_EQUAL(origins->getSize(), expected.size())
+        for(size_t i = 0; i < expected.size(); i++)
+        {
+          DREAM3D_REQUIRE_EQUAL(origins->getValue(i), expected[i])
+        }
+      }
+      return EXIT_SUCCESS;
+    }
+
+    // -----------------------------------------------------------------------------
+    // The correlation shifts are measured relative to the end of the fixed window, so every tile is off from where it
+    // was cut by the same amount per step along the chain. The distance between neighbours has to be off by the same
+    // amount for every pair of left neighbours and for every pair of top neighbours.
+    // -----------------------------------------------------------------------------
+    int TestRecoversTileOffsets()
+    {
+      const float overlapPer = 25.0f;
+      Mosaic mosaic = CreateMosaic(overlapPer);
+      QVector<PixelType*> dataArrayList = CreateTileList(mosaic, 0);
+      QVector<size_t> udims = { k_TileWidth, k_TileHeight, 1 };
+      FloatArrayType::Pointer origins = DetermineStitching::FindGlobalOrigins(k_XTiles, k_YTiles, 0, overlapPer, dataArrayList, udims);
+
+      float leftError[2] = { 0.0f, 0.0f };
+      float topError[2] = { 0.0f, 0.0f };
+      for(size_t y = 0; y < k_YTiles; y++)
+      {
+        for(size_t x = 0; x < k_XTiles; x++)
+        {
+          const size_t i = y * k_XTiles + x;
+          if(x > 0)
+          {
+            const float errorX = (origins->getValue(2 * i) - origins->getValue(2 * (i - 1))) - static_cast<float>(mosaic.xOrigins[i] - mosaic.xOrigins[i - 1]);
+            const float errorY = (origins->getValue(2 * i + 1) - origins->getValue(2 * (i - 1) + 1)) - static_cast<float>(mosaic.yOrigins[i] - mosaic.yOrigins[i - 1]);
+            if(i == 1)
+            {
+              leftError[0] = errorX;
+              leftError[1] = errorY;
+            }
+            DREAM3D_REQUIRE_EQUAL(errorX, leftError[0])
+            DREAM3D_REQUIRE_EQUAL(errorY, leftError[1])
+          }
+          if(y > 0)
+          {
+            const float errorX = (origins->getValue(2 * i) - origins->getValue(2 * (i - k_XTiles))) - static_cast<float>(mosaic.xOrigins[i] - mosaic.xOrigins[i - k_XTiles]);
+            const float errorY = (origins->getValue(2 * i + 1) - origins->getValue(2 * (i - k_XTiles) + 1)) - static_cast<float>(mosaic.yOrigins[i] - mosaic.yOrigins[i - k_XTiles]);
+            if(i == k_XTiles)
+            {
+              topError[0] = errorX;
+              topError[1] = errorY;
+            }
+            DREAM3D_REQUIRE_EQUAL(errorX, topError[0])
+            DREAM3D_REQUIRE_EQUAL(errorY, topError[1])
+          }
+        }
+      }
+      DREAM3D_REQUIRED(std::fabs(leftError[0]), <=, 1.0f)
+      DREAM3D_REQUIRED(std::fabs(leftError[1]), <=, 1.0f)
+      DREAM3D_REQUIRED(std::fabs(topError[0]), <=, 1.0f)
+      DREAM3D_REQUIRED(std::fabs(topError[1]), <=, 1.0f)
+      return EXIT_SUCCESS;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    int TestCoarseToFineMatchesFullResolution()
+    {
+      const float overlapPer = 25.0f;
+      Mosaic mosaic = CreateMosaic(overlapPer);
+      QVector<PixelType*> dataArrayList = CreateTileList(mosaic, 0);
+      QVector<size_t> udims = { k_TileWidth, k_TileHeight, 1 };
+      FloatArrayType::Pointer expected = DetermineStitching::FindGlobalOrigins(k_XTiles, k_YTiles, 0, overlapPer, dataArrayList, udims);
+
+      int searches[2] = { DetermineStitching::CoarseToFine4x, DetermineStitching::CoarseToFine8x };
+      for(int correlationSearch : searches)
+      {
+        FloatArrayType::Pointer origins =
+            DetermineStitching::FindGlobalOrigins(k_XTiles, k_YTiles, 0, overlapPer, dataArrayList, udims, DetermineStitching::ChainedAverage, correlationSearch);
+        for(size_t i = 0; i < expected->getSize(); i++)
+        {
+          DREAM3D_REQUIRE_EQUAL(origins->getValue(i), expected->getValue(i))
+        }
+      }
+      return EXIT_SUCCESS;
+    }
+
+    // -----------------------------------------------------------------------------
+    // The pairs of a clean mosaic agree with each other, so solving for all origins at once has to give the chained placement
+    // -----------------------------------------------------------------------------
+    int TestLeastSquaresMatchesChained()
+    {
+      const float overlapPer = 25.0f;
+      Mosaic mosaic = CreateMosaic(overlapPer);
+      QVector<size_t> udims = { k_TileWidth, k_TileHeight, 1 };
+
+      for(int importMode = 0; importMode < 4; importMode++)
+      {
+        QVector<PixelType*> dataArrayList = CreateTileList(mosaic, importMode);
+        FloatArrayType::Pointer chained = DetermineStitching::FindGlobalOrigins(k_XTiles, k_YTiles, importMode, overlapPer, dataArrayList, udims, DetermineStitching::ChainedAverage);
+        FloatArrayType::Pointer solved = DetermineStitching::FindGlobalOrigins(k_XTiles, k_YTiles, importMode, overlapPer, dataArrayList, udims, DetermineStitching::GlobalLeastSquares);
+
+        DREAM3D_REQUIRE_EQUAL(solved->getSize(), chained->getSize())
+        for(size_t i = 0; i < chained->getSize(); i++)
+        {
+          DREAM3D_REQUIRED(std::fabs(solved->getValue(i) - chained->getValue(i)), <=, 1.0E-3f)
+        }
+      }
+      return EXIT_SUCCESS;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Creates a pair whose measured offset from the neighbour's origin to the tile's origin is (offsetX, offsetY)
+    // -----------------------------------------------------------------------------
+    DetermineStitching::TilePair CreatePair(size_t combIndex, size_t neighborIndex, bool fromLeft, float offsetX, float offsetY, float peak)
+    {
+      DetermineStitching::TilePair pair;
+      pair.combIndex = combIndex;
+      pair.neighborIndex = neighborIndex;
+      pair.fromLeft = fromLeft;
+      pair.cropSpecsIm1Im2.resize(12, 0);
+      pair.newXYOrigin.resize(4, 0);
+      if(fromLeft)
+      {
+        pair.cropSpecsIm1Im2[0] = 96;
+        pair.newXYOrigin[0] = offsetX - pair.cropSpecsIm1Im2[0];
+        pair.newXYOrigin[1] = offsetY;
+      }
+      else
+      {
+        pair.cropSpecsIm1Im2[1] = 72;
+        pair.newXYOrigin[0] = offsetX;
+        pair.newXYOrigin[1] = offsetY - pair.cropSpecsIm1Im2[1];
+      }
+      pair.newXYOrigin[2] = peak;
+      return pair;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Solves a 2 x 2 grid where the pair between the bottom tiles disagrees with the other three by 4 pixels along x.
+    // The error is spread over the loop in proportion to 1 / weight, so with the other pairs at weight 1 every one of
+    // them takes 4 / (3 + 1 / weight) of it.
+    // -----------------------------------------------------------------------------
+    int TestSolveGlobalOrigins()
+    {
+      const double offsetLeftX = 100.0;
+      const double offsetLeftY = 2.0;
+      const double offsetTopX = -1.0;
+      const double offsetTopY = 70.0;
+
+      const float weights[3] = { 1.0f, 0.5f, 0.0f };
+      for(float weight : weights)
+      {
+        std::vector<DetermineStitching::TilePair> pairs;
+        pairs.push_back(CreatePair(1, 0, true, offsetLeftX, offsetLeftY, 1.0f));
+        pairs.push_back(CreatePair(2, 0, false, offsetTopX, offsetTopY, 1.0f));
+        pairs.push_back(CreatePair(3, 1, false, offsetTopX, offsetTopY, 1.0f));
+        pairs.push_back(CreatePair(3, 2, true, offsetLeftX + 4, offsetLeftY, weight));
+
+        // The starting guess must not matter
+        std::vector<double> xyCombOrigins = { 0.0, 0.0, 90.0, 5.0, 3.0, 60.0, 110.0, 80.0 };
+        DetermineStitching::SolveGlobalOrigins(pairs, 4, xyCombOrigins);
+
+        // Pairs with a peak of 0 or less are kept with the minimum weight so the grid stays connected
+        const double share = 4.0 / (3.0 + 1.0 / std::max(static_cast<double>(weight), 1.0E-3));
+        const double expected[8] = { 0.0, 0.0, offsetLeftX + share, offsetLeftY, offsetTopX - share, offsetTopY, offsetLeftX + offsetTopX + 2 * share, offsetLeftY + offsetTopY };
+        for(size_t i = 0; i < 8; i++)
+        {
+          DREAM3D_REQUIRED(std::fabs(xyCombOrigins[i] - expected[i]), <=, 1.0E-6)
+        }
+      }
+
+      // A tile without any pair keeps its starting position
+      std::vector<DetermineStitching::TilePair> pairs;
+      pairs.push_back(CreatePair(1, 0, true, offsetLeftX, offsetLeftY, 1.0f));
+      std::vector<double> xyCombOrigins = { 0.0, 0.0, 90.0, 5.0, 7.0, 65.0 };
+      DetermineStitching::SolveGlobalOrigins(pairs, 3, xyCombOrigins);
+      DREAM3D_REQUIRED(std::fabs(xyCombOrigins[2] - offsetLeftX), <=, 1.0E-6)
+      DREAM3D_REQUIRED(std::fabs(xyCombOrigins[3] - offsetLeftY), <=, 1.0E-6)
+      DREAM3D_REQUIRED(std::fabs(xyCombOrigins[4] - 7.0), <=, 1.0E-6)
+      DREAM3D_REQUIRED(std::fabs(xyCombOrigins[5] - 65.0), <=, 1.0E-6)
+      return EXIT_SUCCESS;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      std::cout << "#### DetermineStitchingTest Starting ####" << std::endl;
+
+      DREAM3D_REGISTER_TEST(TestPairsMatchItk());
+      DREAM3D_REGISTER_TEST(TestMatchesSerialWalk());
+      DREAM3D_REGISTER_TEST(TestRecoversTileOffsets());
+      DREAM3D_REGISTER_TEST(TestCoarseToFineMatchesFullResolution());
+      DREAM3D_REGISTER_TEST(TestLeastSquaresMatchesChained());
+      DREAM3D_REGISTER_TEST(TestSolveGlobalOrigins());
+    }
+
+  private:
+    DetermineStitchingTest(const DetermineStitchingTest&); // Copy Constructor Not Implemented
+    void operator=(const DetermineStitchingTest&);         // Operator '=' Not Implemented
+};
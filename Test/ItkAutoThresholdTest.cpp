@@ -0,0 +1,345 @@
+/* ============================================================================
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the names of any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  This code was partially written under United States Air Force Contract number
+ *                              FA8650-10-D-5210
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <QtCore/QString>
+
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/FilterFactory.hpp"
+#include "SIMPLib/Filtering/FilterManager.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+#include "SIMPLib/SIMPLib.h"
+#include "UnitTestSupport.hpp"
+
+#include "itkHistogramThresholdCalculator.h"
+#include "itkHuangThresholdCalculator.h"
+#include "itkImage.h"
+#include "itkImageToHistogramFilter.h"
+#include "itkIntermodesThresholdCalculator.h"
+#include "itkIsoDataThresholdCalculator.h"
+#include "itkKittlerIllingworthThresholdCalculator.h"
+#include "itkLiThresholdCalculator.h"
+#include "itkMaximumEntropyThresholdCalculator.h"
+#include "itkMomentsThresholdCalculator.h"
+#include "itkOtsuThresholdCalculator.h"
+#include "itkRenyiEntropyThresholdCalculator.h"
+#include "itkShanbhagThresholdCalculator.h"
+#include "itkTriangleThresholdCalculator.h"
+#include "itkYenThresholdCalculator.h"
+
+#include "ImageProcessing/ImageProcessingConstants.h"
+
+/**
+ * @brief The ItkAutoThresholdTest class checks every method of ItkAutoThreshold, on whole volumes and slice by slice,
+ * against itk::Statistics::ImageToHistogramFilter and the itk threshold calculators. It also checks that a histogram
+ * cached by one filter is reused by the next one and that an array written in place is counted again.
+ */
+class ItkAutoThresholdTest
+{
+  public:
+    ItkAutoThresholdTest() = default;
+    virtual ~ItkAutoThresholdTest() = default;
+
+    typedef ImageProcessingConstants::DefaultPixelType PixelType;
+    typedef ImageProcessingConstants::DefaultArrayType ArrayType;
+    typedef itk::Statistics::Histogram<double> HistogramType;
+    typedef itk::HistogramThresholdCalculator<HistogramType, uint8_t> CalculatorType;
+
+    static const unsigned int k_NumMethods = 12;
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    int TestFilterAvailability()
+    {
+      QString filtName = "ItkAutoThreshold";
+      FilterManager* fm = FilterManager::Instance();
+      IFilterFactory::Pointer filterFactory = fm->getFactoryFromClassName(filtName);
+      if(nullptr == filterFactory.get())
+      {
+        std::stringstream ss;
+        ss << "The ItkAutoThresholdTest requires the " << filtName.toStdString() << " filter which was not found.";
+        DREAM3D_TEST_THROW_EXCEPTION(ss.str())
+      }
+      return EXIT_SUCCESS;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Creates a volume of two noisy phases whose share changes from slice to slice, so every slice has its own threshold
+    // -----------------------------------------------------------------------------
+    DataContainerArray::Pointer CreateVolume(size_t xDim, size_t yDim, size_t zDim)
+    {
+      DataContainerArray::Pointer dca = DataContainerArray::New();
+      DataContainer::Pointer m = DataContainer::New("DataContainer");
+      ImageGeom::Pointer image = ImageGeom::CreateGeometry(SIMPL::Geometry::ImageGeometry);
+      image->setDimensions(xDim, yDim, zDim);
+      m->setGeometry(image);
+
+      QVector<size_t> tDims = { xDim, yDim, zDim };
+      AttributeMatrix::Pointer attrMat = AttributeMatrix::New(tDims, "CellData", AttributeMatrix::Type::Cell);
+      m->addAttributeMatrix("CellData", attrMat);
+
+      ArrayType::Pointer data = ArrayType::CreateArray(tDims, QVector<size_t>(1, 1), "ImageData");
+      uint32_t state = 12345;
+      for(size_t i = 0; i < data->getNumberOfTuples(); i++)
+      {
+        state = state * 1664525u + 1013904223u;
+        const size_t x = i % xDim;
+        const size_t z = i / (xDim * yDim);
+        const bool bright = x < xDim * (z + 1) / (zDim + 1);
+        data->setValue(i, static_cast<PixelType>((bright ? 170 : 60) + (state >> 24) % 50));
+      }
+      attrMat->addAttributeArray("ImageData", data);
+      dca->addDataContainer(m);
+      return dca;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    CalculatorType::Pointer CreateCalculator(unsigned int method)
+    {
+      switch(method)
+      {
+        case 0:
+          return itk::HuangThresholdCalculator<HistogramType, uint8_t>::New().GetPointer();
+        case 1:
+          return itk::IntermodesThresholdCalculator<HistogramType, uint8_t>::New().GetPointer();
+        case 2:
+          return itk::IsoDataThresholdCalculator<HistogramType, uint8_t>::New().GetPointer();
+        case 3:
+          return itk::KittlerIllingworthThresholdCalculator<HistogramType, uint8_t>::New().GetPointer();
+        case 4:
+          return itk::LiThresholdCalculator<HistogramType, uint8_t>::New().GetPointer();
+        case 5:
+          return itk::MaximumEntropyThresholdCalculator<HistogramType, uint8_t>::New().GetPointer();
+        case 6:
+          return itk::MomentsThresholdCalculator<HistogramType, uint8_t>::New().GetPointer();
+        case 7:
+          return itk::OtsuThresholdCalculator<HistogramType, uint8_t>::New().GetPointer();
+        case 8:
+          return itk::RenyiEntropyThresholdCalculator<HistogramType, uint8_t>::New().GetPointer();
+        case 9:
+          return itk::ShanbhagThresholdCalculator<HistogramType, uint8_t>::New().GetPointer();
+        case 10:
+          return itk::TriangleThresholdCalculator<HistogramType, uint8_t>::New().GetPointer();
+        default:
+          return itk::YenThresholdCalculator<HistogramType, uint8_t>::New().GetPointer();
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    // Thresholds count values of input the way ItkAutoThreshold did before the histogram cache, with a Dim dimensional
+    // itk::Statistics::ImageToHistogramFilter of 255 bins over [0, 256]
+    // -----------------------------------------------------------------------------
+    template <unsigned int Dim>
+    void RunItkThreshold(const PixelType* input, const size_t* dims, unsigned int method, PixelType* output)
+    {
+      typedef itk::Image<PixelType, Dim> ImageType;
+      typename ImageType::Pointer image = ImageType::New();
+      typename ImageType::SizeType size;
+      size_t count = 1;
+      for(unsigned int i = 0; i < Dim; i++)
+      {
+        size[i] = dims[i];
+        count *= dims[i];
+      }
+      typename ImageType::RegionType region;
+      region.SetSize(size);
+      image->SetRegions(region);
+      image->Allocate();
+      std::copy(input, input + count, image->GetBufferPointer());
+
+      typedef itk::Statistics::ImageToHistogramFilter<ImageType> HistogramGenerator;
+      typename HistogramGenerator::Pointer histogramFilter = HistogramGenerator::New();
+      typename HistogramGenerator::HistogramSizeType histogramSize(1);
+      histogramSize[0] = 255;
+      histogramFilter->SetHistogramSize(histogramSize);
+      histogramFilter->SetMarginalScale(10.0);
+      typename HistogramGenerator::HistogramMeasurementVectorType lowerBound(1);
+      typename HistogramGenerator::HistogramMeasurementVectorType upperBound(1);
+      lowerBound[0] = 0;
+      upperBound[0] = 256;
+      histogramFilter->SetHistogramBinMinimum(lowerBound);
+      histogramFilter->SetHistogramBinMaximum(upperBound);
+      histogramFilter->SetInput(image);
+      histogramFilter->Update();
+
+      CalculatorType::Pointer calculator = CreateCalculator(method);
+      calculator->SetInput(histogramFilter->GetOutput());
+      calculator->Update();
+      const uint8_t thresholdValue = calculator->GetThreshold();
+      for(size_t i = 0; i < count; i++)
+      {
+        output[i] = (input[i] >= thresholdValue && input[i] <= 255) ? 255 : 0;
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    std::vector<PixelType> ExpectedThreshold(ArrayType::Pointer input, const size_t dims[3], unsigned int method, bool slice)
+    {
+      std::vector<PixelType> expected(input->getNumberOfTuples());
+      if(slice)
+      {
+        const size_t planeSize = dims[0] * dims[1];
+        for(size_t z = 0; z < dims[2]; z++)
+        {
+          RunItkThreshold<2>(input->getPointer(z * planeSize), dims, method, expected.data() + z * planeSize);
+        }
+      }
+      else
+      {
+        RunItkThreshold<3>(input->getPointer(0), dims, method, expected.data());
+      }
+      return expected;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    AbstractFilter::Pointer CreateFilter(DataContainerArray::Pointer dca, unsigned int method, bool slice, const QString& newArrayName)
+    {
+      IFilterFactory::Pointer filterFactory = FilterManager::Instance()->getFactoryFromClassName("ItkAutoThreshold");
+      AbstractFilter::Pointer filter = filterFactory->create();
+      filter->setDataContainerArray(dca);
+
+      QVariant var;
+      var.setValue(DataArrayPath("DataContainer", "CellData", "ImageData"));
+      bool propWasSet = filter->setProperty("SelectedCellArrayPath", var);
+      DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+      propWasSet = filter->setProperty("Method", method);
+      DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+      propWasSet = filter->setProperty("Slice", slice);
+      DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+      propWasSet = filter->setProperty("SaveAsNewArray", true);
+      DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+      propWasSet = filter->setProperty("NewCellArrayName", newArrayName);
+      DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+      return filter;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void CheckOutput(DataContainerArray::Pointer dca, const QString& arrayName, const std::vector<PixelType>& expected)
+    {
+      AttributeMatrix::Pointer attrMat = dca->getDataContainer("DataContainer")->getAttributeMatrix("CellData");
+      ArrayType::Pointer output = attrMat->getAttributeArrayAs<ArrayType>(arrayName);
+      DREAM3D_REQUIRE_VALID_POINTER(output.get())
+      DREAM3D_REQUIRE_EQUAL(output->getNumberOfTuples(), expected.size())
+      for(size_t i = 0; i < expected.size(); i++)
+      {
+        DREAM3D_REQUIRE_EQUAL(output->getValue(i), expected[i])
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    int TestMatchesItk()
+    {
+      const size_t dims[3] = { 41, 29, 6 };
+      for(int slice = 0; slice < 2; slice++)
+      {
+        for(unsigned int method = 0; method < k_NumMethods; method++)
+        {
+          DataContainerArray::Pointer dca = CreateVolume(dims[0], dims[1], dims[2]);
+          ArrayType::Pointer input = dca->getDataContainer("DataContainer")->getAttributeMatrix("CellData")->getAttributeArrayAs<ArrayType>("ImageData");
+
+          AbstractFilter::Pointer filter = CreateFilter(dca, method, slice != 0, "Threshold");
+          filter->execute();
+          DREAM3D_REQUIRED(filter->getErrorCondition(), >=, 0)
+          CheckOutput(dca, "Threshold", ExpectedThreshold(input, dims, method, slice != 0));
+        }
+      }
+      return EXIT_SUCCESS;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Runs several methods back to back on one array, as a pipeline would, and edits the array in place in between
+    // -----------------------------------------------------------------------------
+    int TestCachedHistograms()
+    {
+      const size_t dims[3] = { 37, 23, 5 };
+      DataContainerArray::Pointer dca = CreateVolume(dims[0], dims[1], dims[2]);
+      ArrayType::Pointer input = dca->getDataContainer("DataContainer")->getAttributeMatrix("CellData")->getAttributeArrayAs<ArrayType>("ImageData");
+
+      // the second filter follows the first one directly and reuses its histograms
+      AbstractFilter::Pointer otsu = CreateFilter(dca, 7, false, "Otsu");
+      AbstractFilter::Pointer huang = CreateFilter(dca, 0, false, "Huang");
+      huang->setPreviousFilter(otsu);
+      otsu->execute();
+      DREAM3D_REQUIRED(otsu->getErrorCondition(), >=, 0)
+      huang->execute();
+      DREAM3D_REQUIRED(huang->getErrorCondition(), >=, 0)
+      CheckOutput(dca, "Otsu", ExpectedThreshold(input, dims, 7, false));
+      CheckOutput(dca, "Huang", ExpectedThreshold(input, dims, 0, false));
+
+      // an in place edit keeps the array, its buffer and its size, the next filter has to count it again
+      for(size_t i = 0; i < input->getNumberOfTuples(); i++)
+      {
+        input->setValue(i, static_cast<PixelType>(255 - input->getValue(i)));
+      }
+      AbstractFilter::Pointer yen = CreateFilter(dca, 11, true, "Yen");
+      yen->execute();
+      DREAM3D_REQUIRED(yen->getErrorCondition(), >=, 0)
+      CheckOutput(dca, "Yen", ExpectedThreshold(input, dims, 11, true));
+      return EXIT_SUCCESS;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      std::cout << "#### ItkAutoThresholdTest Starting ####" << std::endl;
+
+      DREAM3D_REGISTER_TEST(TestFilterAvailability());
+      DREAM3D_REGISTER_TEST(TestMatchesItk());
+      DREAM3D_REGISTER_TEST(TestCachedHistograms());
+    }
+
+  private:
+    ItkAutoThresholdTest(const ItkAutoThresholdTest&); // Copy Constructor Not Implemented
+    void operator=(const ItkAutoThresholdTest&);       // Operator '=' Not Implemented
+};
@@ -0,0 +1,249 @@
+/* ============================================================================
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the names of any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  This code was partially written under United States Air Force Contract number
+ *                              FA8650-10-D-5210
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+#include <QtCore/QString>
+
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/FilterFactory.hpp"
+#include "SIMPLib/Filtering/FilterManager.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+#include "SIMPLib/SIMPLib.h"
+#include "UnitTestSupport.hpp"
+
+#include "itkDiscreteGaussianImageFilter.h"
+#include "itkImage.h"
+#include "itkRescaleIntensityImageFilter.h"
+
+#include "ImageProcessing/ImageProcessingConstants.h"
+
+/**
+ * @brief The ItkDiscreteGaussianBlurTest class checks the fused blur and rescale of ItkDiscreteGaussianBlur against
+ * the itk::DiscreteGaussianImageFilter and itk::RescaleIntensityImageFilter pipeline of its default path and prints
+ * how long both take on a larger volume
+ */
+class ItkDiscreteGaussianBlurTest
+{
+  public:
+    ItkDiscreteGaussianBlurTest() = default;
+    virtual ~ItkDiscreteGaussianBlurTest() = default;
+
+    typedef ImageProcessingConstants::DefaultPixelType PixelType;
+    typedef ImageProcessingConstants::DefaultArrayType ArrayType;
+    typedef itk::Image<PixelType, 3> ImageType;
+    typedef itk::Image<float, 3> FloatImageType;
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    int TestFilterAvailability()
+    {
+      QString filtName = "ItkDiscreteGaussianBlur";
+      FilterManager* fm = FilterManager::Instance();
+      IFilterFactory::Pointer filterFactory = fm->getFactoryFromClassName(filtName);
+      if(nullptr == filterFactory.get())
+      {
+        std::stringstream ss;
+        ss << "The ItkDiscreteGaussianBlurTest requires the " << filtName.toStdString() << " filter which was not found.";
+        DREAM3D_TEST_THROW_EXCEPTION(ss.str())
+      }
+      return EXIT_SUCCESS;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Creates a volume with smooth gradients, noise and anisotropic voxels, so every axis gets its own kernel
+    // -----------------------------------------------------------------------------
+    DataContainerArray::Pointer CreateVolume(size_t xDim, size_t yDim, size_t zDim)
+    {
+      DataContainerArray::Pointer dca = DataContainerArray::New();
+      DataContainer::Pointer m = DataContainer::New("DataContainer");
+      ImageGeom::Pointer image = ImageGeom::CreateGeometry(SIMPL::Geometry::ImageGeometry);
+      image->setDimensions(xDim, yDim, zDim);
+      image->setResolution(1.0f, 0.5f, 2.0f);
+      m->setGeometry(image);
+
+      QVector<size_t> tDims = { xDim, yDim, zDim };
+      AttributeMatrix::Pointer attrMat = AttributeMatrix::New(tDims, "CellData", AttributeMatrix::Type::Cell);
+      m->addAttributeMatrix("CellData", attrMat);
+
+      ArrayType::Pointer data = ArrayType::CreateArray(tDims, QVector<size_t>(1, 1), "ImageData");
+      uint32_t state = 12345;
+      for(size_t i = 0; i < data->getNumberOfTuples(); i++)
+      {
+        state = state * 1664525u + 1013904223u;
+        const size_t x = i % xDim;
+        const size_t y = (i / xDim) % yDim;
+        const size_t z = i / (xDim * yDim);
+        data->setValue(i, static_cast<PixelType>((x * 2 + y / 3 + z * 7 + (state >> 24) % 64) % 256));
+      }
+      attrMat->addAttributeArray("ImageData", data);
+      dca->addDataContainer(m);
+      return dca;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    ImageType::Pointer RunItkBlur(ArrayType::Pointer data, const size_t dims[3], float stdev)
+    {
+      ImageType::Pointer image = ImageType::New();
+      ImageType::SizeType size;
+      size[0] = dims[0];
+      size[1] = dims[1];
+      size[2] = dims[2];
+      ImageType::RegionType region;
+      region.SetSize(size);
+      image->SetRegions(region);
+      ImageType::SpacingType spacing;
+      spacing[0] = 1.0;
+      spacing[1] = 0.5;
+      spacing[2] = 2.0;
+      image->SetSpacing(spacing);
+      image->Allocate();
+      std::copy(data->getPointer(0), data->getPointer(0) + data->getNumberOfTuples(), image->GetBufferPointer());
+
+      typedef itk::DiscreteGaussianImageFilter<ImageType, FloatImageType> GaussianFilterType;
+      GaussianFilterType::Pointer gaussianFilter = GaussianFilterType::New();
+      gaussianFilter->SetInput(image);
+      gaussianFilter->SetVariance(stdev * stdev);
+
+      typedef itk::RescaleIntensityImageFilter<FloatImageType, ImageType> RescaleImageType;
+      RescaleImageType::Pointer rescaleFilter = RescaleImageType::New();
+      rescaleFilter->SetInput(gaussianFilter->GetOutput());
+      rescaleFilter->SetOutputMinimum(0);
+      rescaleFilter->SetOutputMaximum(255);
+      rescaleFilter->Update();
+      return rescaleFilter->GetOutput();
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void CompareWithItk(size_t xDim, size_t yDim, size_t zDim, float stdev, bool printTimes)
+    {
+      DataContainerArray::Pointer dca = CreateVolume(xDim, yDim, zDim);
+      DataArrayPath inputPath("DataContainer", "CellData", "ImageData");
+      AttributeMatrix::Pointer attrMat = dca->getDataContainer("DataContainer")->getAttributeMatrix("CellData");
+      ArrayType::Pointer input = attrMat->getAttributeArrayAs<ArrayType>("ImageData");
+
+      IFilterFactory::Pointer filterFactory = FilterManager::Instance()->getFactoryFromClassName("ItkDiscreteGaussianBlur");
+      AbstractFilter::Pointer filter = filterFactory->create();
+      filter->setDataContainerArray(dca);
+
+      QVariant var;
+      var.setValue(inputPath);
+      bool propWasSet = filter->setProperty("SelectedCellArrayPath", var);
+      DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+      propWasSet = filter->setProperty("Stdev", stdev);
+      DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+      propWasSet = filter->setProperty("FusedRescale", true);
+      DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+      propWasSet = filter->setProperty("SaveAsNewArray", true);
+      DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+      propWasSet = filter->setProperty("NewCellArrayName", "Blurred");
+      DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      filter->execute();
+      std::chrono::duration<double> filterTime = std::chrono::steady_clock::now() - start;
+      DREAM3D_REQUIRED(filter->getErrorCondition(), >=, 0)
+
+      const size_t dims[3] = { xDim, yDim, zDim };
+      start = std::chrono::steady_clock::now();
+      ImageType::Pointer expected = RunItkBlur(input, dims, stdev);
+      std::chrono::duration<double> itkTime = std::chrono::steady_clock::now() - start;
+
+      ArrayType::Pointer output = attrMat->getAttributeArrayAs<ArrayType>("Blurred");
+      DREAM3D_REQUIRE_VALID_POINTER(output.get())
+      const PixelType* expectedValues = expected->GetBufferPointer();
+      // ITK keeps the blurred volume in float between the filters, which can move a value across a rounding boundary
+      for(size_t i = 0; i < output->getNumberOfTuples(); i++)
+      {
+        const double difference = static_cast<double>(output->getValue(i)) - static_cast<double>(expectedValues[i]);
+        DREAM3D_REQUIRE(difference >= -1.0 && difference <= 1.0)
+      }
+
+      if(printTimes)
+      {
+        std::cout << "Gaussian blur of " << xDim << " x " << yDim << " x " << zDim << " voxels with standard deviation " << stdev << ": fused blur and rescale "
+                  << filterTime.count() << " s, itk::DiscreteGaussianImageFilter and itk::RescaleIntensityImageFilter " << itkTime.count() << " s" << std::endl;
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    int TestMatchesItk()
+    {
+      // Kernels wider than the volume, a single slice, a single column and a thin stack that is split into bands
+      CompareWithItk(23, 17, 9, 1.5f, false);
+      CompareWithItk(7, 5, 3, 4.0f, false);
+      CompareWithItk(50, 20, 1, 2.0f, false);
+      CompareWithItk(1, 30, 6, 1.0f, false);
+      CompareWithItk(40, 150, 5, 2.0f, false);
+      return EXIT_SUCCESS;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    int BenchmarkAgainstItk()
+    {
+      CompareWithItk(256, 256, 64, 1.0f, true);
+      CompareWithItk(256, 256, 64, 3.0f, true);
+      return EXIT_SUCCESS;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      std::cout << "#### ItkDiscreteGaussianBlurTest Starting ####" << std::endl;
+
+      DREAM3D_REGISTER_TEST(TestFilterAvailability());
+      DREAM3D_REGISTER_TEST(TestMatchesItk());
+      DREAM3D_REGISTER_TEST(BenchmarkAgainstItk());
+    }
+
+  private:
+    ItkDiscreteGaussianBlurTest(const ItkDiscreteGaussianBlurTest&); // Copy Constructor Not Implemented
+    void operator=(const ItkDiscreteGaussianBlurTest&);                // Operator '=' Not Implemented
+};
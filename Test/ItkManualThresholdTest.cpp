@@ -0,0 +1,232 @@
+/* ============================================================================
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the names of any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  This code was partially written under United States Air Force Contract number
+ *                              FA8650-10-D-5210
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+#include <QtCore/QString>
+
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/FilterFactory.hpp"
+#include "SIMPLib/Filtering/FilterManager.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+#include "SIMPLib/SIMPLib.h"
+#include "UnitTestSupport.hpp"
+
+#include "itkBinaryThresholdImageFilter.h"
+#include "itkImage.h"
+
+#include "ImageProcessing/ImageProcessingConstants.h"
+
+/**
+ * @brief The ItkManualThresholdTest class checks ItkManualThreshold and ItkManualThresholdTemplate, whose 8 and 16 bit
+ * arrays are thresholded through lookup tables, against itk::BinaryThresholdImageFilter
+ */
+class ItkManualThresholdTest
+{
+  public:
+    ItkManualThresholdTest() = default;
+    virtual ~ItkManualThresholdTest() = default;
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    int TestFilterAvailability()
+    {
+      QStringList filtNames = { "ItkManualThreshold", "ItkManualThresholdTemplate" };
+      FilterManager* fm = FilterManager::Instance();
+      for(const QString& filtName : filtNames)
+      {
+        IFilterFactory::Pointer filterFactory = fm->getFactoryFromClassName(filtName);
+        if(nullptr == filterFactory.get())
+        {
+          std::stringstream ss;
+          ss << "The ItkManualThresholdTest requires the " << filtName.toStdString() << " filter which was not found.";
+          DREAM3D_TEST_THROW_EXCEPTION(ss.str())
+        }
+      }
+      return EXIT_SUCCESS;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Creates a volume whose values sweep the range of T around the thresholds, [-1000, 1000] at most
+    // -----------------------------------------------------------------------------
+    template <typename T>
+    DataContainerArray::Pointer CreateVolume(size_t xDim, size_t yDim, size_t zDim)
+    {
+      DataContainerArray::Pointer dca = DataContainerArray::New();
+      DataContainer::Pointer m = DataContainer::New("DataContainer");
+      ImageGeom::Pointer image = ImageGeom::CreateGeometry(SIMPL::Geometry::ImageGeometry);
+      image->setDimensions(xDim, yDim, zDim);
+      m->setGeometry(image);
+
+      QVector<size_t> tDims = { xDim, yDim, zDim };
+      AttributeMatrix::Pointer attrMat = AttributeMatrix::New(tDims, "CellData", AttributeMatrix::Type::Cell);
+      m->addAttributeMatrix("CellData", attrMat);
+
+      typename DataArray<T>::Pointer data = DataArray<T>::CreateArray(tDims, QVector<size_t>(1, 1), "ImageData");
+      const double lowest = std::max(static_cast<double>(std::numeric_limits<T>::lowest()), -1000.0);
+      const double highest = std::min(static_cast<double>(std::numeric_limits<T>::max()), 1000.0);
+      const double step = (highest - lowest) / static_cast<double>(data->getNumberOfTuples());
+      uint32_t state = 12345;
+      for(size_t i = 0; i < data->getNumberOfTuples(); i++)
+      {
+        // shuffle the sweep so neighbouring voxels differ
+        state = state * 1664525u + 1013904223u;
+        const size_t j = (i + (state >> 16)) % data->getNumberOfTuples();
+        data->setValue(i, static_cast<T>(lowest + step * static_cast<double>(j)));
+      }
+      attrMat->addAttributeArray("ImageData", data);
+      dca->addDataContainer(m);
+      return dca;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    template <typename T>
+    std::vector<T> RunItkThreshold(typename DataArray<T>::Pointer data, const size_t dims[3], int threshold)
+    {
+      typedef itk::Image<T, 3> ImageType;
+      typename ImageType::Pointer image = ImageType::New();
+      typename ImageType::SizeType size;
+      size[0] = dims[0];
+      size[1] = dims[1];
+      size[2] = dims[2];
+      typename ImageType::RegionType region;
+      region.SetSize(size);
+      image->SetRegions(region);
+      image->Allocate();
+      std::copy(data->getPointer(0), data->getPointer(0) + data->getNumberOfTuples(), image->GetBufferPointer());
+
+      typedef itk::BinaryThresholdImageFilter<ImageType, ImageType> BinaryThresholdImageFilterType;
+      typename BinaryThresholdImageFilterType::Pointer thresholdFilter = BinaryThresholdImageFilterType::New();
+      thresholdFilter->SetInput(image);
+      thresholdFilter->SetLowerThreshold(threshold);
+      thresholdFilter->SetUpperThreshold(0xFF);
+      thresholdFilter->SetInsideValue(255);
+      thresholdFilter->SetOutsideValue(0);
+      thresholdFilter->Update();
+      const T* output = thresholdFilter->GetOutput()->GetBufferPointer();
+      return std::vector<T>(output, output + data->getNumberOfTuples());
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    template <typename T>
+    void CompareWithItk(const QString& filtName, const QString& pathProperty, int threshold, bool saveAsNewArray)
+    {
+      const size_t dims[3] = { 37, 23, 11 };
+      DataContainerArray::Pointer dca = CreateVolume<T>(dims[0], dims[1], dims[2]);
+      DataArrayPath inputPath("DataContainer", "CellData", "ImageData");
+      AttributeMatrix::Pointer attrMat = dca->getDataContainer("DataContainer")->getAttributeMatrix("CellData");
+      typename DataArray<T>::Pointer input = attrMat->getAttributeArrayAs<DataArray<T>>("ImageData");
+      std::vector<T> expected = RunItkThreshold<T>(input, dims, threshold);
+
+      IFilterFactory::Pointer filterFactory = FilterManager::Instance()->getFactoryFromClassName(filtName);
+      AbstractFilter::Pointer filter = filterFactory->create();
+      filter->setDataContainerArray(dca);
+
+      QVariant var;
+      var.setValue(inputPath);
+      bool propWasSet = filter->setProperty(pathProperty.toLatin1().constData(), var);
+      DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+      propWasSet = filter->setProperty("ManualParameter", threshold);
+      DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+      propWasSet = filter->setProperty("SaveAsNewArray", saveAsNewArray);
+      DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+      propWasSet = filter->setProperty("NewCellArrayName", "Threshold");
+      DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+      filter->execute();
+      DREAM3D_REQUIRED(filter->getErrorCondition(), >=, 0)
+
+      typename DataArray<T>::Pointer output = attrMat->getAttributeArrayAs<DataArray<T>>(saveAsNewArray ? "Threshold" : "ImageData");
+      DREAM3D_REQUIRE_VALID_POINTER(output.get())
+      DREAM3D_REQUIRE_EQUAL(output->getNumberOfTuples(), expected.size())
+      for(size_t i = 0; i < expected.size(); i++)
+      {
+        DREAM3D_REQUIRE_EQUAL(output->getValue(i), expected[i])
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    int TestManualThreshold()
+    {
+      typedef ImageProcessingConstants::DefaultPixelType PixelType;
+      CompareWithItk<PixelType>("ItkManualThreshold", "SelectedCellArrayPath", 128, true);
+      CompareWithItk<PixelType>("ItkManualThreshold", "SelectedCellArrayPath", 0, true);
+      CompareWithItk<PixelType>("ItkManualThreshold", "SelectedCellArrayPath", 255, false);
+      return EXIT_SUCCESS;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    int TestManualThresholdTemplate()
+    {
+      // Lookup tables for the 8 and 16 bit types, itk::BinaryThresholdImageFilter for the others
+      CompareWithItk<uint8_t>("ItkManualThresholdTemplate", "SelectedCellArrayArrayPath", 100, true);
+      CompareWithItk<uint8_t>("ItkManualThresholdTemplate", "SelectedCellArrayArrayPath", 100, false);
+      CompareWithItk<uint16_t>("ItkManualThresholdTemplate", "SelectedCellArrayArrayPath", 7, true);
+      CompareWithItk<int16_t>("ItkManualThresholdTemplate", "SelectedCellArrayArrayPath", -3, true);
+      CompareWithItk<int32_t>("ItkManualThresholdTemplate", "SelectedCellArrayArrayPath", 40, true);
+      CompareWithItk<float>("ItkManualThresholdTemplate", "SelectedCellArrayArrayPath", 12, true);
+      return EXIT_SUCCESS;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      std::cout << "#### ItkManualThresholdTest Starting ####" << std::endl;
+
+      DREAM3D_REGISTER_TEST(TestFilterAvailability());
+      DREAM3D_REGISTER_TEST(TestManualThreshold());
+      DREAM3D_REGISTER_TEST(TestManualThresholdTemplate());
+    }
+
+  private:
+    ItkManualThresholdTest(const ItkManualThresholdTest&); // Copy Constructor Not Implemented
+    void operator=(const ItkManualThresholdTest&);         // Operator '=' Not Implemented
+};
@@ -0,0 +1,256 @@
+/* ============================================================================
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the names of any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  This code was partially written under United States Air Force Contract number
+ *                              FA8650-10-D-5210
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+#include <QtCore/QString>
+
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/FilterFactory.hpp"
+#include "SIMPLib/Filtering/FilterManager.h"
+#include "SIMPLib/FilterParameters/IntVec3FilterParameter.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+#include "SIMPLib/SIMPLib.h"
+#include "UnitTestSupport.hpp"
+
+#include "itkImage.h"
+#include "itkMeanImageFilter.h"
+#include "itkRescaleIntensityImageFilter.h"
+
+#include "ImageProcessing/ImageProcessingConstants.h"
+
+/**
+ * @brief The ItkMeanKernelTest class checks ItkMeanKernel against the itk::MeanImageFilter and
+ * itk::RescaleIntensityImageFilter pipeline it replaces and prints how long both take on a larger volume
+ */
+class ItkMeanKernelTest
+{
+  public:
+    ItkMeanKernelTest() = default;
+    virtual ~ItkMeanKernelTest() = default;
+
+    typedef ImageProcessingConstants::DefaultPixelType PixelType;
+    typedef ImageProcessingConstants::DefaultArrayType ArrayType;
+    typedef itk::Image<PixelType, 3> ImageType;
+    typedef itk::Image<float, 3> FloatImageType;
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    int TestFilterAvailability()
+    {
+      QString filtName = "ItkMeanKernel";
+      FilterManager* fm = FilterManager::Instance();
+      IFilterFactory::Pointer filterFactory = fm->getFactoryFromClassName(filtName);
+      if(nullptr == filterFactory.get())
+      {
+        std::stringstream ss;
+        ss << "The ItkMeanKernelTest requires the " << filtName.toStdString() << " filter which was not found.";
+        DREAM3D_TEST_THROW_EXCEPTION(ss.str())
+      }
+      return EXIT_SUCCESS;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Creates a volume with smooth gradients and noise, so the kernels hold many distinct values
+    // -----------------------------------------------------------------------------
+    DataContainerArray::Pointer CreateVolume(size_t xDim, size_t yDim, size_t zDim)
+    {
+      DataContainerArray::Pointer dca = DataContainerArray::New();
+      DataContainer::Pointer m = DataContainer::New("DataContainer");
+      ImageGeom::Pointer image = ImageGeom::CreateGeometry(SIMPL::Geometry::ImageGeometry);
+      image->setDimensions(xDim, yDim, zDim);
+      m->setGeometry(image);
+
+      QVector<size_t> tDims = { xDim, yDim, zDim };
+      AttributeMatrix::Pointer attrMat = AttributeMatrix::New(tDims, "CellData", AttributeMatrix::Type::Cell);
+      m->addAttributeMatrix("CellData", attrMat);
+
+      ArrayType::Pointer data = ArrayType::CreateArray(tDims, QVector<size_t>(1, 1), "ImageData");
+      uint32_t state = 12345;
+      for(size_t i = 0; i < data->getNumberOfTuples(); i++)
+      {
+        state = state * 1664525u + 1013904223u;
+        const size_t x = i % xDim;
+        const size_t y = (i / xDim) % yDim;
+        data->setValue(i, static_cast<PixelType>((x / 4 + y / 8 + (state >> 24) % 48) % 256));
+      }
+      attrMat->addAttributeArray("ImageData", data);
+      dca->addDataContainer(m);
+      return dca;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    ImageType::Pointer RunItkMean(ArrayType::Pointer data, const size_t dims[3], const IntVec3_t& radius)
+    {
+      ImageType::Pointer image = ImageType::New();
+      ImageType::SizeType size;
+      size[0] = dims[0];
+      size[1] = dims[1];
+      size[2] = dims[2];
+      ImageType::RegionType region;
+      region.SetSize(size);
+      image->SetRegions(region);
+      image->Allocate();
+      std::copy(data->getPointer(0), data->getPointer(0) + data->getNumberOfTuples(), image->GetBufferPointer());
+
+      typedef itk::MeanImageFilter<ImageType, FloatImageType> MeanFilterType;
+      MeanFilterType::Pointer meanFilter = MeanFilterType::New();
+      MeanFilterType::InputSizeType itkRadius;
+      itkRadius[0] = radius.x;
+      itkRadius[1] = radius.y;
+      itkRadius[2] = radius.z;
+      meanFilter->SetRadius(itkRadius);
+      meanFilter->SetInput(image);
+
+      typedef itk::RescaleIntensityImageFilter<FloatImageType, ImageType> RescaleImageType;
+      RescaleImageType::Pointer rescaleFilter = RescaleImageType::New();
+      rescaleFilter->SetInput(meanFilter->GetOutput());
+      rescaleFilter->SetOutputMinimum(0);
+      rescaleFilter->SetOutputMaximum(255);
+      rescaleFilter->Update();
+      return rescaleFilter->GetOutput();
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void CompareWithItk(size_t xDim, size_t yDim, size_t zDim, const IntVec3_t& radius, bool printTimes)
+    {
+      DataContainerArray::Pointer dca = CreateVolume(xDim, yDim, zDim);
+      DataArrayPath inputPath("DataContainer", "CellData", "ImageData");
+      AttributeMatrix::Pointer attrMat = dca->getDataContainer("DataContainer")->getAttributeMatrix("CellData");
+      ArrayType::Pointer input = attrMat->getAttributeArrayAs<ArrayType>("ImageData");
+
+      IFilterFactory::Pointer filterFactory = FilterManager::Instance()->getFactoryFromClassName("ItkMeanKernel");
+      AbstractFilter::Pointer filter = filterFactory->create();
+      filter->setDataContainerArray(dca);
+
+      QVariant var;
+      var.setValue(inputPath);
+      bool propWasSet = filter->setProperty("SelectedCellArrayPath", var);
+      DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+      var.setValue(radius);
+      propWasSet = filter->setProperty("KernelSize", var);
+      DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+      propWasSet = filter->setProperty("SaveAsNewArray", true);
+      DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+      propWasSet = filter->setProperty("NewCellArrayName", "Mean");
+      DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      filter->execute();
+      std::chrono::duration<double> filterTime = std::chrono::steady_clock::now() - start;
+      DREAM3D_REQUIRED(filter->getErrorCondition(), >=, 0)
+
+      const size_t dims[3] = { xDim, yDim, zDim };
+      start = std::chrono::steady_clock::now();
+      ImageType::Pointer expected = RunItkMean(input, dims, radius);
+      std::chrono::duration<double> itkTime = std::chrono::steady_clock::now() - start;
+
+      ArrayType::Pointer output = attrMat->getAttributeArrayAs<ArrayType>("Mean");
+      DREAM3D_REQUIRE_VALID_POINTER(output.get())
+      const PixelType* expectedValues = expected->GetBufferPointer();
+      // ITK rounds the means to float before rescaling them, which can move a value across a rounding boundary
+      for(size_t i = 0; i < output->getNumberOfTuples(); i++)
+      {
+        const double difference = static_cast<double>(output->getValue(i)) - static_cast<double>(expectedValues[i]);
+        DREAM3D_REQUIRE(difference >= -1.0 && difference <= 1.0)
+      }
+
+      if(printTimes)
+      {
+        std::cout << "Mean of " << xDim << " x " << yDim << " x " << zDim << " voxels with radius " << radius.x << ", " << radius.y << ", " << radius.z << ": ItkMeanKernel "
+                  << filterTime.count() << " s, itk::MeanImageFilter and itk::RescaleIntensityImageFilter " << itkTime.count() << " s" << std::endl;
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    IntVec3_t Radius(int x, int y, int z)
+    {
+      IntVec3_t radius;
+      radius.x = x;
+      radius.y = y;
+      radius.z = z;
+      return radius;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    int TestMatchesItk()
+    {
+      // Anisotropic radii, a radius larger than the volume, a single slice and thin stacks that are split into bands
+      CompareWithItk(23, 17, 9, Radius(2, 1, 3), false);
+      CompareWithItk(7, 3, 2, Radius(4, 3, 2), false);
+      CompareWithItk(50, 20, 1, Radius(6, 0, 0), false);
+      CompareWithItk(40, 150, 5, Radius(3, 2, 1), false);
+      CompareWithItk(11, 200, 3, Radius(1, 70, 2), false);
+      return EXIT_SUCCESS;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    int BenchmarkAgainstItk()
+    {
+      CompareWithItk(256, 256, 64, Radius(1, 1, 1), true);
+      CompareWithItk(256, 256, 64, Radius(5, 5, 5), true);
+      return EXIT_SUCCESS;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      std::cout << "#### ItkMeanKernelTest Starting ####" << std::endl;
+
+      DREAM3D_REGISTER_TEST(TestFilterAvailability());
+      DREAM3D_REGISTER_TEST(TestMatchesItk());
+      DREAM3D_REGISTER_TEST(BenchmarkAgainstItk());
+    }
+
+  private:
+    ItkMeanKernelTest(const ItkMeanKernelTest&); // Copy Constructor Not Implemented
+    void operator=(const ItkMeanKernelTest&);      // Operator '=' Not Implemented
+};
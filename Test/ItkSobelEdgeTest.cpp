@@ -0,0 +1,260 @@
+/* ============================================================================
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the names of any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  This code was partially written under United States Air Force Contract number
+ *                              FA8650-10-D-5210
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <QtCore/QString>
+
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/FilterFactory.hpp"
+#include "SIMPLib/Filtering/FilterManager.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+#include "SIMPLib/SIMPLib.h"
+#include "UnitTestSupport.hpp"
+
+#include "itkImage.h"
+#include "itkRescaleIntensityImageFilter.h"
+#include "itkSobelEdgeDetectionImageFilter.h"
+
+#include "ImageProcessing/ImageProcessingConstants.h"
+
+/**
+ * @brief The ItkSobelEdgeTest class checks ItkSobelEdge on whole volumes and slice by slice against the
+ * itk::SobelEdgeDetectionImageFilter and itk::RescaleIntensityImageFilter pipeline it replaces and prints how long both
+ * take on a larger volume
+ */
+class ItkSobelEdgeTest
+{
+  public:
+    ItkSobelEdgeTest() = default;
+    virtual ~ItkSobelEdgeTest() = default;
+
+    typedef ImageProcessingConstants::DefaultPixelType PixelType;
+    typedef ImageProcessingConstants::DefaultArrayType ArrayType;
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    int TestFilterAvailability()
+    {
+      QString filtName = "ItkSobelEdge";
+      FilterManager* fm = FilterManager::Instance();
+      IFilterFactory::Pointer filterFactory = fm->getFactoryFromClassName(filtName);
+      if(nullptr == filterFactory.get())
+      {
+        std::stringstream ss;
+        ss << "The ItkSobelEdgeTest requires the " << filtName.toStdString() << " filter which was not found.";
+        DREAM3D_TEST_THROW_EXCEPTION(ss.str())
+      }
+      return EXIT_SUCCESS;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Creates a volume with smooth gradients and noise, so the gradients take many distinct values
+    // -----------------------------------------------------------------------------
+    DataContainerArray::Pointer CreateVolume(size_t xDim, size_t yDim, size_t zDim)
+    {
+      DataContainerArray::Pointer dca = DataContainerArray::New();
+      DataContainer::Pointer m = DataContainer::New("DataContainer");
+      ImageGeom::Pointer image = ImageGeom::CreateGeometry(SIMPL::Geometry::ImageGeometry);
+      image->setDimensions(xDim, yDim, zDim);
+      m->setGeometry(image);
+
+      QVector<size_t> tDims = { xDim, yDim, zDim };
+      AttributeMatrix::Pointer attrMat = AttributeMatrix::New(tDims, "CellData", AttributeMatrix::Type::Cell);
+      m->addAttributeMatrix("CellData", attrMat);
+
+      ArrayType::Pointer data = ArrayType::CreateArray(tDims, QVector<size_t>(1, 1), "ImageData");
+      uint32_t state = 12345;
+      for(size_t i = 0; i < data->getNumberOfTuples(); i++)
+      {
+        state = state * 1664525u + 1013904223u;
+        const size_t x = i % xDim;
+        const size_t y = (i / xDim) % yDim;
+        const size_t z = i / (xDim * yDim);
+        data->setValue(i, static_cast<PixelType>((x * 3 + y / 2 + z * 5 + (state >> 24) % 32) % 256));
+      }
+      attrMat->addAttributeArray("ImageData", data);
+      dca->addDataContainer(m);
+      return dca;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Runs the itk::SobelEdgeDetectionImageFilter and itk::RescaleIntensityImageFilter pipeline on a Dim dimensional
+    // copy of input and writes the result to output
+    // -----------------------------------------------------------------------------
+    template <unsigned int Dim>
+    void RunItkSobel(const PixelType* input, const size_t* dims, PixelType* output)
+    {
+      typedef itk::Image<PixelType, Dim> ImageType;
+      typedef itk::Image<float, Dim> FloatImageType;
+
+      typename ImageType::Pointer image = ImageType::New();
+      typename ImageType::SizeType size;
+      size_t count = 1;
+      for(unsigned int i = 0; i < Dim; i++)
+      {
+        size[i] = dims[i];
+        count *= dims[i];
+      }
+      typename ImageType::RegionType region;
+      region.SetSize(size);
+      image->SetRegions(region);
+      image->Allocate();
+      std::copy(input, input + count, image->GetBufferPointer());
+
+      typedef itk::SobelEdgeDetectionImageFilter<ImageType, FloatImageType> SobelFilterType;
+      typename SobelFilterType::Pointer sobelFilter = SobelFilterType::New();
+      sobelFilter->SetInput(image);
+
+      typedef itk::RescaleIntensityImageFilter<FloatImageType, ImageType> RescaleImageType;
+      typename RescaleImageType::Pointer rescaleFilter = RescaleImageType::New();
+      rescaleFilter->SetInput(sobelFilter->GetOutput());
+      rescaleFilter->SetOutputMinimum(0);
+      rescaleFilter->SetOutputMaximum(255);
+      rescaleFilter->Update();
+      std::copy(rescaleFilter->GetOutput()->GetBufferPointer(), rescaleFilter->GetOutput()->GetBufferPointer() + count, output);
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void CompareWithItk(size_t xDim, size_t yDim, size_t zDim, bool slice, bool printTimes)
+    {
+      DataContainerArray::Pointer dca = CreateVolume(xDim, yDim, zDim);
+      DataArrayPath inputPath("DataContainer", "CellData", "ImageData");
+      AttributeMatrix::Pointer attrMat = dca->getDataContainer("DataContainer")->getAttributeMatrix("CellData");
+      ArrayType::Pointer input = attrMat->getAttributeArrayAs<ArrayType>("ImageData");
+
+      IFilterFactory::Pointer filterFactory = FilterManager::Instance()->getFactoryFromClassName("ItkSobelEdge");
+      AbstractFilter::Pointer filter = filterFactory->create();
+      filter->setDataContainerArray(dca);
+
+      QVariant var;
+      var.setValue(inputPath);
+      bool propWasSet = filter->setProperty("SelectedCellArrayPath", var);
+      DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+      propWasSet = filter->setProperty("Slice", slice);
+      DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+      propWasSet = filter->setProperty("SaveAsNewArray", true);
+      DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+      propWasSet = filter->setProperty("NewCellArrayName", "Edges");
+      DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      filter->execute();
+      std::chrono::duration<double> filterTime = std::chrono::steady_clock::now() - start;
+      DREAM3D_REQUIRED(filter->getErrorCondition(), >=, 0)
+
+      const size_t dims[3] = { xDim, yDim, zDim };
+      std::vector<PixelType> expected(input->getNumberOfTuples());
+      start = std::chrono::steady_clock::now();
+      if(slice)
+      {
+        const size_t planeSize = xDim * yDim;
+        for(size_t z = 0; z < zDim; z++)
+        {
+          RunItkSobel<2>(input->getPointer(z * planeSize), dims, expected.data() + z * planeSize);
+        }
+      }
+      else
+      {
+        RunItkSobel<3>(input->getPointer(0), dims, expected.data());
+      }
+      std::chrono::duration<double> itkTime = std::chrono::steady_clock::now() - start;
+
+      ArrayType::Pointer output = attrMat->getAttributeArrayAs<ArrayType>("Edges");
+      DREAM3D_REQUIRE_VALID_POINTER(output.get())
+      // ITK convolves in float and rescales through a float image, which can move a value across a rounding boundary
+      for(size_t i = 0; i < output->getNumberOfTuples(); i++)
+      {
+        const double difference = static_cast<double>(output->getValue(i)) - static_cast<double>(expected[i]);
+        DREAM3D_REQUIRE(difference >= -1.0 && difference <= 1.0)
+      }
+
+      if(printTimes)
+      {
+        std::cout << "Sobel edges of " << xDim << " x " << yDim << " x " << zDim << " voxels" << (slice ? " by slice" : "") << ": ItkSobelEdge " << filterTime.count()
+                  << " s, itk::SobelEdgeDetectionImageFilter and itk::RescaleIntensityImageFilter " << itkTime.count() << " s" << std::endl;
+      }
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    int TestMatchesItk()
+    {
+      // Odd sizes, single rows and columns, a single slice and a thin stack whose rows are spread over the threads
+      CompareWithItk(23, 17, 9, false, false);
+      CompareWithItk(23, 17, 9, true, false);
+      CompareWithItk(1, 12, 5, false, false);
+      CompareWithItk(31, 1, 4, true, false);
+      CompareWithItk(50, 20, 1, false, false);
+      CompareWithItk(300, 200, 2, false, false);
+      return EXIT_SUCCESS;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    int BenchmarkAgainstItk()
+    {
+      CompareWithItk(256, 256, 64, false, true);
+      CompareWithItk(256, 256, 64, true, true);
+      return EXIT_SUCCESS;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      std::cout << "#### ItkSobelEdgeTest Starting ####" << std::endl;
+
+      DREAM3D_REGISTER_TEST(TestFilterAvailability());
+      DREAM3D_REGISTER_TEST(TestMatchesItk());
+      DREAM3D_REGISTER_TEST(BenchmarkAgainstItk());
+    }
+
+  private:
+    ItkSobelEdgeTest(const ItkSobelEdgeTest&); // Copy Constructor Not Implemented
+    void operator=(const ItkSobelEdgeTest&);     // Operator '=' Not Implemented
+};
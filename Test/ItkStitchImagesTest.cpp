@@ -0,0 +1,407 @@
+/* ============================================================================
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the names of any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  This code was partially written under United States Air Force Contract number
+ *                              FA8650-10-D-5210
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <QtCore/QString>
+
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/DataArrays/StringDataArray.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/FilterFactory.hpp"
+#include "SIMPLib/Filtering/FilterManager.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+#include "SIMPLib/SIMPLib.h"
+#include "UnitTestSupport.hpp"
+
+#include "itkImage.h"
+#include "itkPasteImageFilter.h"
+
+#include "ImageProcessing/ImageProcessingConstants.h"
+#include "ImageProcessing/ImageProcessingFilters/util/MosaicCompositor.h"
+
+/**
+ * @brief The ItkStitchImagesTest class checks that ItkStitchImages pastes the tiles like itk::PasteImageFilter when
+ * the tiles overwrite each other, and checks the overlap blending of the MosaicCompositor it assembles the mosaic with
+ * and that compositing the mosaic in bands does not change it.
+ */
+class ItkStitchImagesTest
+{
+  public:
+    ItkStitchImagesTest() = default;
+    virtual ~ItkStitchImagesTest() = default;
+
+    typedef ImageProcessingConstants::UInt8ImageType ImageType;
+    typedef itk::PasteImageFilter<ImageType, ImageType> PasteImageFilterType;
+
+    static const size_t k_NumTiles = 4;
+    static const size_t k_TileWidth = 40;
+    static const size_t k_TileHeight = 30;
+    static const size_t k_MosaicWidth = 77;
+    static const size_t k_MosaicHeight = 56;
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    int TestFilterAvailability()
+    {
+      QString filtName = "ItkStitchImages";
+      FilterManager* fm = FilterManager::Instance();
+      IFilterFactory::Pointer filterFactory = fm->getFactoryFromClassName(filtName);
+      if(nullptr == filterFactory.get())
+      {
+        std::stringstream ss;
+        ss << "The ItkStitchImagesTest requires the " << filtName.toStdString() << " filter which was not found.";
+        DREAM3D_TEST_THROW_EXCEPTION(ss.str())
+      }
+      return EXIT_SUCCESS;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Creates k_NumTiles noise tiles, or tiles that all have the same value if value is not negative
+    // -----------------------------------------------------------------------------
+    std::vector<std::vector<uint8_t>> CreateTiles(int value)
+    {
+      std::vector<std::vector<uint8_t>> tiles(k_NumTiles, std::vector<uint8_t>(k_TileWidth * k_TileHeight));
+      uint32_t state = 4711;
+      for(std::vector<uint8_t>& tile : tiles)
+      {
+        for(uint8_t& pixel : tile)
+        {
+          state = state * 1664525u + 1013904223u;
+          pixel = (value < 0) ? static_cast<uint8_t>(state >> 24) : static_cast<uint8_t>(value);
+        }
+      }
+      return tiles;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Holds the tiles in a data container the way ItkDetermineStitchingCoordinatesGeneric leaves them: one array per
+    // tile, the tile origins and the names of the tile arrays in the order of the origins
+    // -----------------------------------------------------------------------------
+    DataContainerArray::Pointer CreateTileDataContainer(const std::vector<std::vector<uint8_t>>& tiles, const std::vector<float>& origins)
+    {
+      DataContainerArray::Pointer dca = DataContainerArray::New();
+      DataContainer::Pointer m = DataContainer::New("Tiles");
+      ImageGeom::Pointer image = ImageGeom::CreateGeometry(SIMPL::Geometry::ImageGeometry);
+      image->setDimensions(k_TileWidth, k_TileHeight, 1);
+      m->setGeometry(image);
+
+      QVector<size_t> tDims = { k_TileWidth, k_TileHeight, 1 };
+      AttributeMatrix::Pointer tileData = AttributeMatrix::New(tDims, "TileData", AttributeMatrix::Type::Cell);
+      m->addAttributeMatrix("TileData", tileData);
+
+      QVector<size_t> infoDims(1, tiles.size());
+      AttributeMatrix::Pointer tileInfo = AttributeMatrix::New(infoDims, "TileInfo", AttributeMatrix::Type::Generic);
+      m->addAttributeMatrix("TileInfo", tileInfo);
+      FloatArrayType::Pointer coordinates = FloatArrayType::CreateArray(infoDims, QVector<size_t>(1, 2), "Coordinates");
+      StringDataArray::Pointer names = StringDataArray::CreateArray(tiles.size(), "Names");
+
+      for(size_t i = 0; i < tiles.size(); i++)
+      {
+        QString name = QString("Tile%1").arg(i);
+        UInt8ArrayType::Pointer data = UInt8ArrayType::CreateArray(tDims, QVector<size_t>(1, 1), name);
+        std::copy(tiles[i].begin(), tiles[i].end(), data->getPointer(0));
+        tileData->addAttributeArray(name, data);
+        names->setValue(i, name);
+        coordinates->setValue(2 * i, origins[2 * i]);
+        coordinates->setValue(2 * i + 1, origins[2 * i + 1]);
+      }
+      tileInfo->addAttributeArray("Coordinates", coordinates);
+      tileInfo->addAttributeArray("Names", names);
+      dca->addDataContainer(m);
+      return dca;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Pastes the tiles into a zeroed mosaic in order with itk::PasteImageFilter. The mosaic size and the paste positions
+    // are computed the way ItkStitchImages computed them when it pasted the tiles with ITK.
+    // -----------------------------------------------------------------------------
+    ImageType::Pointer PasteWithItk(const std::vector<std::vector<uint8_t>>& tiles, const std::vector<float>& origins)
+    {
+      float minx = 1000000.0f;
+      float maxx = 0.0f;
+      float miny = 1000000.0f;
+      float maxy = 0.0f;
+      for(size_t i = 0; i < tiles.size(); i++)
+      {
+        maxx = std::max(maxx, origins[2 * i]);
+        minx = std::min(minx, origins[2 * i]);
+        maxy = std::max(maxy, origins[2 * i + 1]);
+        miny = std::min(miny, origins[2 * i + 1]);
+      }
+
+      ImageType::RegionType region;
+      region.SetIndex(0, 0);
+      region.SetIndex(1, 0);
+      region.SetIndex(2, 0);
+      region.SetSize(0, k_TileWidth + abs(int(maxx)) + abs(int(minx)));
+      region.SetSize(1, k_TileHeight + abs(int(maxy)) + abs(int(miny)));
+      region.SetSize(2, 1);
+      ImageType::Pointer mosaic = ImageType::New();
+      mosaic->SetRegions(region);
+      mosaic->Allocate();
+      mosaic->FillBuffer(0);
+
+      ImageType::RegionType tileRegion;
+      tileRegion.SetIndex(0, 0);
+      tileRegion.SetIndex(1, 0);
+      tileRegion.SetIndex(2, 0);
+      tileRegion.SetSize(0, k_TileWidth);
+      tileRegion.SetSize(1, k_TileHeight);
+      tileRegion.SetSize(2, 1);
+
+      for(size_t i = 0; i < tiles.size(); i++)
+      {
+        ImageType::Pointer tile = ImageType::New();
+        tile->SetRegions(tileRegion);
+        tile->Allocate();
+        std::copy(tiles[i].begin(), tiles[i].end(), tile->GetBufferPointer());
+
+        ImageType::IndexType destinationIndex;
+        destinationIndex[0] = origins[2 * i] + abs(int(minx));
+        destinationIndex[1] = origins[2 * i + 1] + abs(int(miny));
+        destinationIndex[2] = 0;
+
+        PasteImageFilterType::Pointer pasteFilter = PasteImageFilterType::New();
+        pasteFilter->SetSourceImage(tile);
+        pasteFilter->SetDestinationImage(mosaic);
+        pasteFilter->SetSourceRegion(tile->GetLargestPossibleRegion());
+        pasteFilter->SetDestinationIndex(destinationIndex);
+        pasteFilter->Update();
+        mosaic = pasteFilter->GetOutput();
+        mosaic->DisconnectPipeline();
+      }
+      return mosaic;
+    }
+
+    // -----------------------------------------------------------------------------
+    // The origins overlap the tiles, are negative for some tiles and fractional, so they are truncated on the way
+    // -----------------------------------------------------------------------------
+    int TestOverwriteMatchesPaste()
+    {
+      std::vector<std::vector<uint8_t>> tiles = CreateTiles(-1);
+      std::vector<float> origins = { -2.5f, 0.0f, 33.7f, -1.2f, 1.0f, 25.9f, 35.2f, 24.0f };
+      DataContainerArray::Pointer dca = CreateTileDataContainer(tiles, origins);
+
+      IFilterFactory::Pointer filterFactory = FilterManager::Instance()->getFactoryFromClassName("ItkStitchImages");
+      AbstractFilter::Pointer filter = filterFactory->create();
+      filter->setDataContainerArray(dca);
+
+      QVariant var;
+      var.setValue(DataArrayPath("Tiles", "TileData", ""));
+      bool propWasSet = filter->setProperty("AttributeMatrixName", var);
+      DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+      var.setValue(DataArrayPath("Tiles", "TileInfo", "Coordinates"));
+      propWasSet = filter->setProperty("StitchedCoordinatesArrayPath", var);
+      DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+      var.setValue(DataArrayPath("Tiles", "TileInfo", "Names"));
+      propWasSet = filter->setProperty("AttributeArrayNamesPath", var);
+      DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+      propWasSet = filter->setProperty("BlendMode", MosaicCompositor::Overwrite);
+      DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+
+      filter->execute();
+      DREAM3D_REQUIRED(filter->getErrorCondition(), >=, 0)
+
+      ImageType::Pointer expected = PasteWithItk(tiles, origins);
+      const size_t expectedWidth = expected->GetLargestPossibleRegion().GetSize()[0];
+      const size_t expectedHeight = expected->GetLargestPossibleRegion().GetSize()[1];
+
+      AttributeMatrix::Pointer montageAttrMat = dca->getDataContainer("MontagedImageDataContainer")->getAttributeMatrix("MontageAttributeMatrix");
+      DREAM3D_REQUIRE_VALID_POINTER(montageAttrMat.get())
+      QVector<size_t> montageDims = montageAttrMat->getTupleDimensions();
+      DREAM3D_REQUIRE_EQUAL(montageDims[0], expectedWidth)
+      DREAM3D_REQUIRE_EQUAL(montageDims[1], expectedHeight)
+
+      UInt8ArrayType::Pointer montage = montageAttrMat->getAttributeArrayAs<UInt8ArrayType>("Montage");
+      DREAM3D_REQUIRE_VALID_POINTER(montage.get())
+      DREAM3D_REQUIRE_EQUAL(montage->getNumberOfTuples(), expectedWidth * expectedHeight)
+      const uint8_t* expectedValues = expected->GetBufferPointer();
+      for(size_t i = 0; i < montage->getNumberOfTuples(); i++)
+      {
+        DREAM3D_REQUIRE_EQUAL(montage->getValue(i), expectedValues[i])
+      }
+      return EXIT_SUCCESS;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Mosaic position of a tile given to the MosaicCompositor. The last tile hangs over the top and the right border.
+    // -----------------------------------------------------------------------------
+    void TilePosition(size_t i, int64_t& x, int64_t& y)
+    {
+      const int64_t tileX[k_NumTiles] = { 0, 34, 1, 45 };
+      const int64_t tileY[k_NumTiles] = { 0, 1, 26, -4 };
+      x = tileX[i];
+      y = tileY[i];
+    }
+
+    // -----------------------------------------------------------------------------
+    // Composites the tiles into a mosaic one band of rows at a time
+    // -----------------------------------------------------------------------------
+    std::vector<uint8_t> Composite(const std::vector<std::vector<uint8_t>>& tiles, int blendMode, size_t bandHeight)
+    {
+      MosaicCompositor::Pointer compositor = MosaicCompositor::New();
+      compositor->setTileDimensions(k_TileWidth, k_TileHeight);
+      compositor->setMosaicDimensions(k_MosaicWidth, k_MosaicHeight);
+      compositor->setBlendMode(blendMode);
+      for(size_t i = 0; i < tiles.size(); i++)
+      {
+        int64_t x = 0;
+        int64_t y = 0;
+        TilePosition(i, x, y);
+        compositor->addTile(tiles[i].data(), x, y);
+      }
+
+      std::vector<uint8_t> mosaic(k_MosaicWidth * k_MosaicHeight);
+      for(size_t rowStart = 0; rowStart < k_MosaicHeight; rowStart += bandHeight)
+      {
+        const size_t rowEnd = std::min(rowStart + bandHeight, k_MosaicHeight);
+        compositor->compositeBand(rowStart, rowEnd, mosaic.data() + rowStart * k_MosaicWidth);
+      }
+      return mosaic;
+    }
+
+    // -----------------------------------------------------------------------------
+    // Uncovered pixels are 0 in every mode. Overwrite and Feather keep the pixels only one tile covers and never leave
+    // the range of the tiles that cover a pixel. Blending tiles that are all the same has to give that same value.
+    // -----------------------------------------------------------------------------
+    int TestBlendModes()
+    {
+      std::vector<std::vector<uint8_t>> tiles = CreateTiles(-1);
+      std::vector<std::vector<uint8_t>> constantTiles = CreateTiles(120);
+
+      const int blendModes[3] = { MosaicCompositor::Overwrite, MosaicCompositor::Feather, MosaicCompositor::MultiBand };
+      for(int blendMode : blendModes)
+      {
+        std::vector<uint8_t> mosaic = Composite(tiles, blendMode, k_MosaicHeight);
+        std::vector<uint8_t> constantMosaic = Composite(constantTiles, blendMode, k_MosaicHeight);
+
+        for(size_t y = 0; y < k_MosaicHeight; y++)
+        {
+          for(size_t x = 0; x < k_MosaicWidth; x++)
+          {
+            size_t count = 0;
+            uint8_t lastValue = 0;
+            uint8_t minValue = 255;
+            uint8_t maxValue = 0;
+            for(size_t i = 0; i < tiles.size(); i++)
+            {
+              int64_t tileX = 0;
+              int64_t tileY = 0;
+              TilePosition(i, tileX, tileY);
+              const int64_t tx = static_cast<int64_t>(x) - tileX;
+              const int64_t ty = static_cast<int64_t>(y) - tileY;
+              if(tx >= 0 && tx < static_cast<int64_t>(k_TileWidth) && ty >= 0 && ty < static_cast<int64_t>(k_TileHeight))
+              {
+                lastValue = tiles[i][static_cast<size_t>(ty) * k_TileWidth + static_cast<size_t>(tx)];
+                minValue = std::min(minValue, lastValue);
+                maxValue = std::max(maxValue, lastValue);
+                count++;
+              }
+            }
+
+            const uint8_t value = mosaic[y * k_MosaicWidth + x];
+            if(count == 0)
+            {
+              DREAM3D_REQUIRE_EQUAL(value, 0)
+              DREAM3D_REQUIRE_EQUAL(constantMosaic[y * k_MosaicWidth + x], 0)
+              continue;
+            }
+            DREAM3D_REQUIRE_EQUAL(constantMosaic[y * k_MosaicWidth + x], 120)
+            if(blendMode == MosaicCompositor::MultiBand)
+            {
+              continue;
+            }
+            if(blendMode == MosaicCompositor::Overwrite || count == 1)
+            {
+              DREAM3D_REQUIRE_EQUAL(value, lastValue)
+            }
+            DREAM3D_REQUIRED(value, >=, minValue)
+            DREAM3D_REQUIRED(value, <=, maxValue)
+          }
+        }
+      }
+      return EXIT_SUCCESS;
+    }
+
+    // -----------------------------------------------------------------------------
+    // ItkStitchImages hands bands of rows to different threads, so compositing band by band has to give the mosaic
+    // that is composited in one go
+    // -----------------------------------------------------------------------------
+    int TestBandsMatchWholeMosaic()
+    {
+      std::vector<std::vector<uint8_t>> tiles = CreateTiles(-1);
+
+      const int blendModes[3] = { MosaicCompositor::Overwrite, MosaicCompositor::Feather, MosaicCompositor::MultiBand };
+      const size_t bandHeights[3] = { 1, 7, 16 };
+      for(int blendMode : blendModes)
+      {
+        std::vector<uint8_t> expected = Composite(tiles, blendMode, k_MosaicHeight);
+        for(size_t bandHeight : bandHeights)
+        {
+          std::vector<uint8_t> mosaic = Composite(tiles, blendMode, bandHeight);
+          for(size_t i = 0; i < expected.size(); i++)
+          {
+            DREAM3D_REQUIRE_EQUAL(mosaic[i], expected[i])
+          }
+        }
+      }
+      return EXIT_SUCCESS;
+    }
+
+    // -----------------------------------------------------------------------------
+    //
+    // -----------------------------------------------------------------------------
+    void operator()()
+    {
+      int err = EXIT_SUCCESS;
+      std::cout << "#### ItkStitchImagesTest Starting ####" << std::endl;
+
+      DREAM3D_REGISTER_TEST(TestFilterAvailability());
+      DREAM3D_REGISTER_TEST(TestOverwriteMatchesPaste());
+      DREAM3D_REGISTER_TEST(TestBlendModes());
+      DREAM3D_REGISTER_TEST(TestBandsMatchWholeMosaic());
+    }
+
+  private:
+    ItkStitchImagesTest(const ItkStitchImagesTest&); // Copy Constructor Not Implemented
+    void operator=(const ItkStitchImagesTest&);      // Operator '=' Not Implemented
+};